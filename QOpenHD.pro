@@ -45,67 +45,29 @@ QT_FOR_CONFIG += location-private
 qtConfig(geoservices_mapboxgl): QT += sql opengl
 qtConfig(geoservices_osm): QT += concurrent
 
-INCLUDEPATH += $$PWD/inc
-INCLUDEPATH += $$PWD/lib
-INCLUDEPATH += $$PWD/lib/mavlink_generated/include/mavlink/v2.0
-
-INCLUDEPATH += $$PWD/lib/GeographicLib-1.50/include
+include(qopenhd-core.pri)
 
 
 SOURCES += \
     src/FPS.cpp \
-    src/frskytelemetry.cpp \
-    src/gpiomicroservice.cpp \
-    src/localmessage.cpp \
-    src/ltmtelemetry.cpp \
+    src/headingtape.cpp \
+    src/laddertape.cpp \
     src/main.cpp \
-    src/mavlinkbase.cpp \
-    src/mavlinktelemetry.cpp \
-    src/migration.cpp \
-    src/msptelemetry.cpp \
-    src/openhd.cpp \
     src/openhdpi.cpp \
-    src/openhdrc.cpp \
-    src/openhdsettings.cpp \
-    src/openhdtelemetry.cpp \
     src/opensky.cpp \
-    src/powermicroservice.cpp \
-    src/qopenhdlink.cpp \
-    src/smartporttelemetry.cpp \
-    src/statuslogmodel.cpp \
-    src/statusmicroservice.cpp \
-    src/util.cpp \
-    src/vectortelemetry.cpp
+    src/osdinstrument.cpp \
+    src/vsigauge.cpp
 
 RESOURCES += qml/qml.qrc
 
 HEADERS += \
     inc/FPS.h \
-    inc/gpiomicroservice.h \
-    inc/mavlinkbase.h \
-    inc/opensky.h \
-    inc/powermicroservice.h \
-    inc/sharedqueue.h \
-    inc/constants.h \
-    inc/frskytelemetry.h \
-    inc/localmessage.h \
-    inc/localmessage_t.h \
-    inc/ltmtelemetry.h \
-    inc/mavlinktelemetry.h \
-    inc/migration.hpp \
-    inc/msptelemetry.h \
-    inc/openhd.h \
+    inc/headingtape.h \
+    inc/laddertape.h \
     inc/openhdpi.h \
-    inc/openhdrc.h \
-    inc/openhdsettings.h \
-    inc/openhdtelemetry.h \
-    inc/qopenhdlink.h \
-    inc/smartporttelemetry.h \
-    inc/statuslogmodel.h \
-    inc/statusmicroservice.h \
-    inc/util.h \
-    inc/vectortelemetry.h \
-    inc/wifibroadcast.h
+    inc/opensky.h \
+    inc/osdinstrument.h \
+    inc/vsigauge.h
 
 DISTFILES += \
     android/AndroidManifest.xml \
@@ -130,48 +92,6 @@ DISTFILES += \
     qml/ui/qmldir
 
 
-
-SOURCES += \
-    lib/GeographicLib-1.50/src/Accumulator.cpp \
-    lib/GeographicLib-1.50/src/AlbersEqualArea.cpp \
-    lib/GeographicLib-1.50/src/AzimuthalEquidistant.cpp \
-    lib/GeographicLib-1.50/src/CassiniSoldner.cpp \
-    lib/GeographicLib-1.50/src/CircularEngine.cpp \
-    lib/GeographicLib-1.50/src/DMS.cpp \
-    lib/GeographicLib-1.50/src/Ellipsoid.cpp \
-    lib/GeographicLib-1.50/src/EllipticFunction.cpp \
-    lib/GeographicLib-1.50/src/GARS.cpp \
-    lib/GeographicLib-1.50/src/GeoCoords.cpp \
-    lib/GeographicLib-1.50/src/Geocentric.cpp \
-    lib/GeographicLib-1.50/src/Geodesic.cpp \
-    lib/GeographicLib-1.50/src/GeodesicExact.cpp \
-    lib/GeographicLib-1.50/src/GeodesicExactC4.cpp \
-    lib/GeographicLib-1.50/src/GeodesicLine.cpp \
-    lib/GeographicLib-1.50/src/GeodesicLineExact.cpp \
-    lib/GeographicLib-1.50/src/Geohash.cpp \
-    lib/GeographicLib-1.50/src/Geoid.cpp \
-    lib/GeographicLib-1.50/src/Georef.cpp \
-    lib/GeographicLib-1.50/src/Gnomonic.cpp \
-    lib/GeographicLib-1.50/src/GravityCircle.cpp \
-    lib/GeographicLib-1.50/src/GravityModel.cpp \
-    lib/GeographicLib-1.50/src/LambertConformalConic.cpp \
-    lib/GeographicLib-1.50/src/LocalCartesian.cpp \
-    lib/GeographicLib-1.50/src/MGRS.cpp \
-    lib/GeographicLib-1.50/src/MagneticCircle.cpp \
-    lib/GeographicLib-1.50/src/MagneticModel.cpp \
-    lib/GeographicLib-1.50/src/Math.cpp \
-    lib/GeographicLib-1.50/src/NormalGravity.cpp \
-    lib/GeographicLib-1.50/src/OSGB.cpp \
-    lib/GeographicLib-1.50/src/PolarStereographic.cpp \
-    lib/GeographicLib-1.50/src/PolygonArea.cpp \
-    lib/GeographicLib-1.50/src/Rhumb.cpp \
-    lib/GeographicLib-1.50/src/SphericalEngine.cpp \
-    lib/GeographicLib-1.50/src/TransverseMercator.cpp \
-    lib/GeographicLib-1.50/src/TransverseMercatorExact.cpp \
-    lib/GeographicLib-1.50/src/UTMUPS.cpp \
-    lib/GeographicLib-1.50/src/Utility.cpp
-
-
 iOSBuild {
     QMAKE_INFO_PLIST    = ios/Info.plist
     ICON                = $${BASEDIR}/icons/macos.icns
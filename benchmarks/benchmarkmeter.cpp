@@ -0,0 +1,88 @@
+#include "benchmarkmeter.h"
+
+#include <QtTest>
+
+#include <atomic>
+#include <stdlib.h>
+
+
+#if defined(__GLIBC__)
+
+static std::atomic<int64_t> allocations(0);
+
+extern "C" {
+void* __libc_malloc(size_t size);
+void* __libc_calloc(size_t count, size_t size);
+void* __libc_realloc(void* pointer, size_t size);
+
+void* malloc(size_t size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    return __libc_malloc(size);
+}
+
+void* calloc(size_t count, size_t size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    return __libc_calloc(count, size);
+}
+
+void* realloc(void* pointer, size_t size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    return __libc_realloc(pointer, size);
+}
+}
+
+int64_t benchmarkAllocations() {
+    return allocations.load(std::memory_order_relaxed);
+}
+
+#else
+
+int64_t benchmarkAllocations() {
+    return -1;
+}
+
+#endif
+
+
+BenchmarkMeter::BenchmarkMeter(qint64 bytes_per_iteration): m_bytes_per_iteration(bytes_per_iteration) {}
+
+
+void BenchmarkMeter::begin() {
+    m_allocations_start = benchmarkAllocations();
+    m_timer.start();
+}
+
+
+void BenchmarkMeter::end() {
+    m_ns += m_timer.nsecsElapsed();
+    m_allocations += benchmarkAllocations() - m_allocations_start;
+    m_iterations++;
+}
+
+
+double BenchmarkMeter::nsPerByte() const {
+    if (m_iterations == 0 || m_bytes_per_iteration == 0) {
+        return 0;
+    }
+    return (double)m_ns / m_iterations / m_bytes_per_iteration;
+}
+
+
+void BenchmarkMeter::report() const {
+    if (m_iterations == 0 || m_bytes_per_iteration == 0) {
+        return;
+    }
+
+    auto ns_per_byte = nsPerByte();
+    QString allocations = "not counted";
+    if (benchmarkAllocations() >= 0) {
+        allocations = QString::number((double)m_allocations / m_iterations, 'f', 1);
+    }
+
+    qInfo("%s %s: %.3f ns/byte, %s allocations/iteration (%lld bytes/iteration)",
+          QTest::currentTestFunction(),
+          QTest::currentDataTag() ? QTest::currentDataTag() : "",
+          ns_per_byte,
+          qPrintable(allocations),
+          m_bytes_per_iteration);
+}
@@ -0,0 +1,44 @@
+#ifndef BENCHMARKMETER_H
+#define BENCHMARKMETER_H
+
+#include <QElapsedTimer>
+
+#include <stdint.h>
+
+
+/*
+ * Heap allocations made by the whole process so far, or -1 when they can't be counted. Only
+ * glibc builds count them, by wrapping malloc, calloc and realloc, which also catches operator
+ * new and the Qt containers.
+ */
+int64_t benchmarkAllocations();
+
+
+/*
+ * QBENCHMARK only reports time per iteration, this adds the numbers the parsers are compared
+ * by: nanoseconds per input byte and heap allocations per iteration. Wrap the measured code in
+ * begin() and end() inside the QBENCHMARK block and call report() after it.
+ */
+class BenchmarkMeter {
+public:
+    explicit BenchmarkMeter(qint64 bytes_per_iteration);
+
+    void begin();
+    void end();
+
+    void report() const;
+
+    double nsPerByte() const;
+
+private:
+    qint64 m_bytes_per_iteration;
+
+    QElapsedTimer m_timer;
+    int64_t m_allocations_start = 0;
+
+    qint64 m_iterations = 0;
+    qint64 m_ns = 0;
+    int64_t m_allocations = 0;
+};
+
+#endif // BENCHMARKMETER_H
@@ -0,0 +1,13 @@
+#ifndef BENCHMARKS_H
+#define BENCHMARKS_H
+
+/*
+ * Each benchmark class lives in its own file and is run through one of these, so a single
+ * executable covers every parser. They take the usual QTest arguments.
+ */
+int runFramingBenchmark(int argc, char *argv[]);
+int runLoggingBenchmark(int argc, char *argv[]);
+int runMavlinkBenchmark(int argc, char *argv[]);
+int runVideoBenchmark(int argc, char *argv[]);
+
+#endif // BENCHMARKS_H
@@ -0,0 +1,56 @@
+# Microbenchmarks for the ingest parsers and the logger, run with
+#
+#   qmake benchmarks/benchmarks.pro && make && ./qopenhd_benchmarks
+#
+# Every row also prints ns/byte and heap allocations per iteration, the logging rows count a
+# log call as a byte. Set QOPENHD_BENCHMARK_RECORDING to a FlightRecorder segment to run the
+# MAVLink parser over recorded traffic as well as the synthetic stream.
+
+TEMPLATE = app
+TARGET = qopenhd_benchmarks
+
+QT += testlib network concurrent multimedia
+CONFIG += console c++17 testcase
+CONFIG -= app_bundle
+
+DEFINES += ENABLE_VIDEO_RENDER
+
+INCLUDEPATH += $$PWD/../inc
+INCLUDEPATH += $$PWD/../lib
+INCLUDEPATH += $$PWD/../lib/mavlink_generated/include/mavlink/v2.0
+INCLUDEPATH += $$PWD/../lib/h264
+
+SOURCES += \
+    benchmarkmeter.cpp \
+    benchmarkstubs.cpp \
+    framingbenchmark.cpp \
+    loggingbenchmark.cpp \
+    main.cpp \
+    mavlinkbenchmark.cpp \
+    videobenchmark.cpp \
+    $$PWD/../src/flightrecorder.cpp \
+    $$PWD/../src/logger.cpp \
+    $$PWD/../src/mavlinkbase.cpp \
+    $$PWD/../src/mavlinkrouter.cpp \
+    $$PWD/../src/mspprotocol.cpp \
+    $$PWD/../src/openhdvideo.cpp \
+    $$PWD/../src/telemetryframing.cpp \
+    $$PWD/../src/util.cpp \
+    $$PWD/../lib/h264/bit_buffer.cc \
+    $$PWD/../lib/h264/checks.cc \
+    $$PWD/../lib/h264/h264_common.cc \
+    $$PWD/../lib/h264/pps_parser.cc \
+    $$PWD/../lib/h264/sps_parser.cc \
+    $$PWD/../lib/h264/zero_memory.cc
+
+HEADERS += \
+    benchmarkmeter.h \
+    benchmarks.h \
+    $$PWD/../inc/flightrecorder.h \
+    $$PWD/../inc/logger.h \
+    $$PWD/../inc/mavlinkbase.h \
+    $$PWD/../inc/mavlinkrouter.h \
+    $$PWD/../inc/mspprotocol.h \
+    $$PWD/../inc/openhdvideo.h \
+    $$PWD/../inc/telemetryframing.h \
+    $$PWD/../inc/util.h
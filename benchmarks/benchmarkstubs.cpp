@@ -0,0 +1,19 @@
+#include "openhd.h"
+
+
+/*
+ * OpenHDVideo only reaches OpenHD from its stall timer and start/stop paths, which the
+ * benchmarks never run. Linking openhd.cpp instead would drag in the whole telemetry stack.
+ */
+OpenHD* OpenHD::instance() {
+    qFatal("OpenHD isn't available in the benchmarks");
+    return nullptr;
+}
+
+void OpenHD::set_main_video_running(bool main_video_running) {
+    Q_UNUSED(main_video_running);
+}
+
+void OpenHD::set_pip_video_running(bool pip_video_running) {
+    Q_UNUSED(pip_video_running);
+}
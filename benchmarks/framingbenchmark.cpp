@@ -0,0 +1,265 @@
+#include <QtTest>
+
+#include "benchmarks.h"
+#include "benchmarkmeter.h"
+
+#include "mspprotocol.h"
+#include "telemetryframing.h"
+
+
+static const FrameProtocol* Protocols[] = {
+    &LTMFrameProtocol,
+    &VectorFrameProtocol,
+    &FrSkyFrameProtocol,
+    &SmartPortFrameProtocol
+};
+
+static const int StreamSize = 1024 * 1024;
+
+
+static void appendEscaped(QByteArray &stream, const FrameProtocol &protocol, uint8_t byte) {
+    if (protocol.escaped && (byte == protocol.escape || (protocol.delimited && byte == protocol.delimiter))) {
+        stream.append((char)protocol.escape);
+        byte ^= protocol.escape_xor;
+    }
+    stream.append((char)byte);
+}
+
+
+/*
+ * About 1MiB of valid frames with random payloads, cycling through the frame types. With
+ * corrupt_every set, one byte in every that many frames is flipped.
+ */
+static QByteArray syntheticStream(const FrameProtocol &protocol, int corrupt_every) {
+    QRandomGenerator generator(1);
+    QByteArray stream;
+    stream.reserve(StreamSize + TelemetryFramer::MaxFrameSize * 2);
+
+    uint8_t frame[TelemetryFramer::MaxFrameSize];
+    int count = 0;
+
+    while (stream.size() < StreamSize) {
+        memcpy(frame, protocol.sync, protocol.sync_length);
+        int length = protocol.sync_length;
+        int payload_length = protocol.fixed_length;
+
+        if (protocol.typed) {
+            uint8_t type;
+            if (protocol.types != nullptr) {
+                type = protocol.types[count % protocol.type_count].id;
+                payload_length = protocol.types[count % protocol.type_count].length;
+            } else {
+                type = generator.bounded(0x40);
+            }
+            frame[length++] = type;
+        }
+
+        int payload_offset = length;
+        for (int i = 0; i < payload_length; i++) {
+            frame[length++] = generator.bounded(256);
+        }
+
+        uint16_t checksum = frameChecksum(protocol, frame, length, payload_offset);
+        for (int i = 0; i < frameChecksumLength(protocol.checksum); i++) {
+            frame[length++] = (checksum >> (8 * i)) & 0xff;
+        }
+
+        int start = stream.size();
+        stream.append((const char*)frame, protocol.sync_length);
+        for (int i = protocol.sync_length; i < length; i++) {
+            appendEscaped(stream, protocol, frame[i]);
+        }
+
+        count++;
+        if (corrupt_every != 0 && count % corrupt_every == 0) {
+            int position = start + generator.bounded(stream.size() - start);
+            stream[position] = stream[position] ^ 0xff;
+        }
+    }
+    return stream;
+}
+
+
+static uint8_t crc8DVBS2(uint8_t crc, uint8_t byte) {
+    crc ^= byte;
+    for (int i = 0; i < 8; i++) {
+        crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ 0xD5) : (uint8_t)(crc << 1);
+    }
+    return crc;
+}
+
+
+/*
+ * About 1MiB of the MSP responses MSPTelemetry polls for, alternating between v1 and v2
+ * framing, with random payloads of the length each command has on current firmware.
+ */
+static QByteArray syntheticMSPStream(int corrupt_every) {
+    static const struct {
+        uint16_t command;
+        int length;
+    } responses[] = {
+        { MSPCommandStatus, 11 },
+        { MSPCommandRawGPS, 18 },
+        { MSPCommandAttitude, 6 },
+        { MSPCommandAltitude, 6 },
+        { MSPCommandAnalog, 9 }
+    };
+    const int response_count = sizeof(responses) / sizeof(responses[0]);
+
+    QRandomGenerator generator(1);
+    QByteArray stream;
+    stream.reserve(StreamSize + MSPParser::MaxPayload * 2);
+
+    int count = 0;
+
+    while (stream.size() < StreamSize) {
+        auto &response = responses[count % response_count];
+        int start = stream.size();
+
+        uint8_t payload[MSPParser::MaxPayload];
+        for (int i = 0; i < response.length; i++) {
+            payload[i] = generator.bounded(256);
+        }
+
+        if (count % 2 == 0) {
+            uint8_t header[] = { '$', 'M', '>', (uint8_t)response.length, (uint8_t)response.command };
+            uint8_t checksum = header[3] ^ header[4];
+            for (int i = 0; i < response.length; i++) {
+                checksum ^= payload[i];
+            }
+            stream.append((const char*)header, sizeof(header));
+            stream.append((const char*)payload, response.length);
+            stream.append((char)checksum);
+        } else {
+            uint8_t header[] = { '$', 'X', '>', 0,
+                                 (uint8_t)(response.command & 0xff), (uint8_t)(response.command >> 8),
+                                 (uint8_t)(response.length & 0xff), (uint8_t)(response.length >> 8) };
+            uint8_t crc = 0;
+            for (int i = 3; i < (int)sizeof(header); i++) {
+                crc = crc8DVBS2(crc, header[i]);
+            }
+            for (int i = 0; i < response.length; i++) {
+                crc = crc8DVBS2(crc, payload[i]);
+            }
+            stream.append((const char*)header, sizeof(header));
+            stream.append((const char*)payload, response.length);
+            stream.append((char)crc);
+        }
+
+        count++;
+        if (corrupt_every != 0 && count % corrupt_every == 0) {
+            int position = start + generator.bounded(stream.size() - start);
+            stream[position] = stream[position] ^ 0xff;
+        }
+    }
+    return stream;
+}
+
+
+/*
+ * Throughput of the serial telemetry framers and the MSP parser. Each iteration parses about
+ * 1MiB and reads every payload through.
+ */
+class FramingBenchmark: public QObject {
+    Q_OBJECT
+
+private slots:
+    void framing_data();
+    void framing();
+
+    void msp_data();
+    void msp();
+};
+
+
+void FramingBenchmark::framing_data() {
+    QTest::addColumn<int>("protocol");
+    QTest::addColumn<QByteArray>("stream");
+
+    for (int i = 0; i < int(sizeof(Protocols) / sizeof(Protocols[0])); i++) {
+        auto protocol = Protocols[i];
+        QTest::newRow(QString("%1 clean").arg(protocol->name).toUtf8().constData())
+            << i << syntheticStream(*protocol, 0);
+        QTest::newRow(QString("%1 1% corrupted").arg(protocol->name).toUtf8().constData())
+            << i << syntheticStream(*protocol, 100);
+    }
+}
+
+
+void FramingBenchmark::framing() {
+    QFETCH(int, protocol);
+    QFETCH(QByteArray, stream);
+
+    auto data = (const uint8_t*)stream.constData();
+    int size = stream.size();
+    uint64_t frames = 0;
+    uint32_t sink = 0;
+
+    BenchmarkMeter meter(size);
+
+    QBENCHMARK {
+        meter.begin();
+        TelemetryFramer framer(*Protocols[protocol]);
+        for (int i = 0; i < size; i++) {
+            if (framer.push(data[i])) {
+                auto payload = framer.payload();
+                while (payload.remaining() > 0) {
+                    sink += payload.u8();
+                }
+            }
+        }
+        frames = framer.stats().frames;
+        meter.end();
+    }
+
+    meter.report();
+    QVERIFY(frames > 0);
+    Q_UNUSED(sink);
+}
+
+
+void FramingBenchmark::msp_data() {
+    QTest::addColumn<QByteArray>("stream");
+
+    QTest::newRow("MSP clean") << syntheticMSPStream(0);
+    QTest::newRow("MSP 1% corrupted") << syntheticMSPStream(100);
+}
+
+
+void FramingBenchmark::msp() {
+    QFETCH(QByteArray, stream);
+
+    auto data = (const uint8_t*)stream.constData();
+    int size = stream.size();
+    uint64_t frames = 0;
+    uint32_t sink = 0;
+
+    BenchmarkMeter meter(size);
+
+    QBENCHMARK {
+        meter.begin();
+        MSPParser parser;
+        for (int i = 0; i < size; i++) {
+            if (parser.push(data[i])) {
+                auto payload = parser.payload();
+                while (payload.remaining() > 0) {
+                    sink += payload.u8();
+                }
+            }
+        }
+        frames = parser.stats().frames;
+        meter.end();
+    }
+
+    meter.report();
+    QVERIFY(frames > 0);
+    Q_UNUSED(sink);
+}
+
+
+int runFramingBenchmark(int argc, char *argv[]) {
+    FramingBenchmark benchmark;
+    return QTest::qExec(&benchmark, argc, argv);
+}
+
+#include "framingbenchmark.moc"
@@ -0,0 +1,154 @@
+#include <QtTest>
+
+#include <atomic>
+
+#include "benchmarks.h"
+#include "benchmarkmeter.h"
+
+#include "logger.h"
+
+
+// stays under the point where a producer wakes the flusher early, so every call is a plain enqueue
+static const int CallsPerIteration = 128;
+
+
+/*
+ * While measuring, whatever the flusher writes out is thrown away instead of going to the
+ * QTest log, the meter's own report still gets through.
+ */
+static QtMessageHandler s_test_handler = nullptr;
+static std::atomic<bool> s_discard { false };
+
+static void benchmarkMessageHandler(QtMsgType type, const QMessageLogContext &context, const QString &message) {
+    if (!s_discard.load() && s_test_handler != nullptr) {
+        s_test_handler(type, context, message);
+    }
+}
+
+
+/*
+ * What a log call costs the thread making it, reported for comparison with
+ * Logger::LogCallBudgetNs rather than held to it, timings vary too much between machines for
+ * a pass or fail. The flusher's side isn't measured, it's off the hot path by design.
+ */
+class LoggingBenchmark: public QObject {
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void text();
+    void rateLimited();
+    void event();
+    void qtMessage();
+
+private:
+    void begin(BenchmarkMeter &meter);
+    void end(BenchmarkMeter &meter);
+};
+
+
+void LoggingBenchmark::initTestCase() {
+    s_test_handler = qInstallMessageHandler(benchmarkMessageHandler);
+    Logger::instance()->install();
+}
+
+
+void LoggingBenchmark::cleanupTestCase() {
+    Logger::instance()->stop();
+    qInstallMessageHandler(s_test_handler);
+}
+
+
+void LoggingBenchmark::begin(BenchmarkMeter &meter) {
+    s_discard.store(true);
+    meter.begin();
+}
+
+
+// the ring is emptied after every iteration so the next one doesn't measure the drop path
+void LoggingBenchmark::end(BenchmarkMeter &meter) {
+    meter.end();
+    Logger::instance()->flush();
+    s_discard.store(false);
+}
+
+
+void LoggingBenchmark::text() {
+    BenchmarkMeter meter(CallsPerIteration);
+    auto dropped = Logger::instance()->dropped();
+
+    QBENCHMARK {
+        begin(meter);
+        for (int i = 0; i < CallsPerIteration; i++) {
+            Logger::instance()->text(QtDebugMsg, 0, "RC RSSI: %d", i);
+        }
+        end(meter);
+    }
+
+    meter.report();
+    Logger::instance()->flush();
+    QCOMPARE(Logger::instance()->dropped(), dropped);
+}
+
+
+void LoggingBenchmark::rateLimited() {
+    BenchmarkMeter meter(CallsPerIteration);
+
+    QBENCHMARK {
+        begin(meter);
+        for (int i = 0; i < CallsPerIteration; i++) {
+            LOG_RATE_LIMITED(1000, QtDebugMsg, "received unmatched message with ID %d", i);
+        }
+        end(meter);
+    }
+
+    meter.report();
+    Logger::instance()->flush();
+}
+
+
+// without log_events there's no events file, this measures an event that's only counted
+void LoggingBenchmark::event() {
+    BenchmarkMeter meter(CallsPerIteration);
+
+    QBENCHMARK {
+        begin(meter);
+        for (int i = 0; i < CallsPerIteration; i++) {
+            LOG_EVENT(LogEventUnmatchedMavlink, i, 1 << 8 | 1);
+        }
+        end(meter);
+    }
+
+    meter.report();
+    Logger::instance()->flush();
+}
+
+
+/*
+ * qDebug() through the message handler. Most of this is QDebug building the QString, so it
+ * says more about Qt than about the logger.
+ */
+void LoggingBenchmark::qtMessage() {
+    BenchmarkMeter meter(CallsPerIteration);
+
+    QBENCHMARK {
+        begin(meter);
+        for (int i = 0; i < CallsPerIteration; i++) {
+            qDebug() << "RC RSSI: " << i;
+        }
+        end(meter);
+    }
+
+    meter.report();
+    Logger::instance()->flush();
+}
+
+
+int runLoggingBenchmark(int argc, char *argv[]) {
+    LoggingBenchmark benchmark;
+    return QTest::qExec(&benchmark, argc, argv);
+}
+
+#include "loggingbenchmark.moc"
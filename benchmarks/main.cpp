@@ -0,0 +1,19 @@
+#include <QCoreApplication>
+
+#include "benchmarks.h"
+
+
+int main(int argc, char *argv[]) {
+    QCoreApplication::setOrganizationName("Open.HD");
+    QCoreApplication::setOrganizationDomain("open.hd");
+    QCoreApplication::setApplicationName("QOpenHD Benchmarks");
+
+    QCoreApplication app(argc, argv);
+
+    int status = 0;
+    status |= runFramingBenchmark(argc, argv);
+    status |= runLoggingBenchmark(argc, argv);
+    status |= runMavlinkBenchmark(argc, argv);
+    status |= runVideoBenchmark(argc, argv);
+    return status;
+}
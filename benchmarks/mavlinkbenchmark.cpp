@@ -0,0 +1,186 @@
+#include <QtTest>
+
+#include "benchmarks.h"
+#include "benchmarkmeter.h"
+
+#include <openhd/mavlink.h>
+
+#include "flightrecorder.h"
+#include "mavlinkbase.h"
+
+
+/*
+ * MavlinkBase with the parser exposed, talking to the same system and components
+ * MavlinkTelemetry does. Every message that makes it through is delivered over the
+ * processMavlinkMessage signal, the same as in the app.
+ */
+class BenchmarkMavlink: public MavlinkBase {
+public:
+    BenchmarkMavlink() {
+        targetSysID = 1;
+        targetCompID1 = MAV_COMP_ID_AUTOPILOT1;
+        targetCompID2 = MAV_COMP_ID_SYSTEM_CONTROL;
+    }
+
+    using MavlinkBase::processData;
+};
+
+
+static const int StreamSize = 1024 * 1024;
+
+
+/*
+ * About 1MiB of the messages a flight controller streams by default, one per datagram, with
+ * random values.
+ */
+static QVector<QByteArray> syntheticDatagrams() {
+    QRandomGenerator generator(1);
+    QVector<QByteArray> datagrams;
+
+    int total = 0;
+    int count = 0;
+
+    while (total < StreamSize) {
+        mavlink_message_t msg;
+        auto r = [&generator]() { return generator.bounded(1000); };
+
+        switch (count % 7) {
+            case 0:
+                mavlink_msg_heartbeat_pack(1, MAV_COMP_ID_AUTOPILOT1, &msg, MAV_TYPE_QUADROTOR, MAV_AUTOPILOT_ARDUPILOTMEGA, MAV_MODE_FLAG_SAFETY_ARMED, r(), MAV_STATE_ACTIVE);
+                break;
+            case 1:
+                mavlink_msg_attitude_pack(1, MAV_COMP_ID_AUTOPILOT1, &msg, count, r() / 1000.0f, r() / 1000.0f, r() / 1000.0f, r(), r(), r());
+                break;
+            case 2:
+                mavlink_msg_global_position_int_pack(1, MAV_COMP_ID_AUTOPILOT1, &msg, count, r() * 10000, r() * 10000, r() * 1000, r() * 1000, r(), r(), r(), r() * 36);
+                break;
+            case 3:
+                mavlink_msg_sys_status_pack(1, MAV_COMP_ID_AUTOPILOT1, &msg, 0, 0, 0, r(), r() * 16, r(), r() / 10, r(), r(), r(), r(), r(), r());
+                break;
+            case 4:
+                mavlink_msg_vfr_hud_pack(1, MAV_COMP_ID_AUTOPILOT1, &msg, r() / 10.0f, r() / 10.0f, r() % 360, r() / 10, r() / 10.0f, r() / 100.0f);
+                break;
+            case 5:
+                mavlink_msg_gps_raw_int_pack(1, MAV_COMP_ID_AUTOPILOT1, &msg, count, GPS_FIX_TYPE_3D_FIX, r() * 10000, r() * 10000, r() * 1000, r(), r(), r(), r() * 36, 12, r() * 1000, r(), r(), r(), r(), r());
+                break;
+            default:
+                mavlink_msg_rc_channels_pack(1, MAV_COMP_ID_AUTOPILOT1, &msg, count, 16,
+                                             1000 + r(), 1000 + r(), 1000 + r(), 1000 + r(), 1000 + r(), 1000 + r(),
+                                             1000 + r(), 1000 + r(), 1000 + r(), 1000 + r(), 1000 + r(), 1000 + r(),
+                                             1000 + r(), 1000 + r(), 1000 + r(), 1000 + r(), 1000 + r(), 1000 + r(), 200);
+                break;
+        }
+
+        uint8_t buffer[MAVLINK_MAX_PACKET_LEN];
+        auto length = mavlink_msg_to_send_buffer(buffer, &msg);
+        datagrams.append(QByteArray((const char*)buffer, length));
+        total += length;
+        count++;
+    }
+    return datagrams;
+}
+
+
+/*
+ * The MAVLink datagrams from a FlightRecorder segment, so real traffic can be compared with
+ * the synthetic stream.
+ */
+static QVector<QByteArray> recordedDatagrams(QString path) {
+    QVector<QByteArray> datagrams;
+
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return datagrams;
+    }
+    auto data = file.readAll();
+
+    flight_record_segment_header_t header;
+    if (data.size() < (int)sizeof(header)) {
+        return datagrams;
+    }
+    memcpy(&header, data.constData(), sizeof(header));
+    if (memcmp(header.magic, FLIGHT_RECORD_MAGIC, sizeof(FLIGHT_RECORD_MAGIC)) != 0 || header.version != FLIGHT_RECORD_VERSION) {
+        return datagrams;
+    }
+
+    qint64 offset = header.header_size;
+    while (offset + (qint64)sizeof(flight_record_header_t) <= data.size()) {
+        flight_record_header_t record;
+        memcpy(&record, data.constData() + offset, sizeof(record));
+        if (record.type == FlightRecordTypeNone) {
+            break;
+        }
+        qint64 total = flight_record_padded_size(record.length);
+        if (offset + total > data.size()) {
+            break;
+        }
+        if (record.type == FlightRecordTypeMavlink) {
+            datagrams.append(data.mid(offset + sizeof(record), record.length));
+        }
+        offset += total;
+    }
+    return datagrams;
+}
+
+
+/*
+ * MavlinkBase::processData() over a synthetic stream, and over a recording when
+ * QOPENHD_BENCHMARK_RECORDING names a FlightRecorder segment.
+ */
+class MavlinkBenchmark: public QObject {
+    Q_OBJECT
+
+private slots:
+    void processData_data();
+    void processData();
+};
+
+
+void MavlinkBenchmark::processData_data() {
+    QTest::addColumn<QVector<QByteArray>>("datagrams");
+
+    QTest::newRow("synthetic") << syntheticDatagrams();
+
+    auto recording = qEnvironmentVariable("QOPENHD_BENCHMARK_RECORDING");
+    if (!recording.isEmpty()) {
+        QTest::newRow("recorded") << recordedDatagrams(recording);
+    }
+}
+
+
+void MavlinkBenchmark::processData() {
+    QFETCH(QVector<QByteArray>, datagrams);
+
+    qint64 size = 0;
+    for (auto &datagram : datagrams) {
+        size += datagram.size();
+    }
+    QVERIFY(size > 0);
+
+    BenchmarkMavlink mavlink;
+    uint64_t messages = 0;
+    QObject::connect(&mavlink, &MavlinkBase::processMavlinkMessage, [&messages](mavlink_message_t) {
+        messages++;
+    });
+
+    BenchmarkMeter meter(size);
+
+    QBENCHMARK {
+        meter.begin();
+        for (auto &datagram : datagrams) {
+            mavlink.processData(datagram);
+        }
+        meter.end();
+    }
+
+    meter.report();
+    QVERIFY(messages > 0);
+}
+
+
+int runMavlinkBenchmark(int argc, char *argv[]) {
+    MavlinkBenchmark benchmark;
+    return QTest::qExec(&benchmark, argc, argv);
+}
+
+#include "mavlinkbenchmark.moc"
@@ -0,0 +1,295 @@
+#include <QtTest>
+
+#include "benchmarks.h"
+#include "benchmarkmeter.h"
+
+#include "openhdvideo.h"
+
+#include "h264_common.h"
+#include "pps_parser.h"
+#include "sps_parser.h"
+
+
+// 1280x720 high profile, as sent by the air pi
+static const uint8_t SPS[] = { 0x67, 0x64, 0x00, 0x1f, 0xac, 0xd9, 0x40, 0x50, 0x05, 0xbb, 0x01, 0x10, 0x00,
+                               0x00, 0x03, 0x00, 0x10, 0x00, 0x00, 0x03, 0x03, 0xc0, 0xf1, 0x83, 0x19, 0x60 };
+static const uint8_t PPS[] = { 0x68, 0xeb, 0xe3, 0xcb, 0x22, 0xc0 };
+
+static const int StreamSize = 1024 * 1024;
+static const int GOPLength = 30;
+static const int IDRSize = 20000;
+static const int SliceSize = 3000;
+static const int RTPPayloadSize = 1400;
+
+
+/*
+ * OpenHDVideo with the parsing entry points exposed and no decoder behind it, frames are
+ * counted and dropped. It starts out configured so processNAL() takes the same path it does
+ * once a decoder is running.
+ */
+class BenchmarkVideo: public OpenHDVideo {
+public:
+    BenchmarkVideo() {
+        isConfigured = true;
+    }
+
+    using OpenHDVideo::parseRTP;
+    using OpenHDVideo::findNAL;
+    using OpenHDVideo::processNAL;
+    using OpenHDVideo::tempBuffer;
+
+    uint64_t frames = 0;
+
+protected:
+    void start() override {}
+    void stop() override {}
+    void inputLoop() override {}
+    void renderLoop() override {}
+
+    void processFrame(QByteArray &nal, webrtc::H264::NaluType frameType) override {
+        Q_UNUSED(nal);
+        Q_UNUSED(frameType);
+        frames++;
+    }
+};
+
+
+/*
+ * About 1MiB of NAL units in GOPs of an SPS, a PPS, an IDR and slices. The slice data is random
+ * but never 0, so it can't contain anything that looks like a start code.
+ */
+static QVector<QByteArray> syntheticNALs() {
+    QRandomGenerator generator(1);
+    QVector<QByteArray> nals;
+
+    int total = 0;
+    int count = 0;
+
+    while (total < StreamSize) {
+        if (count % GOPLength == 0) {
+            nals.append(QByteArray((const char*)SPS, sizeof(SPS)));
+            nals.append(QByteArray((const char*)PPS, sizeof(PPS)));
+        }
+
+        bool idr = count % GOPLength == 0;
+        QByteArray nal(idr ? IDRSize : SliceSize, Qt::Uninitialized);
+        nal[0] = idr ? 0x65 : 0x41;
+        for (int i = 1; i < nal.size(); i++) {
+            nal[i] = (char)(1 + generator.bounded(255));
+        }
+        nals.append(nal);
+
+        total += nal.size();
+        count++;
+    }
+    return nals;
+}
+
+
+static QByteArray annexB(const QVector<QByteArray> &nals) {
+    QByteArray stream;
+    for (auto &nal : nals) {
+        stream.append(NAL_HEADER, 4);
+        stream.append(nal);
+    }
+    return stream;
+}
+
+
+/*
+ * RTP packetization the way the air side sends it, single NAL unit packets when they fit and
+ * FU-A fragments when they don't.
+ */
+static QVector<QByteArray> rtpDatagrams(const QVector<QByteArray> &nals) {
+    QVector<QByteArray> datagrams;
+    uint16_t sequence = 0;
+    uint32_t timestamp = 0;
+
+    auto header = [&sequence, &timestamp](bool marker) {
+        uint8_t h[12] = { 0x80, (uint8_t)((marker ? 0x80 : 0x00) | 96),
+                          (uint8_t)(sequence >> 8), (uint8_t)sequence,
+                          (uint8_t)(timestamp >> 24), (uint8_t)(timestamp >> 16), (uint8_t)(timestamp >> 8), (uint8_t)timestamp,
+                          0x12, 0x34, 0x56, 0x78 };
+        sequence++;
+        return QByteArray((const char*)h, sizeof(h));
+    };
+
+    for (auto &nal : nals) {
+        if (nal.size() <= RTPPayloadSize) {
+            datagrams.append(header(true) + nal);
+        } else {
+            uint8_t indicator = (nal[0] & 0xe0) | 28;
+            uint8_t type = nal[0] & 0x1f;
+
+            for (int offset = 1; offset < nal.size(); offset += RTPPayloadSize) {
+                int length = qMin(RTPPayloadSize, nal.size() - offset);
+                bool first = offset == 1;
+                bool last = offset + length == nal.size();
+
+                auto datagram = header(last);
+                datagram.append((char)indicator);
+                datagram.append((char)((first ? 0x80 : 0x00) | (last ? 0x40 : 0x00) | type));
+                datagram.append(nal.constData() + offset, length);
+                datagrams.append(datagram);
+            }
+        }
+        timestamp += 3000;
+    }
+    return datagrams;
+}
+
+
+static qint64 totalSize(const QVector<QByteArray> &datagrams) {
+    qint64 size = 0;
+    for (auto &datagram : datagrams) {
+        size += datagram.size();
+    }
+    return size;
+}
+
+
+/*
+ * The video receive path in front of the decoder: RTP depacketization, start code scanning
+ * for raw streams, NAL dispatch and the SPS/PPS parsers.
+ */
+class VideoBenchmark: public QObject {
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+
+    void parseRTP();
+    void findNAL();
+    void processNAL();
+    void findNaluIndices();
+
+    void parameterSets_data();
+    void parameterSets();
+
+private:
+    QVector<QByteArray> m_nals;
+};
+
+
+void VideoBenchmark::initTestCase() {
+    m_nals = syntheticNALs();
+}
+
+
+void VideoBenchmark::parseRTP() {
+    auto datagrams = rtpDatagrams(m_nals);
+    BenchmarkVideo video;
+    BenchmarkMeter meter(totalSize(datagrams));
+
+    QBENCHMARK {
+        meter.begin();
+        for (auto &datagram : datagrams) {
+            video.parseRTP(datagram);
+        }
+        meter.end();
+    }
+
+    meter.report();
+    QVERIFY(video.frames > 0);
+}
+
+
+void VideoBenchmark::findNAL() {
+    auto stream = annexB(m_nals);
+    BenchmarkVideo video;
+    BenchmarkMeter meter(stream.size());
+
+    // raw streams arrive in datagram sized pieces that don't line up with the NAL units
+    QBENCHMARK {
+        meter.begin();
+        for (int offset = 0; offset < stream.size(); offset += RTPPayloadSize) {
+            video.tempBuffer.append(stream.constData() + offset, qMin(RTPPayloadSize, stream.size() - offset));
+            video.findNAL();
+        }
+        meter.end();
+    }
+
+    meter.report();
+    QVERIFY(video.frames > 0);
+}
+
+
+void VideoBenchmark::processNAL() {
+    BenchmarkVideo video;
+    BenchmarkMeter meter(totalSize(m_nals));
+
+    QBENCHMARK {
+        meter.begin();
+        for (auto &nal : m_nals) {
+            video.processNAL((const uint8_t*)nal.constData(), nal.size());
+        }
+        meter.end();
+    }
+
+    meter.report();
+    QVERIFY(video.frames > 0);
+}
+
+
+void VideoBenchmark::findNaluIndices() {
+    auto stream = annexB(m_nals);
+    size_t found = 0;
+    BenchmarkMeter meter(stream.size());
+
+    QBENCHMARK {
+        meter.begin();
+        auto indexes = webrtc::H264::FindNaluIndices((const uint8_t*)stream.constData(), stream.size());
+        found = indexes.size();
+        meter.end();
+    }
+
+    meter.report();
+    QCOMPARE(found, (size_t)m_nals.size());
+}
+
+
+void VideoBenchmark::parameterSets_data() {
+    QTest::addColumn<QByteArray>("nal");
+
+    QTest::newRow("SPS") << QByteArray((const char*)SPS, sizeof(SPS));
+    QTest::newRow("PPS") << QByteArray((const char*)PPS, sizeof(PPS));
+}
+
+
+void VideoBenchmark::parameterSets() {
+    QFETCH(QByteArray, nal);
+
+    // a single parameter set is far too short to time on its own
+    const int repeat = 10000;
+
+    auto data = (const uint8_t*)nal.constData() + webrtc::H264::kNaluTypeSize;
+    size_t length = nal.size() - webrtc::H264::kNaluTypeSize;
+    bool sps = webrtc::H264::ParseNaluType(nal[0]) == webrtc::H264::NaluType::kSps;
+    int parsed = 0;
+
+    BenchmarkMeter meter((qint64)repeat * nal.size());
+
+    QBENCHMARK {
+        meter.begin();
+        parsed = 0;
+        for (int i = 0; i < repeat; i++) {
+            if (sps) {
+                parsed += webrtc::SpsParser::ParseSps(data, length) ? 1 : 0;
+            } else {
+                parsed += webrtc::PpsParser::ParsePps(data, length) ? 1 : 0;
+            }
+        }
+        meter.end();
+    }
+
+    meter.report();
+    QCOMPARE(parsed, repeat);
+}
+
+
+int runVideoBenchmark(int argc, char *argv[]) {
+    VideoBenchmark benchmark;
+    return QTest::qExec(&benchmark, argc, argv);
+}
+
+#include "videobenchmark.moc"
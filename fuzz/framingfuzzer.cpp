@@ -0,0 +1,51 @@
+/*
+ * libFuzzer target for a TelemetryFramer, FUZZ_PROTOCOL is set by each of the .pro files.
+ *
+ * Besides whatever the sanitizers catch, this checks that every frame the framer hands out can
+ * be read completely and safely, and that the framer always finds its way back to looking for
+ * a sync no matter what state the input left it in, so a corrupted stream can't stall it.
+ */
+
+#include <stdlib.h>
+
+#include "telemetryframing.h"
+
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+    TelemetryFramer framer(FUZZ_PROTOCOL);
+
+    for (size_t i = 0; i < size; i++) {
+        if (!framer.push(data[i])) {
+            continue;
+        }
+
+        auto payload = framer.payload();
+        if (payload.size() < 0 || payload.size() > TelemetryFramer::MaxFrameSize) {
+            abort();
+        }
+
+        // read it the way the decoders do, including past the end
+        while (!payload.overrun()) {
+            payload.u32_be();
+            payload.u16();
+            payload.u8();
+        }
+        if (payload.remaining() != 0) {
+            abort();
+        }
+    }
+
+    // anything the input left half finished has to be given up on within one frame
+    for (int i = 0; i < TelemetryFramer::MaxFrameSize; i++) {
+        framer.push(0x00);
+    }
+    if (framer.state() != FramerStateSync) {
+        abort();
+    }
+
+    if (framer.stats().bytes != size + TelemetryFramer::MaxFrameSize) {
+        abort();
+    }
+
+    return 0;
+}
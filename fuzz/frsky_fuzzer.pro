@@ -0,0 +1,4 @@
+TARGET = frsky_fuzzer
+DEFINES += FUZZ_PROTOCOL=FrSkyFrameProtocol
+
+include(fuzz.pri)
@@ -0,0 +1,18 @@
+TEMPLATE = app
+CONFIG += console c++17
+CONFIG -= qt app_bundle
+
+# the targets share a directory but build framingfuzzer.cpp with different protocols
+OBJECTS_DIR = $${OUT_PWD}/obj/$${TARGET}
+
+QMAKE_CXXFLAGS += -g -fsanitize=fuzzer,address,undefined
+QMAKE_LFLAGS += -fsanitize=fuzzer,address,undefined
+
+INCLUDEPATH += $$PWD/../inc
+
+SOURCES += \
+    $$PWD/framingfuzzer.cpp \
+    $$PWD/../src/telemetryframing.cpp
+
+HEADERS += \
+    $$PWD/../inc/telemetryframing.h
@@ -0,0 +1,12 @@
+# libFuzzer targets for the serial telemetry framing, one per protocol. They need clang:
+#
+#   qmake -spec linux-clang fuzz/fuzz.pro && make
+#   ./ltm_fuzzer -max_total_time=600 corpus/ltm
+
+TEMPLATE = subdirs
+
+SUBDIRS += \
+    frsky_fuzzer.pro \
+    ltm_fuzzer.pro \
+    smartport_fuzzer.pro \
+    vector_fuzzer.pro
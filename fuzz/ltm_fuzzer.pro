@@ -0,0 +1,4 @@
+TARGET = ltm_fuzzer
+DEFINES += FUZZ_PROTOCOL=LTMFrameProtocol
+
+include(fuzz.pri)
@@ -0,0 +1,4 @@
+TARGET = smartport_fuzzer
+DEFINES += FUZZ_PROTOCOL=SmartPortFrameProtocol
+
+include(fuzz.pri)
@@ -0,0 +1,4 @@
+TARGET = vector_fuzzer
+DEFINES += FUZZ_PROTOCOL=VectorFrameProtocol
+
+include(fuzz.pri)
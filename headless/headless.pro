@@ -0,0 +1,26 @@
+# QOpenHD without QML or video, for running the telemetry stack on a server or in a test
+# harness:
+#
+#   qmake headless/headless.pro && make && ./qopenhd-headless
+#
+# kill -USR1 <pid> prints a stats dump, --stats-interval prints one periodically.
+
+TEMPLATE = app
+TARGET = qopenhd-headless
+
+LANGUAGE = C++
+CONFIG += c++17 console
+CONFIG -= app_bundle
+
+include(../platforms.pri)
+
+include(../git.pri)
+
+include(../qopenhd-core.pri)
+
+SOURCES += \
+    main.cpp \
+    statsdump.cpp
+
+HEADERS += \
+    statsdump.h
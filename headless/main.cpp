@@ -0,0 +1,198 @@
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QDebug>
+#include <QThread>
+#include <QTimer>
+
+#include "constants.h"
+#include "logger.h"
+
+#include "migration.hpp"
+#include "openhdtelemetry.h"
+#include "openhdrc.h"
+#include "rcsender.h"
+#include "openhdsettings.h"
+#include "settingssender.h"
+#include "openhd.h"
+#include "mavlinktelemetry.h"
+#include "telemetrydetector.h"
+
+#include "powermicroservice.h"
+
+#include "gpiomicroservice.h"
+
+#include "statusmicroservice.h"
+
+#include "statuslogmodel.h"
+#include "wifiadaptermodel.h"
+#include "linkanalytics.h"
+
+#include "flightrecorder.h"
+#include "ingestreactor.h"
+#include "telemetryreplay.h"
+#include "telemetrysubscriptions.h"
+
+#include "statsdump.h"
+
+
+/*
+ * The same telemetry, settings and RC stack main.cpp wires up around the QML engine, on a
+ * QCoreApplication instead. Nothing here needs a display, so it can run for hours on a server
+ * under synthetic load while the stats dump is watched for memory growth or CPU regressions.
+ */
+int main(int argc, char *argv[]) {
+    QCoreApplication::setOrganizationName("Open.HD");
+    QCoreApplication::setOrganizationDomain("open.hd");
+    QCoreApplication::setApplicationName("Open.HD");
+
+    Logger::instance()->install();
+
+    QCoreApplication app(argc, argv);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("QOpenHD telemetry stack without QML or video");
+    parser.addHelpOption();
+    QCommandLineOption statsIntervalOption("stats-interval", "Print a stats dump every <seconds>, 0 for only on SIGUSR1.", "seconds", "0");
+    parser.addOption(statsIntervalOption);
+    QCommandLineOption replayOption("replay", "Play a flight recorder segment through the stack at full speed, in a loop.", "path");
+    parser.addOption(replayOption);
+    parser.process(app);
+
+    Migration::instance()->run();
+
+
+    auto openhd = OpenHD::instance();
+
+    auto openHDSettings = new OpenHDSettings();
+
+    auto settingsSender = SettingsSender::instance();
+    QThread *settingsThread = new QThread();
+    settingsThread->setObjectName("settingsSenderThread");
+    QObject::connect(settingsThread, &QThread::started, settingsSender, &SettingsSender::onStarted);
+    settingsSender->moveToThread(settingsThread);
+    QObject::connect(openHDSettings, &OpenHDSettings::groundStationIPUpdated, settingsSender, &SettingsSender::setGroundIP, Qt::QueuedConnection);
+    settingsThread->start();
+
+    auto rcSender = RCSender::instance();
+    QThread *rcThread = new QThread();
+    rcThread->setObjectName("rcSenderThread");
+    QObject::connect(rcThread, &QThread::started, rcSender, &RCSender::onStarted);
+    rcSender->moveToThread(rcThread);
+    QObject::connect(&app, &QCoreApplication::aboutToQuit, rcSender, &RCSender::onStopped, Qt::DirectConnection);
+    rcThread->start();
+
+    auto openHDRC = new OpenHDRC();
+    QObject::connect(openHDSettings, &OpenHDSettings::groundStationIPUpdated, openHDRC, &OpenHDRC::setGroundIP, Qt::QueuedConnection);
+
+
+    auto flightRecorder = FlightRecorder::instance();
+    QThread *recorderThread = new QThread();
+    recorderThread->setObjectName("flightRecorderThread");
+    QObject::connect(recorderThread, &QThread::started, flightRecorder, &FlightRecorder::onStarted);
+    flightRecorder->moveToThread(recorderThread);
+    QObject::connect(&app, &QCoreApplication::aboutToQuit, flightRecorder, &FlightRecorder::onStopped, Qt::BlockingQueuedConnection);
+    recorderThread->start();
+
+
+    auto ingestReactor = IngestReactor::instance();
+    QThread *ingestThread = new QThread();
+    ingestThread->setObjectName("ingestThread");
+    QObject::connect(ingestThread, &QThread::started, ingestReactor, &IngestReactor::onStarted);
+    ingestReactor->moveToThread(ingestThread);
+    QObject::connect(&app, &QCoreApplication::aboutToQuit, ingestReactor, &IngestReactor::onStopped, Qt::DirectConnection);
+    ingestThread->start();
+
+    auto telemetryDetector = TelemetryDetector::instance();
+    QObject::connect(openHDSettings, &OpenHDSettings::groundStationIPUpdated, telemetryDetector, &TelemetryDetector::setGroundIP, Qt::QueuedConnection);
+    telemetryDetector->onStarted();
+
+
+    TelemetrySubscriptions::instance();
+
+    auto mavlinkTelemetry = MavlinkTelemetry::instance();
+    QThread *mavlinkThread = new QThread();
+    mavlinkThread->setObjectName("mavlinkTelemetryThread");
+    QObject::connect(mavlinkThread, &QThread::started, mavlinkTelemetry, &MavlinkTelemetry::onStarted);
+    mavlinkTelemetry->moveToThread(mavlinkThread);
+    QObject::connect(openHDSettings, &OpenHDSettings::groundStationIPUpdated, mavlinkTelemetry, &MavlinkTelemetry::setGroundIP, Qt::QueuedConnection);
+    QObject::connect(mavlinkTelemetry, &MavlinkTelemetry::heartbeat_received, telemetryDetector, &TelemetryDetector::onMavlinkHeartbeat, Qt::QueuedConnection);
+    mavlinkThread->start();
+
+
+    auto openhdTelemetry = OpenHDTelemetry::instance();
+    openhdTelemetry->onStarted();
+
+    auto airGPIOMicroservice = new GPIOMicroservice(nullptr, MicroserviceTargetAir, MavlinkTypeTCP);
+    QObject::connect(openHDSettings, &OpenHDSettings::groundStationIPUpdated, airGPIOMicroservice, &GPIOMicroservice::setGroundIP, Qt::QueuedConnection);
+    airGPIOMicroservice->onStarted();
+
+    auto groundPowerMicroservice = new PowerMicroservice(nullptr, MicroserviceTargetGround, MavlinkTypeTCP);
+    QObject::connect(openHDSettings, &OpenHDSettings::groundStationIPUpdated, groundPowerMicroservice, &PowerMicroservice::setGroundIP, Qt::QueuedConnection);
+    groundPowerMicroservice->onStarted();
+
+    auto groundStatusMicroservice = new StatusMicroservice(nullptr, MicroserviceTargetGround, MavlinkTypeTCP);
+    QObject::connect(openHDSettings, &OpenHDSettings::groundStationIPUpdated, groundStatusMicroservice, &StatusMicroservice::setGroundIP, Qt::QueuedConnection);
+    groundStatusMicroservice->onStarted();
+
+    auto airStatusMicroservice = new StatusMicroservice(nullptr, MicroserviceTargetAir, MavlinkTypeTCP);
+    QObject::connect(openHDSettings, &OpenHDSettings::groundStationIPUpdated, airStatusMicroservice, &StatusMicroservice::setGroundIP, Qt::QueuedConnection);
+    airStatusMicroservice->onStarted();
+
+
+    auto telemetryReplay = TelemetryReplay::instance();
+    telemetryReplay->addMavlinkTarget(mavlinkTelemetry);
+    telemetryReplay->addMavlinkTarget(airGPIOMicroservice);
+    telemetryReplay->addMavlinkTarget(groundPowerMicroservice);
+    telemetryReplay->addMavlinkTarget(groundStatusMicroservice);
+    telemetryReplay->addMavlinkTarget(airStatusMicroservice);
+    telemetryReplay->setOpenHDTarget(openhdTelemetry);
+    QThread *replayThread = new QThread();
+    replayThread->setObjectName("telemetryReplayThread");
+    QObject::connect(replayThread, &QThread::started, telemetryReplay, &TelemetryReplay::onStarted);
+    telemetryReplay->moveToThread(replayThread);
+    replayThread->start();
+
+
+    StatusLogModel::instance();
+    WifiAdapterModel::instance();
+    LinkAnalytics::instance();
+
+
+    /*
+     * With no window there are no frames to sync telemetry on, so it's applied at the rate
+     * the QML side would see it.
+     */
+    QTimer syncTimer;
+    QObject::connect(&syncTimer, &QTimer::timeout, openhd, &OpenHD::syncTelemetry);
+    syncTimer.start(16);
+
+
+    auto statsDump = new StatsDump(&app);
+    if (!statsDump->installSignalHandler()) {
+        qDebug() << "SIGUSR1 stats dump not available";
+    }
+
+    QTimer statsTimer;
+    auto statsInterval = parser.value(statsIntervalOption).toInt();
+    if (statsInterval > 0) {
+        QObject::connect(&statsTimer, &QTimer::timeout, statsDump, &StatsDump::dump);
+        statsTimer.start(statsInterval * 1000);
+    }
+
+
+    if (parser.isSet(replayOption)) {
+        // start over whenever the end of the segment is reached
+        QObject::connect(telemetryReplay, &TelemetryReplay::playing_changed, telemetryReplay, [telemetryReplay](bool playing) {
+            if (!playing) {
+                telemetryReplay->play();
+            }
+        });
+        telemetryReplay->setSpeed(TelemetryReplay::SpeedMax);
+        telemetryReplay->open(parser.value(replayOption));
+        telemetryReplay->play();
+    }
+
+    qDebug() << "Running headless";
+
+    return app.exec();
+}
@@ -0,0 +1,183 @@
+#include "statsdump.h"
+
+#include <QtCore>
+#include <QSocketNotifier>
+
+#ifndef __windows__
+#include <signal.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+#include "flightrecorder.h"
+#include "ingestreactor.h"
+#include "linkanalytics.h"
+#include "logger.h"
+#include "mavlinktelemetry.h"
+#include "openhd.h"
+#include "rcsender.h"
+#include "telemetrydetector.h"
+#include "telemetryreplay.h"
+
+
+int StatsDump::m_signal_fd[2] = { -1, -1 };
+
+
+StatsDump::StatsDump(QObject *parent): QObject(parent) {
+    qDebug() << "StatsDump::StatsDump()";
+    m_uptime.start();
+}
+
+
+bool StatsDump::installSignalHandler() {
+#ifndef __windows__
+    if (::socketpair(AF_UNIX, SOCK_STREAM, 0, m_signal_fd) != 0) {
+        qDebug() << "StatsDump: socketpair failed";
+        return false;
+    }
+
+    m_notifier = new QSocketNotifier(m_signal_fd[1], QSocketNotifier::Read, this);
+    connect(m_notifier, &QSocketNotifier::activated, this, &StatsDump::onSignal);
+
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = StatsDump::signalHandler;
+    sigemptyset(&action.sa_mask);
+    action.sa_flags = SA_RESTART;
+
+    if (sigaction(SIGUSR1, &action, nullptr) != 0) {
+        qDebug() << "StatsDump: sigaction failed";
+        return false;
+    }
+    return true;
+#else
+    return false;
+#endif
+}
+
+
+void StatsDump::signalHandler(int signal) {
+#ifndef __windows__
+    Q_UNUSED(signal);
+    char a = 1;
+    // nothing else is async signal safe, the dump happens in onSignal()
+    auto written = ::write(m_signal_fd[0], &a, sizeof(a));
+    Q_UNUSED(written);
+#else
+    Q_UNUSED(signal);
+#endif
+}
+
+
+void StatsDump::onSignal() {
+#ifndef __windows__
+    m_notifier->setEnabled(false);
+    char a;
+    auto received = ::read(m_signal_fd[1], &a, sizeof(a));
+    Q_UNUSED(received);
+    m_notifier->setEnabled(true);
+#endif
+    dump();
+}
+
+
+// resident set size in kB, from /proc so it's the current value rather than the peak
+static qint64 residentKB() {
+    QFile status("/proc/self/status");
+    if (!status.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        return -1;
+    }
+    while (!status.atEnd()) {
+        auto line = status.readLine();
+        if (line.startsWith("VmRSS:")) {
+            return line.mid(6).trimmed().split(' ').first().toLongLong();
+        }
+    }
+    return -1;
+}
+
+
+void StatsDump::dump() {
+    QStringList lines;
+
+    lines << QString("uptime: %1 s").arg(m_uptime.elapsed() / 1000.0, 0, 'f', 1);
+
+#ifndef __windows__
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) == 0) {
+        auto user = usage.ru_utime.tv_sec + usage.ru_utime.tv_usec / 1e6;
+        auto system = usage.ru_stime.tv_sec + usage.ru_stime.tv_usec / 1e6;
+        lines << QString("cpu: %1 s user, %2 s system, %3% average")
+                 .arg(user, 0, 'f', 2)
+                 .arg(system, 0, 'f', 2)
+                 .arg((user + system) * 100000.0 / qMax<qint64>(m_uptime.elapsed(), 1), 0, 'f', 1);
+        lines << QString("memory: %1 kB resident, %2 kB peak").arg(residentKB()).arg(usage.ru_maxrss);
+    }
+#endif
+
+    auto reactor = IngestReactor::instance();
+    lines << QString("ingest: %1 datagrams, %2 wakeups").arg(reactor->datagrams()).arg(reactor->wakeups());
+
+    lines << QString("telemetry sync: %1 ms total").arg(OpenHD::instance()->telemetrySyncNsecs() / 1e6, 0, 'f', 1);
+
+    lines << QString("legacy protocol: %1").arg(TelemetryDetector::instance()->property("protocol").toString());
+
+    // MavlinkTelemetry lives on its own thread, read its properties there
+    auto mavlink = MavlinkTelemetry::instance();
+    QString mavlink_line;
+    QMetaObject::invokeMethod(mavlink, [mavlink, &mavlink_line] {
+        mavlink_line = QString("mavlink: last heartbeat %1, %2 commands pending, last command latency %3 ms")
+                       .arg(mavlink->property("last_heartbeat").toLongLong())
+                       .arg(mavlink->property("commands_pending").toInt())
+                       .arg(mavlink->property("command_latency_ms").toLongLong());
+    }, Qt::BlockingQueuedConnection);
+    lines << mavlink_line;
+
+    auto replay = TelemetryReplay::instance();
+    QString replay_line;
+    QMetaObject::invokeMethod(replay, [replay, &replay_line] {
+        if (replay->property("active").toBool()) {
+            replay_line = QString("replay: %1 messages/s, %2 ns/message on the main thread")
+                          .arg(replay->property("messages_per_second").toDouble(), 0, 'f', 0)
+                          .arg(replay->property("gui_ns_per_message").toDouble(), 0, 'f', 0);
+        }
+    }, Qt::BlockingQueuedConnection);
+    if (!replay_line.isEmpty()) {
+        lines << replay_line;
+    }
+
+    auto rc = RCSender::instance();
+    lines << QString("rc: %1 packets, send jitter p50 %2 us, p99 %3 us, max %4 us")
+             .arg(rc->packetsSent())
+             .arg(rc->jitterPercentileUs(0.5))
+             .arg(rc->jitterPercentileUs(0.99))
+             .arg(rc->jitterMaxUs());
+    lines << QString("rc: input to socket latency p50 %1 us, p99 %2 us, max %3 us")
+             .arg(rc->latencyPercentileUs(0.5))
+             .arg(rc->latencyPercentileUs(0.99))
+             .arg(rc->latencyMaxUs());
+
+    lines << QString("flight recorder: %1 records dropped").arg(FlightRecorder::instance()->get_dropped_records());
+
+    auto logger = Logger::instance();
+    lines << QString("log: %1 lines, %2 events, %3 dropped, %4 suppressed by rate limits")
+             .arg(logger->written())
+             .arg(logger->events())
+             .arg(logger->dropped())
+             .arg(logger->suppressed());
+
+    auto statistics = LinkAnalytics::instance()->property("statistics").toMap();
+    for (auto i = statistics.constBegin(); i != statistics.constEnd(); i++) {
+        auto entry = i.value().toMap();
+        lines << QString("link %1: %2 (1s), %3 (60s), p99 %4")
+                 .arg(i.key())
+                 .arg(entry.value("value_1s").toDouble())
+                 .arg(entry.value("value_60s").toDouble())
+                 .arg(entry.value("p99").toDouble());
+    }
+
+    for (auto &line : lines) {
+        qInfo().noquote() << "StatsDump:" << line;
+    }
+}
@@ -0,0 +1,42 @@
+#ifndef STATSDUMP_H
+#define STATSDUMP_H
+
+#include <QObject>
+#include <QElapsedTimer>
+
+class QSocketNotifier;
+
+
+/*
+ * Prints the numbers a soak test watches for regressions: memory and CPU use of the process
+ * and the throughput counters of the ingest stack.
+ *
+ * A dump is printed whenever the process gets SIGUSR1. The signal handler only writes a byte
+ * to a socket pair, the dump itself runs on the main thread when the notifier fires, so it's
+ * free to take locks and allocate.
+ */
+class StatsDump: public QObject {
+    Q_OBJECT
+
+public:
+    explicit StatsDump(QObject *parent = nullptr);
+
+    // installs the SIGUSR1 handler, returns false if that wasn't possible
+    bool installSignalHandler();
+
+public slots:
+    void dump();
+
+private slots:
+    void onSignal();
+
+private:
+    static void signalHandler(int signal);
+
+    static int m_signal_fd[2];
+
+    QSocketNotifier* m_notifier = nullptr;
+    QElapsedTimer m_uptime;
+};
+
+#endif // STATSDUMP_H
@@ -5,4 +5,6 @@
 #define VIDEO_FIFO "/root/videofifo1"
 #define MESSAGE_FIFO "/tmp/messagefifo1"
 
+#define SETTINGS_PORT 1011
+
 //#define __rasp_pi__
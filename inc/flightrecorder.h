@@ -0,0 +1,128 @@
+#ifndef FLIGHTRECORDER_H
+#define FLIGHTRECORDER_H
+
+#include <QObject>
+#include <QtQuick>
+#include <QFile>
+
+#include <atomic>
+#include <stdint.h>
+
+
+/*
+ * On-disk layout of a recording segment.
+ *
+ * Each segment starts with a flight_record_segment_header_t followed by records, each one a
+ * flight_record_header_t and its payload padded to an 8 byte boundary. Segments are
+ * preallocated, so a record with a length of 0 marks the end of the data in a segment that
+ * was not closed cleanly.
+ */
+#define FLIGHT_RECORD_MAGIC "QOHDREC"
+#define FLIGHT_RECORD_VERSION 1
+#define FLIGHT_RECORD_ALIGN 8
+
+typedef enum FlightRecordType {
+    FlightRecordTypeNone = 0,
+    FlightRecordTypeMavlink = 1,
+    FlightRecordTypeWifibroadcastStatus = 2
+} FlightRecordType;
+
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t header_size;
+    int64_t wall_clock_ms;  // wall clock time when the segment was created
+    int64_t monotonic_ns;   // steady clock at the same moment, record timestamps use this clock
+} flight_record_segment_header_t;
+
+typedef struct {
+    uint64_t timestamp_ns;  // steady clock
+    uint16_t length;        // payload length, not including padding
+    uint16_t port;          // local port the data arrived on
+    uint8_t type;           // FlightRecordType
+    uint8_t reserved[3];
+} flight_record_header_t;
+
+static_assert(sizeof(flight_record_segment_header_t) == 32, "unexpected flight record segment header size");
+static_assert(sizeof(flight_record_header_t) == 16, "unexpected flight record header size");
+
+inline uint32_t flight_record_padded_size(uint32_t length) {
+    return (sizeof(flight_record_header_t) + length + FLIGHT_RECORD_ALIGN - 1) & ~(FLIGHT_RECORD_ALIGN - 1);
+}
+
+int64_t flight_record_monotonic_ns();
+
+
+class FlightRecorderRing;
+
+
+/*
+ * Appends every raw MAVLink datagram and wifibroadcast status packet QOpenHD receives to a
+ * set of rotating segment files, so link problems can be analysed after a flight.
+ *
+ * record() is called directly from the ingest threads and never blocks: each thread gets its
+ * own single-producer ring the first time it records anything, and if a ring is full the
+ * record is dropped and counted instead of waiting. The recorder itself lives on its own
+ * thread and periodically moves the rings into a memory mapped, preallocated segment file.
+ */
+class FlightRecorder: public QObject {
+    Q_OBJECT
+
+public:
+    explicit FlightRecorder(QObject *parent = nullptr);
+    static FlightRecorder* instance();
+
+    void record(FlightRecordType type, uint16_t port, const char* data, int length);
+
+    Q_PROPERTY(bool enabled READ get_enabled WRITE set_enabled NOTIFY enabled_changed)
+    bool get_enabled() const;
+    void set_enabled(bool enabled);
+
+    Q_PROPERTY(quint64 dropped_records READ get_dropped_records NOTIFY dropped_records_changed)
+    quint64 get_dropped_records() const;
+
+    Q_PROPERTY(QString recording_path MEMBER m_recording_path NOTIFY recording_path_changed)
+
+    static QString recordingDirectory();
+
+signals:
+    void enabled_changed(bool enabled);
+    void dropped_records_changed(quint64 dropped_records);
+    void recording_path_changed(QString recording_path);
+
+public slots:
+    void onStarted();
+    void onStopped();
+
+private slots:
+    void flush();
+
+private:
+    bool openSegment();
+    void closeSegment();
+    void enforceBudget();
+    void set_recording_path(QString recording_path);
+
+    static const int MaxRings = 8;
+
+    std::atomic<FlightRecorderRing*> m_rings[MaxRings];
+    std::atomic<int> m_ring_count;
+
+    std::atomic<bool> m_enabled;
+    std::atomic<quint64> m_dropped;
+    quint64 m_reported_dropped = 0;
+
+    QTimer* timer = nullptr;
+
+    QFile m_segment;
+    uchar* m_segment_data = nullptr;
+    qint64 m_segment_size = 0;
+    qint64 m_segment_pos = 0;
+    int m_segment_index = 0;
+
+    qint64 m_budget = 0;
+
+    QString m_recording_path;
+};
+
+#endif
@@ -5,22 +5,20 @@
 #include <QtQuick>
 
 #include "constants.h"
+#include "ingestreactor.h"
+#include "telemetryframing.h"
+#include "telemetrystate.h"
 
 
-typedef struct {
-    int sm_state;
-    uint8_t pkg[64];
-    int pkg_pos;
-} frsky_state_t;
-
-
-class QUdpSocket;
-
-class FrSkyTelemetry: public QObject {
+class FrSkyTelemetry: public QObject, public IngestHandler {
     Q_OBJECT
 
 public:
-    explicit FrSkyTelemetry(QObject *parent = nullptr);
+    explicit FrSkyTelemetry(quint16 port, QObject *parent = nullptr);
+    ~FrSkyTelemetry();
+
+    void ingestDatagram(const uint8_t* data, int size) override;
+    void ingestFinished() override;
 
 
     Q_PROPERTY(QString last_heartbeat MEMBER m_last_heartbeat WRITE set_last_heartbeat NOTIFY last_heartbeat_changed)
@@ -30,22 +28,16 @@ signals:
     void last_heartbeat_changed(QString last_heartbeat);
 
 
-private slots:
-    void processFrSkyDatagrams();
-
 private:
-    void frsky_interpret_packet();
-    void frsky_parse_buffer(uint8_t *buf, int buflen);
-
-    void processFrSkyMessage();
+    void processFrSkyMessage(uint8_t id, FrameReader payload);
 
-    QUdpSocket *frskySocket = nullptr;
+    TelemetryFramer m_framer;
+    TelemetryPublisher m_telemetry;
+    quint16 m_port;
 
     QString m_last_heartbeat = "N/A";
     qint64 last_heartbeat_timestamp;
 
-    frsky_state_t state;
-
     // temporary state to account for the way the FrSky protocol works
     double _lon = 0;
     double _lat = 0;
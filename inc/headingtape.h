@@ -0,0 +1,68 @@
+#ifndef HEADINGTAPE_H
+#define HEADINGTAPE_H
+
+#include <QStringList>
+
+#include "osdinstrument.h"
+
+
+/*
+ * The horizontal compass ladder of the heading widget and the horizon: 180 degrees across its
+ * width, a big tick every 30, a small one every 15 and a label every 45.
+ *
+ * The horizon's version can hide the ticks and show a home icon at home_heading, or at the
+ * edge nearest to it when home is behind.
+ */
+class HeadingTape: public OSDInstrument {
+    Q_OBJECT
+
+public:
+    explicit HeadingTape(QQuickItem *parent = nullptr);
+
+    Q_PROPERTY(double heading MEMBER m_heading WRITE set_heading NOTIFY heading_changed)
+    void set_heading(double heading);
+
+    // label the 45 degree marks with direction_names rather than degrees
+    Q_PROPERTY(bool ladder_text MEMBER m_ladder_text WRITE set_ladder_text NOTIFY ladder_text_changed)
+    void set_ladder_text(bool ladder_text);
+
+    // N, NE, E ... NW, set from QML so they go through qsTr()
+    Q_PROPERTY(QStringList direction_names MEMBER m_direction_names WRITE set_direction_names NOTIFY direction_names_changed)
+    void set_direction_names(QStringList direction_names);
+
+    Q_PROPERTY(bool show_ticks MEMBER m_show_ticks WRITE set_show_ticks NOTIFY show_ticks_changed)
+    void set_show_ticks(bool show_ticks);
+
+    // leaves the middle free of labels for the heading widget's pointer
+    Q_PROPERTY(bool compass_gap MEMBER m_compass_gap WRITE set_compass_gap NOTIFY compass_gap_changed)
+    void set_compass_gap(bool compass_gap);
+
+    Q_PROPERTY(bool show_home MEMBER m_show_home WRITE set_show_home NOTIFY show_home_changed)
+    void set_show_home(bool show_home);
+
+    Q_PROPERTY(double home_heading MEMBER m_home_heading WRITE set_home_heading NOTIFY home_heading_changed)
+    void set_home_heading(double home_heading);
+
+signals:
+    void heading_changed(double heading);
+    void ladder_text_changed(bool ladder_text);
+    void direction_names_changed(QStringList direction_names);
+    void show_ticks_changed(bool show_ticks);
+    void compass_gap_changed(bool compass_gap);
+    void show_home_changed(bool show_home);
+    void home_heading_changed(double home_heading);
+
+protected:
+    QSGNode* updatePaintNode(QSGNode* old, UpdatePaintNodeData* data) override;
+
+private:
+    double m_heading = 0;
+    bool m_ladder_text = true;
+    QStringList m_direction_names = { "N", "NE", "E", "SE", "S", "SW", "W", "NW" };
+    bool m_show_ticks = true;
+    bool m_compass_gap = false;
+    bool m_show_home = false;
+    double m_home_heading = 0;
+};
+
+#endif // HEADINGTAPE_H
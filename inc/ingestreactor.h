@@ -0,0 +1,115 @@
+#ifndef INGESTREACTOR_H
+#define INGESTREACTOR_H
+
+#include <QObject>
+#include <QtQuick>
+#include <QWaitCondition>
+
+#include <atomic>
+
+#if defined(__rasp_pi__) || defined(__desktoplinux__)
+#define INGEST_REACTOR_EPOLL
+#include <sys/socket.h>
+#include <sys/uio.h>
+#endif
+
+class QSocketNotifier;
+class QUdpSocket;
+
+
+/*
+ * Implemented by anything that wants the datagrams arriving on a UDP port. Both methods are
+ * called on the ingest thread, never on the GUI thread, so implementations must only touch
+ * their own parser state and hand results over with a TelemetryPublisher or a queued call.
+ */
+class IngestHandler {
+public:
+    virtual ~IngestHandler() {}
+
+    virtual void ingestDatagram(const uint8_t* data, int size) = 0;
+
+    // called once after each batch of datagrams read from the port, a good place to publish
+    virtual void ingestFinished() {}
+};
+
+
+/*
+ * Owns the UDP sockets for the telemetry protocols and reads them all on a single thread,
+ * so incoming packets don't each wake up the GUI thread's event loop.
+ *
+ * On the Pi and desktop Linux every port is a plain socket in one epoll set and is drained
+ * with recvmmsg(), up to BatchSize datagrams per system call. The epoll set itself is watched
+ * by a QSocketNotifier, so the ingest thread's event loop keeps running and queued calls and
+ * timers on it work as usual. Everywhere else each port gets a QUdpSocket living on the
+ * ingest thread.
+ *
+ * Handlers are called without the reactor's lock held, so they can add and remove ports,
+ * including their own. removePort() called from another thread doesn't return until the
+ * handler can no longer be called, so a handler can remove its port in its destructor.
+ */
+class IngestReactor: public QObject {
+    Q_OBJECT
+
+public:
+    explicit IngestReactor(QObject *parent = nullptr);
+    ~IngestReactor();
+
+    static IngestReactor* instance();
+
+    bool addPort(quint16 port, IngestHandler* handler);
+    void removePort(quint16 port);
+
+    // totals since startup, safe to call from any thread
+    Q_INVOKABLE quint64 datagrams() const {
+        return m_datagram_count.load(std::memory_order_relaxed);
+    }
+    Q_INVOKABLE quint64 wakeups() const {
+        return m_wakeup_count.load(std::memory_order_relaxed);
+    }
+
+public slots:
+    void onStarted();
+    void onStopped();
+
+private:
+    static const int BatchSize = 32;
+    static const int MaxDatagramSize = 2048;
+
+    // called with m_mutex held, mark which handler the ingest thread is calling outside of it
+    void beginDispatch(IngestHandler* handler);
+    void endDispatch();
+    void waitForDispatch(IngestHandler* handler);
+
+    QMutex m_mutex;
+    QWaitCondition m_dispatch_done;
+    IngestHandler* m_dispatching = nullptr;
+
+    std::atomic<quint64> m_datagram_count { 0 };
+    std::atomic<quint64> m_wakeup_count { 0 };
+
+#if defined(INGEST_REACTOR_EPOLL)
+    void poll();
+    void drain(int fd);
+
+    int m_epoll = -1;
+    QSocketNotifier* m_notifier = nullptr;
+
+    struct IngestPort {
+        quint16 port;
+        IngestHandler* handler;
+    };
+    QHash<int, IngestPort> m_ports;
+
+    // removed by their own handler while it was being called, closed once it returns
+    QVector<int> m_closing;
+
+    mmsghdr m_messages[BatchSize];
+    iovec m_vectors[BatchSize];
+    uint8_t m_buffers[BatchSize][MaxDatagramSize];
+#else
+    QHash<quint16, IngestHandler*> m_handlers;
+    QHash<quint16, QUdpSocket*> m_sockets;
+#endif
+};
+
+#endif // INGESTREACTOR_H
@@ -0,0 +1,49 @@
+#ifndef LADDERTAPE_H
+#define LADDERTAPE_H
+
+#include "osdinstrument.h"
+
+
+/*
+ * The vertical altitude and speed ladders: a big tick and a label every 10, a small tick every
+ * 5, and a filled square every 10 below minimum.
+ *
+ * The layout is the one the old canvases had, ticks on the left and labels on the right for
+ * altitude, mirrored for speed.
+ */
+class LadderTape: public OSDInstrument {
+    Q_OBJECT
+
+public:
+    explicit LadderTape(QQuickItem *parent = nullptr);
+
+    Q_PROPERTY(double value MEMBER m_value WRITE set_value NOTIFY value_changed)
+    void set_value(double value);
+
+    // span of values shown over the tape's height
+    Q_PROPERTY(int range MEMBER m_range WRITE set_range NOTIFY range_changed)
+    void set_range(int range);
+
+    Q_PROPERTY(int minimum MEMBER m_minimum WRITE set_minimum NOTIFY minimum_changed)
+    void set_minimum(int minimum);
+
+    Q_PROPERTY(bool mirrored MEMBER m_mirrored WRITE set_mirrored NOTIFY mirrored_changed)
+    void set_mirrored(bool mirrored);
+
+signals:
+    void value_changed(double value);
+    void range_changed(int range);
+    void minimum_changed(int minimum);
+    void mirrored_changed(bool mirrored);
+
+protected:
+    QSGNode* updatePaintNode(QSGNode* old, UpdatePaintNodeData* data) override;
+
+private:
+    double m_value = 0;
+    int m_range = 100;
+    int m_minimum = 0;
+    bool m_mirrored = false;
+};
+
+#endif // LADDERTAPE_H
@@ -0,0 +1,116 @@
+#ifndef LINKANALYTICS_H
+#define LINKANALYTICS_H
+
+#include <QObject>
+#include <QtQuick>
+
+#include "ringbuffer.h"
+#include "wifibroadcaststatus.h"
+#include "timeseriesstore.h"
+
+
+typedef enum LinkMetric {
+    // counters, these are reported as a change per second
+    LinkMetricLostPackets,
+    LinkMetricDamagedBlocks,
+    LinkMetricInjectionFail,
+    LinkMetricSkippedPackets,
+    LinkMetricReceivedPackets,
+    // gauges, these are reported as an average
+    LinkMetricDownlinkRSSI,
+    LinkMetricUplinkRSSI,
+    LinkMetricBitrate,
+    LinkMetricCPULoadAir,
+    LinkMetricCPULoadGround,
+    LinkMetricTempAir,
+    LinkMetricTempGround,
+    LinkMetricCount
+} LinkMetric;
+
+
+/*
+ * Rolling statistics for the wifibroadcast link.
+ *
+ * Every status update from the ground station is stored in a fixed size ring buffer per
+ * metric, so the lifetime counters it sends can be turned into rates over a recent window
+ * instead of percentages of everything received since it booted.
+ *
+ * Once a second the windowed values (1s, 10s and 60s), an EWMA and percentiles over the last
+ * minute are published in the statistics property, keyed by metric name, and the 1 second
+ * values are appended to the history store, which charts attach their series to.
+ */
+class LinkAnalytics : public QObject {
+    Q_OBJECT
+
+public:
+    explicit LinkAnalytics(QObject *parent = nullptr);
+
+    static LinkAnalytics* instance();
+
+    static const char* metricName(LinkMetric metric);
+
+    void addSample(const WifibroadcastStatus &status, int downlink_rssi);
+
+    // rate per second for counters, average for gauges
+    double windowed(LinkMetric metric, qint64 window_ms) const;
+
+    // change in one counter as a percentage of the change in another over the window
+    double percent(LinkMetric metric, LinkMetric of, qint64 window_ms) const;
+
+    Q_PROPERTY(QVariantMap statistics MEMBER m_statistics NOTIFY statistics_changed)
+
+    // number of seconds of history recorded so far, used as the x value of the newest point
+    Q_PROPERTY(int tick MEMBER m_tick NOTIFY statistics_changed)
+
+    // the 1 second value of every metric, one column per metric name
+    Q_PROPERTY(QObject* store READ store CONSTANT)
+    QObject* store() const {
+        return m_store;
+    }
+
+    // percentiles are taken over the last minute of 1 second values
+    static const int PercentileWindow = 60;
+
+    // how much history the store keeps, in seconds
+    static const int HistoryRetention = 4 * 60 * 60;
+
+    // how much of it the status chart shows, in seconds
+    static const int ChartSpan = 300;
+
+signals:
+    void statistics_changed();
+
+private slots:
+    void updateStatistics();
+
+private:
+    static bool isCounter(LinkMetric metric);
+    static double percentile(const RingBuffer<double, PercentileWindow> &history, double fraction);
+
+    void addValue(LinkMetric metric, double value);
+    void addCounter(LinkMetric metric, uint32_t value);
+    int sampleAt(qint64 timestamp) const;
+
+    // enough for a minute of status updates at 30Hz
+    static const size_t SampleCapacity = 2048;
+
+    RingBuffer<qint64, SampleCapacity> m_timestamps;
+    RingBuffer<double, SampleCapacity> m_samples[LinkMetricCount];
+    RingBuffer<double, PercentileWindow> m_history[LinkMetricCount];
+
+    // the ground station counters restart from 0 when it reboots, these keep ours monotonic
+    uint32_t m_counter_last[LinkMetricCount] = {};
+    double m_counter_offset[LinkMetricCount] = {};
+
+    double m_ewma[LinkMetricCount] = {};
+
+    QElapsedTimer m_clock;
+    QTimer* m_timer = nullptr;
+
+    QVariantMap m_statistics;
+    int m_tick = 0;
+
+    TimeSeriesStore* m_store = nullptr;
+};
+
+#endif // LINKANALYTICS_H
@@ -0,0 +1,76 @@
+#ifndef LINKPROTOCOL_H
+#define LINKPROTOCOL_H
+
+#include <stdint.h>
+
+#include <QByteArray>
+#include <QString>
+#include <QVector>
+
+#include "telemetryframing.h"
+
+
+/*
+ * Binary encoding for QOpenHDLink, replacing the JSON objects it used to send one at a time.
+ *
+ * A message is the 2 byte magic "QL", the encoding version, then any number of records back to
+ * back, each starting with its LinkRecordType. Integers are little endian and widget names are
+ * a length byte followed by UTF-8. A JSON message always starts with "{", so both can arrive
+ * on the same port.
+ *
+ * Records are decoded with a FrameReader, a truncated or unknown record ends the message
+ * rather than throwing. Messages of a newer version than LinkProtocolVersion are dropped
+ * entirely, so the version has to be bumped whenever an existing record's layout changes.
+ */
+
+
+static const uint8_t LinkProtocolMagic[] = { 'Q', 'L' };
+static const uint8_t LinkProtocolVersion = 1;
+
+// keeps a batch of layout changes well inside a single unfragmented datagram
+static const int LinkMaxMessageSize = 1200;
+
+
+typedef enum LinkRecordType {
+    // payload: highest version understood, sent to advertise binary support
+    LinkRecordHello          = 1,
+    // payload: name, alignment u8, x offset i16, y offset i16, flags u8 (bit 0 hCenter, bit 1 vCenter)
+    LinkRecordWidgetLocation = 2,
+    // payload: name, enabled u8
+    LinkRecordWidgetEnabled  = 3
+} LinkRecordType;
+
+
+class LinkRecord {
+public:
+    LinkRecordType type = LinkRecordHello;
+    QString widget_name;
+
+    uint8_t version = LinkProtocolVersion;
+
+    int alignment = 0;
+    int x_offset = 0;
+    int y_offset = 0;
+    bool h_center = false;
+    bool v_center = false;
+
+    bool enabled = false;
+};
+
+
+// true when buffer starts with the magic, whether or not the rest of it decodes
+bool linkIsBinary(const QByteArray &buffer);
+
+/*
+ * Appends records to messages, starting a new message whenever the current one would grow past
+ * LinkMaxMessageSize.
+ */
+void linkEncode(const QVector<LinkRecord> &records, QVector<QByteArray> &messages);
+
+/*
+ * Decodes every record in buffer it can, returns false if the message was malformed or from a
+ * newer version, records decoded before the problem are still returned.
+ */
+bool linkDecode(const QByteArray &buffer, QVector<LinkRecord> &records);
+
+#endif // LINKPROTOCOL_H
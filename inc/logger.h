@@ -0,0 +1,197 @@
+#ifndef LOGGER_H
+#define LOGGER_H
+
+#include <QtGlobal>
+#include <QString>
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <stdint.h>
+
+
+/*
+ * Fixed size entry in a thread's log ring, either a line of text or a binary event. Text
+ * longer than LogTextSize is cut off, which keeps every slot the same size and formatting
+ * straight into the slot means logging never allocates.
+ */
+static const int LogTextSize = 208;
+
+typedef enum LogRecordKind {
+    LogRecordText,
+    LogRecordEvent
+} LogRecordKind;
+
+typedef struct LogRecord {
+    qint64 wall_ms;
+    uint8_t kind;
+    uint8_t type;        // QtMsgType for text
+    uint16_t event;      // LogEvent for events
+    int32_t suppressed;  // calls the rate limit dropped since this call site last logged
+    int64_t a;
+    int64_t b;
+    uint16_t length;
+    char text[LogTextSize];
+} LogRecord;
+
+
+/*
+ * High rate things worth keeping for later analysis that would flood the text log. They're
+ * written to the events file as 32 byte little endian records: wall clock ms (i64), event
+ * (u16), 6 zero bytes, then a and b (i64 each).
+ */
+typedef enum LogEvent {
+    // a: message id, b: sysid << 8 | compid
+    LogEventUnmatchedMavlink = 1
+} LogEvent;
+
+
+// one thread's ring, defined in logger.cpp
+struct LogRing;
+
+
+/*
+ * One call site's share of the log, see LOG_RATE_LIMITED, or one object's when it's a member
+ * used with LOG_RATE_LIMITED_BY. Only the call that wins the
+ * compare-exchange logs, the others just count themselves as suppressed.
+ */
+class LogRateLimit {
+public:
+    explicit LogRateLimit(int interval_ms): m_interval_ns(qint64(interval_ms) * 1000000) {}
+
+    // true when this call should log, suppressed is how many were dropped since the last one
+    bool allow(int &suppressed);
+
+private:
+    const qint64 m_interval_ns;
+    std::atomic<qint64> m_next_ns { 0 };
+    std::atomic<int> m_suppressed { 0 };
+};
+
+
+/*
+ * Asynchronous log backend, installed as the Qt message handler so qDebug() and friends go
+ * through it too.
+ *
+ * Every thread that logs gets its own single-producer ring of LogRecords. Logging formats
+ * into the next free slot and bumps the ring's head: no lock and no write. text() and event()
+ * never allocate, a qDebug() message only adds its conversion to UTF-8 to what building it
+ * already cost. A flusher thread drains
+ * all the rings every FlushIntervalMs and hands the text to the message handler that was
+ * installed before, so output still ends up wherever Qt would have put it (stderr, logcat,
+ * the debugger), just never on the thread that logged. A ring that fills up faster than it's
+ * drained drops new records and counts them rather than block.
+ *
+ * Events go to the binary events file in AppLocalData/logs when the log_events setting is on,
+ * and are only counted otherwise.
+ *
+ * Logging is meant to cost under LogCallBudgetNs on the calling thread, the benchmarks in
+ * benchmarks/loggingbenchmark.cpp report what each kind of call costs.
+ */
+class Logger {
+public:
+    static Logger* instance();
+
+    static const int RingSize = 256;
+    static const int FlushIntervalMs = 50;
+    static const qint64 LogCallBudgetNs = 1000;
+
+    // installs the message handler and starts the flusher, call once at the top of main()
+    void install();
+
+    // drains everything still queued, stops the flusher and puts the previous handler back
+    void stop();
+
+    // writes out everything queued so far on the calling thread
+    void flush();
+
+    void text(QtMsgType type, int suppressed, const char* format, ...)
+#if defined(__GNUC__)
+        __attribute__((format(printf, 4, 5)))
+#endif
+        ;
+    void event(LogEvent event, int64_t a, int64_t b);
+
+    quint64 written() const {
+        return m_written.load(std::memory_order_relaxed);
+    }
+    quint64 events() const {
+        return m_events.load(std::memory_order_relaxed);
+    }
+    quint64 dropped() const {
+        return m_dropped.load(std::memory_order_relaxed);
+    }
+    quint64 suppressed() const {
+        return m_suppressed.load(std::memory_order_relaxed);
+    }
+
+    static qint64 clockNs();
+
+private:
+    Logger() {}
+
+    LogRing* ring();
+    LogRecord* reserve(LogRing* ring);
+    void commit(LogRing* ring);
+
+    void run();
+    void drain();
+    void writeRecord(const LogRecord &record);
+    void openEvents();
+
+    static void messageHandler(QtMsgType type, const QMessageLogContext &context, const QString &message);
+
+    QtMessageHandler m_previous = nullptr;
+
+    std::mutex m_rings_mutex;
+    std::vector<LogRing*> m_rings;
+
+    // only one thread can consume the rings at a time, the flusher or a fatal message
+    std::mutex m_drain_mutex;
+
+    std::thread m_flusher;
+    std::mutex m_wake_mutex;
+    std::condition_variable m_wake;
+    std::atomic<bool> m_running { false };
+
+    FILE* m_events_file = nullptr;
+
+    std::atomic<quint64> m_written { 0 };
+    std::atomic<quint64> m_events { 0 };
+    std::atomic<quint64> m_dropped { 0 };
+    std::atomic<quint64> m_suppressed { 0 };
+};
+
+
+/*
+ * Logs at most once per interval_ms from this call site, the next message that gets through
+ * says how many were dropped in between. For anything that can fire per packet or per input.
+ *
+ *   LOG_RATE_LIMITED(1000, QtDebugMsg, "unmatched message %d", msg.msgid);
+ */
+#define LOG_RATE_LIMITED(interval_ms, type, ...) \
+    do { \
+        static LogRateLimit _log_rate_limit(interval_ms); \
+        LOG_RATE_LIMITED_BY(_log_rate_limit, type, __VA_ARGS__); \
+    } while (0)
+
+/*
+ * The same with a LogRateLimit the caller owns, for a call site in a class with several
+ * instances that should each get their own share rather than one shared by all of them.
+ *
+ *   LOG_RATE_LIMITED_BY(m_unmatched_log, QtDebugMsg, "unmatched message %d", msg.msgid);
+ */
+#define LOG_RATE_LIMITED_BY(rate_limit, type, ...) \
+    do { \
+        int _log_suppressed = 0; \
+        if ((rate_limit).allow(_log_suppressed)) { \
+            Logger::instance()->text(type, _log_suppressed, __VA_ARGS__); \
+        } \
+    } while (0)
+
+#define LOG_EVENT(event, a, b) Logger::instance()->event(event, a, b)
+
+#endif // LOGGER_H
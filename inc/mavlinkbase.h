@@ -4,6 +4,8 @@
 #include <QObject>
 #include <QtQuick>
 
+#include <functional>
+
 
 #include <openhd/mavlink.h>
 #include "constants.h"
@@ -12,6 +14,7 @@
 
 
 class QUdpSocket;
+class MavlinkRouter;
 
 typedef enum MavlinkType {
     MavlinkTypeUDP,
@@ -27,18 +30,11 @@ typedef enum MicroserviceTarget {
 typedef enum MavlinkState {
     MavlinkStateDisconnected,
     MavlinkStateConnected,
+    MavlinkStateCheckParameterHash,
     MavlinkStateGetParameters,
     MavlinkStateIdle
 } MavlinkState;
 
-typedef enum MavlinkCommandState {
-    MavlinkCommandStateReady,
-    MavlinkCommandStateSend,
-    MavlinkCommandStateWaitACK,
-    MavlinkCommandStateDone,
-    MavlinkCommandStateFailed
-} MavlinkCommandState;
-
 typedef enum MavlinkCommandType {
     MavlinkCommandTypeLong,
     MavlinkCommandTypeInt
@@ -51,6 +47,10 @@ public:
     uint16_t command_id = 0;
     uint8_t retry_count = 0;
 
+    // -1 means the system/component the MavlinkBase subclass sending it talks to
+    int16_t target_system = -1;
+    int16_t target_component = -1;
+
     uint8_t long_confirmation = 0;
     float long_param1 = 0;
     float long_param2 = 0;
@@ -74,6 +74,22 @@ public:
 };
 
 
+// called once when a command is acknowledged, rejected or times out
+typedef std::function<void(bool success, uint8_t result)> MavlinkCommandCallback;
+
+
+class MavlinkPendingCommand {
+public:
+    MavlinkPendingCommand(MavlinkCommand command) : command(command) {}
+    MavlinkCommand command;
+    MavlinkCommandCallback callback;
+    QTimer* deadline = nullptr;
+    QElapsedTimer first_sent;
+    // the target answered MAV_RESULT_IN_PROGRESS, it must not be sent again
+    bool in_progress = false;
+};
+
+
 class MavlinkBase: public QObject {
     Q_OBJECT
 
@@ -91,6 +107,12 @@ public:
 
     Q_INVOKABLE void fetchParameters();
 
+    Q_PROPERTY(qint64 parameter_download_ms MEMBER m_parameter_download_ms WRITE set_parameter_download_ms NOTIFY parameter_download_ms_changed)
+    void set_parameter_download_ms(qint64 parameter_download_ms);
+
+    Q_PROPERTY(int parameter_retries MEMBER m_parameter_retries WRITE set_parameter_retries NOTIFY parameter_retries_changed)
+    void set_parameter_retries(int parameter_retries);
+
     void sendHeartbeat();
 
 
@@ -99,6 +121,25 @@ public:
 
     Q_INVOKABLE void setGroundIP(QString address);
 
+    // time from first sending the most recently acknowledged command to its ACK, including retries
+    Q_PROPERTY(qint64 command_latency_ms MEMBER m_command_latency_ms WRITE set_command_latency_ms NOTIFY command_latency_ms_changed)
+    void set_command_latency_ms(qint64 command_latency_ms);
+
+    Q_PROPERTY(int command_retries MEMBER m_command_retries WRITE set_command_retries NOTIFY command_retries_changed)
+    void set_command_retries(int command_retries);
+
+    Q_PROPERTY(int commands_pending MEMBER m_commands_pending WRITE set_commands_pending NOTIFY commands_pending_changed)
+    void set_commands_pending(int commands_pending);
+
+    quint16 get_local_port() const;
+
+    /*
+     * While a replay runs, live data is only forwarded to the GCS endpoints and is otherwise
+     * ignored, and nothing the replayed state would trigger (heartbeats, rate requests,
+     * parameter downloads, commands) goes out. Safe to call from any thread.
+     */
+    void setReplaying(bool replaying);
+
 signals:
     void last_heartbeat_changed(qint64 last_heartbeat);
     void setup();
@@ -106,17 +147,28 @@ signals:
 
     void allParametersChanged();
 
+    void parameter_download_ms_changed(qint64 parameter_download_ms);
+    void parameter_retries_changed(int parameter_retries);
+
     void loadingChanged(bool loading);
     void savingChanged(bool saving);
 
     void commandDone();
     void commandFailed();
+    void commandCompleted(int command_id, bool success, qint64 latency_ms, int retries);
+
+    void command_latency_ms_changed(qint64 command_latency_ms);
+    void command_retries_changed(int command_retries);
+    void commands_pending_changed(int commands_pending);
 
     void bindError();
 
 public slots:
     void onStarted();
 
+    // decodes previously recorded data, without recording, forwarding or sending anything
+    void replayData(QByteArray data);
+
 protected slots:
     void processMavlinkUDPDatagrams();
     void processMavlinkTCPData();
@@ -127,22 +179,48 @@ protected slots:
 
 protected:
     void stateLoop();
-    void commandStateLoop();
     bool isConnectionLost();
     void resetParamVars();
+    void finishParameterDownload();
+    void requestParameterHash();
+    void requestMissingParameters();
+    void processParameterValue(const mavlink_message_t &msg);
+    QString parameterCachePath(uint32_t hash);
+    bool loadParameterCache(uint32_t hash);
+    void saveParameterCache(uint32_t hash);
     void processData(QByteArray data);
+    void parseData(const QByteArray &data);
+    // our own traffic to the vehicle, dropped while replaying
     void sendData(char* data, int len);
-    void send_command(MavlinkCommand command);
+    // sent no matter what, for what comes from the pilot or other ground control software
+    void writeData(char* data, int len);
+    void send_command(MavlinkCommand command, MavlinkCommandCallback callback = nullptr);
+    void transmitCommand(MavlinkPendingCommand* pending);
+    void onCommandDeadline(quint32 key);
+    void processCommandAck(const mavlink_message_t &msg);
+    void completeCommand(quint32 key, bool success, uint8_t result);
+    static quint32 commandKey(uint8_t target_system, uint8_t target_component, uint16_t command_id);
 
     void reconnectTCP();
 
     QVariantMap m_allParameters;
 
     MavlinkState state = MavlinkStateDisconnected;
-    MavlinkCommandState m_command_state = MavlinkCommandStateReady;
 
     uint16_t parameterCount = 0;
-    uint16_t parameterIndex = 0;
+
+    // one bit per parameter index, set once that index has been received
+    QBitArray m_parameter_received;
+    int m_parameter_received_count = 0;
+
+    // from the target's HEARTBEAT, only PX4 answers a _HASH_CHECK request
+    uint8_t m_autopilot = MAV_AUTOPILOT_INVALID;
+    bool m_parameter_hash_received = false;
+    uint32_t m_parameter_hash = 0;
+
+    QElapsedTimer m_parameter_download_time;
+    qint64 m_parameter_download_ms = 0;
+    int m_parameter_retries = 0;
 
     qint64 parameterLastReceivedTime;
 
@@ -162,6 +240,7 @@ protected:
     quint16 groundTCPPort = 5761;
 
     std::atomic<bool> m_ground_available;
+    std::atomic<bool> m_replaying { false };
     MavlinkType m_mavlink_type;
     QAbstractSocket *mavlinkSocket = nullptr;
 
@@ -174,14 +253,22 @@ protected:
     QTimer* timer = nullptr;
     QTimer* m_heartbeat_timer = nullptr;
 
-    QTimer* m_command_timer = nullptr;
     QTimer* tcpReconnectTimer = nullptr;
 
     uint64_t m_last_boot = 0;
 
-    uint64_t m_command_sent_timestamp = 0;
+    static const int CommandAckTimeout = 200;
+    static const int CommandProgressTimeout = 3000;
+    static const int CommandMaxRetries = 5;
+
+    QHash<quint32, std::shared_ptr<MavlinkPendingCommand>> m_pending_commands;
+
+    // optional, forwards everything received to other ground control software
+    MavlinkRouter* m_router = nullptr;
 
-    std::shared_ptr<MavlinkCommand> m_current_command;
+    qint64 m_command_latency_ms = 0;
+    int m_command_retries = 0;
+    int m_commands_pending = 0;
 };
 
 #endif
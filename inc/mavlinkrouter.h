@@ -0,0 +1,99 @@
+#ifndef MAVLINKROUTER_H
+#define MAVLINKROUTER_H
+
+#include <QObject>
+#include <QtQuick>
+#include <QHostAddress>
+#include <QHostInfo>
+
+class QAbstractSocket;
+
+
+typedef enum MavlinkEndpointType {
+    MavlinkEndpointTypeUDP,
+    MavlinkEndpointTypeTCP
+} MavlinkEndpointType;
+
+
+class MavlinkEndpoint {
+public:
+    MavlinkEndpointType type;
+    QString host;
+    QHostAddress address;
+    quint16 port = 0;
+    QAbstractSocket* socket = nullptr;
+
+    // QHostInfo lookup still running for a UDP endpoint given by name, -1 when there's none
+    int lookup_id = -1;
+    // why nothing is being sent to the endpoint, empty while it's fine
+    QString error;
+
+    quint64 forwarded = 0;
+    quint64 dropped = 0;
+    quint64 received = 0;
+};
+
+
+/*
+ * Forwards the raw MAVLink data a MavlinkBase receives to other ground control software,
+ * so something like QGroundControl or a logger can run alongside QOpenHD without a separate
+ * mavlink-router process.
+ *
+ * Endpoints are configured as a comma separated list, for example
+ * "udp:192.168.2.10:14550,tcp:127.0.0.1:5760". Host names work too, a UDP endpoint given by a
+ * name is resolved when it's set and skipped until then. If that fails it stays in the stats
+ * with the error rather than counting everything sent to it as dropped.
+ *
+ * Data is queued with forward() and sent to every endpoint by flush(), which the owner calls
+ * after each batch it reads from its own socket. On Linux all queued datagrams for a UDP
+ * endpoint go out in a single sendmmsg() call.
+ *
+ * Nothing is ever buffered on our side: if an endpoint can't keep up (a full socket buffer for
+ * UDP, or too much unsent data for TCP) the data is dropped and counted for that endpoint.
+ *
+ * Anything the endpoints send back is emitted with dataFromEndpoint() so the owner can send
+ * it on to the vehicle.
+ */
+class MavlinkRouter: public QObject {
+    Q_OBJECT
+
+public:
+    explicit MavlinkRouter(QObject *parent = nullptr);
+    ~MavlinkRouter();
+
+    void setEndpoints(QString endpoints);
+
+    bool hasEndpoints() const {
+        return !m_endpoints.isEmpty();
+    }
+
+    void forward(const QByteArray &data);
+    void flush();
+
+    Q_PROPERTY(QVariantList endpoint_stats MEMBER m_endpoint_stats NOTIFY endpoint_stats_changed)
+
+signals:
+    void dataFromEndpoint(QByteArray data);
+    void endpoint_stats_changed(QVariantList endpoint_stats);
+
+private slots:
+    void reconnectTCP();
+    void updateStats();
+    void hostLookedUp(QHostInfo info);
+
+private:
+    void clearEndpoints();
+    void readEndpoint(MavlinkEndpoint* endpoint);
+    void sendUDP(MavlinkEndpoint* endpoint);
+    void sendTCP(MavlinkEndpoint* endpoint);
+
+    QList<MavlinkEndpoint*> m_endpoints;
+    QVector<QByteArray> m_queue;
+
+    QTimer* m_reconnect_timer = nullptr;
+    QTimer* m_stats_timer = nullptr;
+
+    QVariantList m_endpoint_stats;
+};
+
+#endif
@@ -11,6 +11,7 @@
 #include "util.h"
 
 #include "mavlinkbase.h"
+#include "telemetrystate.h"
 
 
 class QUdpSocket;
@@ -24,11 +25,65 @@ public:
     explicit MavlinkTelemetry(QObject *parent = nullptr);
     static MavlinkTelemetry* instance();
 
+    TelemetryPublisher* telemetryPublisher();
+
+    Q_INVOKABLE void setForwardEndpoints(QString endpoints);
+
+    /*
+     * RC_CHANNELS_OVERRIDE to the flight controller. Channels past count are left alone, ones
+     * within it without a bit in mapped are released to the flight controller's receiver.
+     * Called on mavlinkThread, RCSender queues it here.
+     */
+    void sendRCOverride(const uint16_t* channels, int count, uint32_t mapped);
+
+    Q_PROPERTY(QVariantList forward_stats MEMBER m_forward_stats WRITE set_forward_stats NOTIFY forward_stats_changed)
+    void set_forward_stats(QVariantList forward_stats);
+
+signals:
+    void forward_stats_changed(QVariantList forward_stats);
+
+    // a live HEARTBEAT from the flight controller, replayed ones don't count
+    void heartbeat_received();
+
 public slots:
     void onSetup();
 
 private slots:
     void onProcessMavlinkMessage(mavlink_message_t msg);
+
+    void onRatesChanged();
+
+private:
+    void applyRates();
+    void sendNextRateCommand();
+    float desiredInterval(double rate) const;
+    bool rateRequested(uint32_t message_id, float interval) const;
+
+    // how long to let subscriptions settle, and how long to wait before asking again after a failure
+    static const int RatesSettleMs = 500;
+    static const int RatesRetryMs = 5000;
+
+    // message id -> SET_MESSAGE_INTERVAL interval in us the flight controller has acknowledged
+    QMap<uint32_t, float> m_applied_intervals;
+    QList<MavlinkCommand> m_rate_commands;
+    MavlinkCommand m_rate_command { MavlinkCommandTypeLong };
+    bool m_rates_applied = false;
+    bool m_rate_command_pending = false;
+    bool m_rates_failed = false;
+    // bumped when the flight controller reboots, so an answer to a request sent before is ignored
+    int m_rates_generation = 0;
+    QTimer* m_rates_timer = nullptr;
+
+    QVariantList m_forward_stats;
+
+    // read once, RC overrides go out at the RC rate
+    int m_rc_sysid = -1;
+
+    /*
+     * Written only from mavlinkThread, OpenHD picks up the published snapshot on the GUI
+     * thread once per frame instead of receiving a queued property update per field.
+     */
+    TelemetryPublisher m_telemetry;
 };
 
 #endif
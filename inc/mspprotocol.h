@@ -0,0 +1,170 @@
+#ifndef MSPPROTOCOL_H
+#define MSPPROTOCOL_H
+
+#include <stdint.h>
+
+#include "telemetryframing.h"
+
+
+/*
+ * MultiWii Serial Protocol as spoken by Betaflight and INAV, both the v1 ("$M") and v2 ("$X")
+ * framing.
+ *
+ * Unlike the protocols in telemetryframing.h, MSP frames carry their own length, so it has its
+ * own parser. Payloads longer than MaxPayload are dropped as soon as the size is read, none of
+ * the messages we decode come close, so a corrupted size can't make the parser wait for data
+ * that's never coming.
+ *
+ * The payload classes decode the fixed layout of each message with a FrameReader, nothing is
+ * allocated.
+ */
+
+
+typedef enum MSPCommand {
+    MSPCommandStatus   = 101,
+    MSPCommandRawGPS   = 106,
+    MSPCommandAttitude = 108,
+    MSPCommandAltitude = 109,
+    MSPCommandAnalog   = 110
+} MSPCommand;
+
+
+class MSPStatus {
+public:
+    bool decode(FrameReader payload);
+
+    // the ARM box is always the first flight mode flag
+    bool armed() const { return flight_mode_flags & 0x1; }
+
+    uint16_t cycle_time = 0;
+    uint16_t i2c_errors = 0;
+    uint16_t sensors = 0;
+    uint32_t flight_mode_flags = 0;
+    uint8_t profile = 0;
+};
+
+
+class MSPRawGPS {
+public:
+    bool decode(FrameReader payload);
+
+    uint8_t fix = 0;
+    uint8_t satellites = 0;
+    // degrees * 10,000,000
+    int32_t lat = 0;
+    int32_t lon = 0;
+    // meters
+    int16_t altitude = 0;
+    // cm/s
+    uint16_t ground_speed = 0;
+    // degrees * 10
+    uint16_t ground_course = 0;
+    // hdop * 100, only sent by newer firmware
+    bool has_hdop = false;
+    uint16_t hdop = 0;
+};
+
+
+class MSPAttitude {
+public:
+    bool decode(FrameReader payload);
+
+    // degrees * 10
+    int16_t roll = 0;
+    int16_t pitch = 0;
+    // degrees
+    int16_t yaw = 0;
+};
+
+
+class MSPAltitude {
+public:
+    bool decode(FrameReader payload);
+
+    // cm
+    int32_t altitude = 0;
+    // cm/s
+    int16_t vario = 0;
+};
+
+
+class MSPAnalog {
+public:
+    bool decode(FrameReader payload);
+
+    // volts * 10
+    uint8_t vbat = 0;
+    uint16_t mah_drawn = 0;
+    // 0-1023
+    uint16_t rssi = 0;
+    // amps * 100
+    int16_t amperage = 0;
+    // volts * 100, only sent by newer firmware and more precise than vbat
+    bool has_voltage = false;
+    uint16_t voltage = 0;
+};
+
+
+typedef enum MSPParserState {
+    MSPParserStateIdle,
+    MSPParserStateHeader,
+    MSPParserStateDirection,
+    MSPParserStateV1Size,
+    MSPParserStateV1Command,
+    MSPParserStateV2Flag,
+    MSPParserStateV2CommandLow,
+    MSPParserStateV2CommandHigh,
+    MSPParserStateV2SizeLow,
+    MSPParserStateV2SizeHigh,
+    MSPParserStatePayload,
+    MSPParserStateChecksum
+} MSPParserState;
+
+
+class MSPParser {
+public:
+    static const int MaxPayload = 255;
+
+    /*
+     * Feed one byte from the stream. Returns true when it completed a response with a valid
+     * checksum, which can then be read with command() and payload() until the next call.
+     * Error responses ("!" instead of ">") are counted and dropped.
+     */
+    bool push(uint8_t byte);
+
+    void reset();
+
+    uint16_t command() const { return m_command; }
+    int version() const { return m_version; }
+    FrameReader payload() const { return FrameReader(m_payload, m_size); }
+
+    MSPParserState state() const { return m_state; }
+    const FramerStats& stats() const { return m_stats; }
+
+private:
+    void checksum(uint8_t byte);
+
+    FramerStats m_stats;
+
+    MSPParserState m_state = MSPParserStateIdle;
+    int m_version = 1;
+    bool m_error = false;
+
+    uint16_t m_command = 0;
+    uint8_t m_flag = 0;
+    int m_size = 0;
+    int m_received = 0;
+    uint8_t m_checksum = 0;
+    uint8_t m_payload[MaxPayload];
+};
+
+
+static const int MSPMaxRequestSize = 9;
+
+/*
+ * Writes a request for command with no payload, v1 framing when the command fits in a byte and
+ * v2 otherwise. Returns the number of bytes written, buffer needs room for MSPMaxRequestSize.
+ */
+int mspEncodeRequest(uint8_t* buffer, uint16_t command);
+
+#endif // MSPPROTOCOL_H
@@ -5,15 +5,37 @@
 #include <QtQuick>
 
 #include "constants.h"
-
+#include "ingestreactor.h"
+#include "mspprotocol.h"
+#include "telemetrystate.h"
 
 class QUdpSocket;
 
-class MSPTelemetry: public QObject {
+
+class MSPRequest {
+public:
+    uint16_t command = 0;
+    // 0 when nobody needs it
+    qint64 interval_ms = 0;
+    qint64 next_ms = 0;
+};
+
+
+/*
+ * MSP is polled, the flight controller only answers what it's asked for. Requests are only
+ * sent for the messages the visible widgets subscribed to through TelemetrySubscriptions, at
+ * the rate they asked for (capped by the msp_max_rate setting), plus MSP_STATUS once a second
+ * for the arming state. Everything due in a cycle goes out in a single uplink datagram.
+ */
+class MSPTelemetry: public QObject, public IngestHandler {
     Q_OBJECT
 
 public:
-    explicit MSPTelemetry(QObject *parent = nullptr);
+    explicit MSPTelemetry(quint16 port, QObject *parent = nullptr);
+    ~MSPTelemetry();
+
+    void ingestDatagram(const uint8_t* data, int size) override;
+    void ingestFinished() override;
 
 
     Q_PROPERTY(QString last_heartbeat MEMBER m_last_heartbeat WRITE set_last_heartbeat NOTIFY last_heartbeat_changed)
@@ -22,14 +44,27 @@ public:
 signals:
     void last_heartbeat_changed(QString last_heartbeat);
 
+public slots:
+    void setGroundIP(QString address);
 
 private slots:
-    void processMSPDatagrams();
+    void updateRates();
+    void sendRequests();
 
 private:
-    void processMSPMessage();
+    void processMSPMessage(uint16_t command, FrameReader payload);
+
+    MSPParser m_parser;
+    TelemetryPublisher m_telemetry;
+    quint16 m_port;
+
+    QUdpSocket* m_uplink_socket = nullptr;
+    QString m_ground_address = "127.0.0.1";
+    quint16 m_uplink_port = 0;
 
-    QUdpSocket *mspSocket = nullptr;
+    QVector<MSPRequest> m_requests;
+    QTimer* m_request_timer = nullptr;
+    QElapsedTimer m_clock;
 
     QString m_last_heartbeat = "N/A";
     qint64 last_heartbeat_timestamp;
@@ -9,7 +9,11 @@
 #include <QtTextToSpeech/QTextToSpeech>
 #endif
 
-class OpenHD : public QObject
+#include <atomic>
+
+#include "telemetrystate.h"
+
+class OpenHD : public QObject, public TelemetryListener
 {
     Q_OBJECT
 
@@ -21,13 +25,6 @@ public:
     void calculate_home_distance();
     void calculate_home_course();
 
-    void setWifiAdapter0(uint32_t received_packet_cnt, int8_t current_signal_dbm, int8_t signal_good);
-    void setWifiAdapter1(uint32_t received_packet_cnt, int8_t current_signal_dbm, int8_t signal_good);
-    void setWifiAdapter2(uint32_t received_packet_cnt, int8_t current_signal_dbm, int8_t signal_good);
-    void setWifiAdapter3(uint32_t received_packet_cnt, int8_t current_signal_dbm, int8_t signal_good);
-    void setWifiAdapter4(uint32_t received_packet_cnt, int8_t current_signal_dbm, int8_t signal_good);
-    void setWifiAdapter5(uint32_t received_packet_cnt, int8_t current_signal_dbm, int8_t signal_good);
-
     Q_INVOKABLE void setGroundGPIO(int pin, bool state) {
         m_ground_gpio[pin] = state ? 1 : 0;
         emit save_ground_gpio(m_ground_gpio);
@@ -48,6 +45,18 @@ public:
     void updateLateralSpeed();
     void updateWind();
 
+    /* telemetry sources that run on another thread hand their state over through a
+       TelemetryPublisher, which is applied to the properties below by syncTelemetry() */
+    void registerTelemetryPublisher(TelemetryPublisher* publisher);
+    void unregisterTelemetryPublisher(TelemetryPublisher* publisher);
+
+    /* called on the publishing thread, emits telemetry_published() once until the next
+       syncTelemetry() so a burst of snapshots only asks for one frame */
+    void telemetryPublished() override;
+
+    // total time spent in syncTelemetry(), can be read from any thread
+    quint64 telemetrySyncNsecs() const;
+
     Q_PROPERTY(QString gstreamer_version READ get_gstreamer_version NOTIFY gstreamer_version_changed)
     QString get_gstreamer_version();
 
@@ -340,6 +349,9 @@ public:
     void setRCChannel8(int rcChannel8);
 
 signals:
+    // a publisher has a snapshot waiting for syncTelemetry(), emitted from the publisher's thread
+    void telemetry_published();
+
     // system
     void gstreamer_version_changed();
     void qt_version_changed();
@@ -350,13 +362,6 @@ signals:
     void ground_gpio_busy_changed(bool ground_gpio_busy);
     void air_gpio_busy_changed(bool air_gpio_busy);
 
-    void wifiAdapter0Changed(unsigned int received_packet_cnt, int current_signal_dbm, int signal_good);
-    void wifiAdapter1Changed(unsigned int received_packet_cnt, int current_signal_dbm, int signal_good);
-    void wifiAdapter2Changed(unsigned int received_packet_cnt, int current_signal_dbm, int signal_good);
-    void wifiAdapter3Changed(unsigned int received_packet_cnt, int current_signal_dbm, int signal_good);
-    void wifiAdapter4Changed(unsigned int received_packet_cnt, int current_signal_dbm, int signal_good);
-    void wifiAdapter5Changed(unsigned int received_packet_cnt, int current_signal_dbm, int signal_good);
-
 
     // mavlink
     void boot_time_changed(int boot_time);
@@ -478,11 +483,26 @@ signals:
     void rcChannel7Changed(int rcChanne7);
     void rcChannel8Changed(int rcChanne8);
 
+public slots:
+    /* called once per frame from the GUI thread, right before the scene is rendered */
+    void syncTelemetry();
+
 private:
+    void applyTelemetry(const TelemetryState &state);
+
 #if defined(ENABLE_SPEECH)
     QTextToSpeech *m_speech;
 #endif
 
+    struct TelemetrySource {
+        TelemetryPublisher* publisher;
+        uint32_t position_seq;
+        uint32_t battery_seq;
+    };
+    QList<TelemetrySource> m_telemetry_sources;
+    std::atomic<quint64> m_telemetry_sync_nsecs { 0 };
+    std::atomic<bool> m_telemetry_pending { false };
+
 
     // mavlink
     int m_boot_time = 0;
@@ -15,7 +15,7 @@
 #include <QJoysticks.h>
 #endif
 
-class QUdpSocket;
+#include "rcmapper.h"
 
 class OpenHDRC: public QObject {
     Q_OBJECT
@@ -25,6 +25,11 @@ public:
 
     Q_INVOKABLE void setGroundIP(QString address);
 
+    // rebuilds the channel mapping and curves after the rc_ settings were changed
+    Q_INVOKABLE void reloadMapping();
+
+    Q_PROPERTY(bool enable_rc MEMBER m_enable_rc WRITE set_enable_rc NOTIFY enable_rc_changed)
+    void set_enable_rc(bool enable_rc);
 
 #if defined(ENABLE_GAMEPADS)
     Q_PROPERTY(int connectedGamepad MEMBER m_selectedGamepad WRITE set_selectedGamepad NOTIFY selectedGamepadChanged)
@@ -96,6 +101,8 @@ signals:
     void rc9_changed(uint rc9);
     void rc10_changed(uint rc10);
 
+    void enable_rc_changed(bool enable_rc);
+
 #if defined(ENABLE_GAMEPADS)
     void selectedGamepadChanged(int selectedGamepad);
     void selectedGamepadNameChanged(QString selectedGamepadName);
@@ -108,7 +115,6 @@ signals:
 
 
 private slots:
-    void channelTrigger();
 #if defined(ENABLE_GAMEPADS)
     void connectedGamepadsChanged();
     void nameChanged(QString name);
@@ -117,9 +123,8 @@ private slots:
 #if defined(ENABLE_JOYSTICKS)
     void connectedJoysticksChanged();
 #endif
-    void processRCDatagrams();
-
     void axisChanged (const int js, const int axis, const qreal value);
+    void buttonChanged (const int js, const int button, const bool pressed);
 
     void connectedChanged(bool value);
     void axisLeftXChanged(double value);
@@ -146,9 +151,19 @@ private slots:
     void buttonGuideChanged(bool value);
 
 private:
-    QUdpSocket *rcSocket = nullptr;
+    // hands the current channels to RCSender, which sends them on its own thread
+    void publishChannels();
+
+    void setChannel(int channel, uint16_t value);
+    void mapAxis(int axis, double value);
+    void mapButton(int button, bool pressed);
 
-    QString groundAddress;
+    RCMapper m_mapper;
+
+    // all 16 channels, rc1-rc10 mirror the first 10 for QML
+    RCChannels m_channels;
+
+    bool m_enable_rc = false;
 
 #if defined(ENABLE_GAMEPADS)
     QList<int> m_connectedGamepads;
@@ -169,8 +184,6 @@ private:
     QTextToSpeech *m_speech;
 #endif
 
-    uint8_t  seqno = 0;
-
     uint m_rc1 = 1500;
     uint m_rc2 = 1500;
     uint m_rc3 = 1500;
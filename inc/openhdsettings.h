@@ -58,28 +58,43 @@ private:
     void init();
     void _saveSettings(QVariantMap remoteSettings);
 
+    void requestAllSettings();
+    void finishLoading(bool complete);
+
+    static QByteArray settingsHash(const QVariantMap &settings);
+    QString settingsCachePath();
+    bool loadSettingsCache();
+    void saveSettingsCache();
+
     QUdpSocket *settingSocket = nullptr;
 
     bool m_ground_available = false;
 
     QVariantMap m_allSettings;
+    QByteArray m_settingsHash;
 
-    qint64 loadStart = 0;
+    /*
+     * What the ground has sent during the current fetch, starting from a copy of the cache for
+     * a delta request or empty for a full one. It only replaces m_allSettings once ConfigEnd
+     * arrives.
+     */
+    QVariantMap m_incomingSettings;
+    bool m_fetching = false;
+    bool m_deltaRequest = false;
+    bool m_deltaAnswered = false;
 
-    qint64 saveStart = 0;
+    // settings handed to SettingsSender, merged into the snapshot once the ground has them
+    QVariantMap m_savingSettings;
+
+    qint64 loadStart = 0;
+    qint64 lastReceived = 0;
 
     QTimer loadTimer;
-    QTimer saveTimer;
 
     void checkSettingsLoadTimeout();
-    void checkSettingsSaveTimeout();
 
     QTimer savedTimer;
 
-    /* used to keep track of how many settings need to be saved so we can compare it to
-       the number of save confirmations we get back from the ground side */
-    int settingsCount = 0;
-
     bool m_loading = false;
     bool m_saving = false;
 
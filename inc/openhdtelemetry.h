@@ -4,18 +4,26 @@
 #include <QObject>
 #include <QtQuick>
 
-#include "wifibroadcast.h"
+#include <atomic>
+
+#include "wifibroadcaststatus.h"
 #include "constants.h"
+#include "ingestreactor.h"
 
-class QUdpSocket;
 
-class OpenHDTelemetry: public QObject {
+class OpenHDTelemetry: public QObject, public IngestHandler {
     Q_OBJECT
 
 public:
     explicit OpenHDTelemetry(QObject *parent = nullptr);
     static OpenHDTelemetry* instance();
 
+    void ingestDatagram(const uint8_t* data, int size) override;
+    void ingestFinished() override;
+
+    // live status is ignored while a replay runs, safe to call from any thread
+    void setReplaying(bool replaying);
+
 
     Q_PROPERTY(qint64 last_heartbeat MEMBER m_last_heartbeat WRITE set_last_heartbeat NOTIFY last_heartbeat_changed)
     void set_last_heartbeat(qint64 last_heartbeat);
@@ -26,14 +34,20 @@ signals:
 public slots:
     void onStarted();
 
-private slots:
-    void processDatagrams();
+    // decodes a previously recorded status datagram, without recording it
+    void replayDatagram(QByteArray datagram);
 
-    void processOpenHDTelemetry(wifibroadcast_rx_status_forward_t telemetry);
+private slots:
+    void processOpenHDTelemetry(const WifibroadcastStatus &telemetry);
 private:
     void stateLoop();
 
-    QUdpSocket *telemetrySocket = nullptr;
+    quint16 m_port = 0;
+
+    // decoded on the ingest thread, handed to the GUI thread together once per batch
+    QVector<WifibroadcastStatus> m_ingested;
+
+    std::atomic<bool> m_replaying { false };
 
     QTimer* timer = nullptr;
 
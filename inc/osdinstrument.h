@@ -0,0 +1,101 @@
+#ifndef OSDINSTRUMENT_H
+#define OSDINSTRUMENT_H
+
+#include <QColor>
+#include <QFont>
+#include <QHash>
+#include <QQuickItem>
+#include <QSGGeometryNode>
+#include <QVector>
+
+
+class QSGTexture;
+
+
+/*
+ * Root of an instrument's scene graph subtree, kept across frames.
+ *
+ * Every filled shape in the instrument's color goes into a single geometry node, so the whole
+ * ladder is one draw call whose vertex buffer is rewritten when the value moves. Labels are
+ * textured quads, each distinct string is rasterised once and the texture kept here, so moving
+ * the ladder only moves quads around.
+ */
+class OSDInstrumentNode: public QSGNode {
+public:
+    OSDInstrumentNode();
+    ~OSDInstrumentNode() override;
+
+    typedef struct Label {
+        QSGTexture* texture;
+        QSizeF size;
+        qreal ascent;
+    } Label;
+
+    // labels are cached by text, font and color, past this many the cache starts over
+    static const int MaxCachedLabels = 256;
+
+    QSGGeometryNode* shapes;
+    QSGNode* labels;
+
+    QHash<QString, Label> label_cache;
+    int labels_used = 0;
+};
+
+
+/*
+ * Base for the OSD instruments that used to be drawn with a QML Canvas.
+ *
+ * A Canvas paints in software on the GUI thread and uploads a new texture for every change,
+ * at attitude rates that was most of the ground station's CPU. These build their nodes once
+ * in updatePaintNode() and afterwards only rewrite vertices, move label quads or change a
+ * transform, on the render thread.
+ *
+ * Subclasses fill m_vertices with appendRect() and friends, then place labels between
+ * beginLabels() and endLabels().
+ */
+class OSDInstrument: public QQuickItem {
+    Q_OBJECT
+
+public:
+    explicit OSDInstrument(QQuickItem *parent = nullptr);
+
+    Q_PROPERTY(QColor color MEMBER m_color WRITE set_color NOTIFY color_changed)
+    void set_color(QColor color);
+
+signals:
+    void color_changed(QColor color);
+
+protected:
+    // the layout depends on the size, so a resize redraws
+    void geometryChanged(const QRectF &new_geometry, const QRectF &old_geometry) override;
+
+    // returns old as an OSDInstrumentNode, or a new one with an empty shape node
+    OSDInstrumentNode* instrumentNode(QSGNode* old);
+    // for subclasses of OSDInstrumentNode, adds the shape node
+    void initInstrumentNode(OSDInstrumentNode* node);
+
+    static QSGGeometryNode* createShapeNode(const QColor &color);
+    static void setShapeColor(QSGGeometryNode* node, const QColor &color);
+
+    // copies vertices into node's geometry, two triangles per quad
+    static void commitShapes(QSGGeometryNode* node, const QVector<QSGGeometry::Point2D> &vertices);
+
+    static void appendRect(QVector<QSGGeometry::Point2D> &vertices, float x, float y, float width, float height);
+    static void appendQuad(QVector<QSGGeometry::Point2D> &vertices, QPointF a, QPointF b, QPointF c, QPointF d);
+
+    void beginLabels(OSDInstrumentNode* node);
+    // horizontal alignment is relative to x, with Qt::AlignVCenter baseline is the label's centre
+    void addLabel(OSDInstrumentNode* node, const QString &text, const QFont &font, const QColor &color,
+                  qreal x, qreal baseline, Qt::Alignment alignment);
+    void endLabels(OSDInstrumentNode* node);
+
+    // bold 11px sans-serif, what the canvas ladders used
+    static QFont ladderFont();
+
+    QColor m_color = QColor("white");
+
+    // reused every frame so building the ladder doesn't allocate once it has grown
+    QVector<QSGGeometry::Point2D> m_vertices;
+};
+
+#endif // OSDINSTRUMENT_H
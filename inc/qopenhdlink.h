@@ -5,11 +5,25 @@
 #include <QtQuick>
 
 #include "constants.h"
+#include "linkprotocol.h"
 #include <lib/json.hpp>
 
 
+class QHostAddress;
 class QUdpSocket;
 
+
+/*
+ * Mirrors widget layout changes between the QOpenHD instances on a network, typically from a
+ * phone or laptop to the ground station display.
+ *
+ * Changes are queued and sent together on the next pass through the event loop, one widget
+ * location per widget however often it moved, so a drag or a layout reset is a single datagram.
+ *
+ * The binary encoding in linkprotocol.h is only used once the other end has said it
+ * understands it: a JSON hello goes out first, which older versions ignore, and newer ones
+ * answer with a binary hello. Until then everything is sent as JSON, one object per change.
+ */
 class QOpenHDLink: public QObject {
     Q_OBJECT
 
@@ -28,15 +42,28 @@ signals:
 
 private slots:
     void readyRead();
+    void flush();
 
 private:
     QString groundAddress = "192.168.2.1";
 
-    void processCommand(QByteArray buffer);
+    void sendHello();
+    void sendRecords(const QVector<LinkRecord> &records, const QHostAddress &address);
+
+    void processCommand(QByteArray buffer, const QHostAddress &sender);
+    void processRecords(const QVector<LinkRecord> &records, const QHostAddress &sender);
     void processSetWidgetLocation(nlohmann::json command);
     void processSetWidgetEnabled(nlohmann::json commandData);
 
     QUdpSocket *linkSocket = nullptr;
+
+    // latest change per widget, in the order widgets were first touched
+    QVector<LinkRecord> m_pending;
+    QTimer m_flushTimer;
+
+    // whether the ground end answered our hello, and when we last asked
+    bool m_binary = false;
+    qint64 m_helloSent = 0;
 };
 
 #endif
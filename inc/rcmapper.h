@@ -0,0 +1,94 @@
+#ifndef RCMAPPER_H
+#define RCMAPPER_H
+
+#include <stdint.h>
+
+#include "rcsender.h"
+
+
+/*
+ * Input numbering shared by gamepads and joysticks. Joystick axes and buttons use the index
+ * the driver reports, gamepad ones are numbered below so that with the default mapping (axis
+ * n to channel n + 1) the sticks drive channels 1-4 the same way they always have, and the
+ * triggers stay unmapped until they're given a channel.
+ */
+typedef enum RCGamepadAxis {
+    RCGamepadAxisRightX = 0,
+    RCGamepadAxisRightY = 1,
+    RCGamepadAxisLeftY  = 2,
+    RCGamepadAxisLeftX  = 3,
+    RCGamepadAxisL2     = 10,
+    RCGamepadAxisR2     = 11
+} RCGamepadAxis;
+
+
+typedef enum RCGamepadButton {
+    RCGamepadButtonA,
+    RCGamepadButtonB,
+    RCGamepadButtonX,
+    RCGamepadButtonY,
+    RCGamepadButtonL1,
+    RCGamepadButtonR1,
+    RCGamepadButtonSelect,
+    RCGamepadButtonStart,
+    RCGamepadButtonL3,
+    RCGamepadButtonR3,
+    RCGamepadButtonUp,
+    RCGamepadButtonDown,
+    RCGamepadButtonLeft,
+    RCGamepadButtonRight,
+    RCGamepadButtonCenter,
+    RCGamepadButtonGuide
+} RCGamepadButton;
+
+
+/*
+ * Turns axis and button events into channel values.
+ *
+ * Every channel's curve (expo, rate, trim and reverse) is baked into a lookup table when the
+ * mapping is loaded, so handling an event is scaling the axis to a table index and one load.
+ *
+ * Settings, channels numbered from 1 and 0 meaning unmapped:
+ *
+ *   rc_axis<n>_channel      channel axis n drives, default n + 1 for the first 10 axes
+ *   rc_button<n>_channel    channel button n drives, the channel's full deflection one way
+ *                           released and the other way pressed, so with the default rate and
+ *                           trim 1000 and 2000
+ *   rc_channel<n>_expo      0-100, how much of the cubic curve is blended in
+ *   rc_channel<n>_rate      percent of full deflection, default 100
+ *   rc_channel<n>_trim      offset in microseconds
+ *   rc_channel<n>_reverse   inverts the input
+ *
+ * Output is clamped to 1000-2000.
+ */
+class RCMapper {
+public:
+    static const int MaxAxes = 16;
+    static const int MaxButtons = 32;
+
+    // odd so the centre of the stick lands exactly on a table entry
+    static const int TableSize = 1025;
+
+    RCMapper();
+
+    // reads the settings and rebuilds the tables, GUI thread only
+    void load();
+
+    // value is -1 to 1, returns false when the input isn't mapped to a channel
+    bool mapAxis(int axis, double value, int &channel, uint16_t &output) const;
+    bool mapButton(int button, bool pressed, int &channel, uint16_t &output) const;
+
+    // one bit per channel, set when at least one axis or button drives it
+    uint32_t mappedChannels() const {
+        return m_mapped;
+    }
+
+private:
+    int8_t m_axis_channel[MaxAxes];
+    int8_t m_button_channel[MaxButtons];
+    uint32_t m_mapped = 0;
+
+    uint16_t m_table[RCChannelCount][TableSize];
+};
+
+#endif // RCMAPPER_H
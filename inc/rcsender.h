@@ -0,0 +1,195 @@
+#ifndef RCSENDER_H
+#define RCSENDER_H
+
+#include <QObject>
+#include <QtQuick>
+
+#include <atomic>
+
+#include "triplebuffer.h"
+
+#if defined(__rasp_pi__) || defined(__desktoplinux__)
+#define RC_SENDER_REALTIME
+#endif
+
+class QUdpSocket;
+
+
+static const int RCChannelCount = 16;
+
+typedef enum RCOutput {
+    // the wifibroadcast RC frame to the ground station
+    RCOutputWifibroadcast,
+    // RC_CHANNELS_OVERRIDE to the flight controller over the MAVLink telemetry link
+    RCOutputMavlink
+} RCOutput;
+
+
+typedef struct RCChannels {
+    uint16_t channels[RCChannelCount] = { 1500, 1500, 1500, 1500, 1500, 1500, 1500, 1500,
+                                          1500, 1500, 1500, 1500, 1500, 1500, 1500, 1500 };
+    // RCSender::clockNs() when the input that produced these values arrived
+    qint64 input_ns = 0;
+    // one bit per channel that has an input mapped to it, see RCMapper::mappedChannels()
+    uint32_t mapped = 0xFFFF;
+} RCChannels;
+
+
+/*
+ * Counts how many microseconds something took in fixed buckets, used for how late each RC
+ * packet went out compared to its slot and for how long an input took to reach the socket.
+ * Recording is a couple of relaxed atomic adds and any thread can read it.
+ */
+class JitterHistogram {
+public:
+    static const int BucketCount = 10;
+
+    // upper bound of each bucket in microseconds, the last one catches everything else
+    static const qint64 BucketLimits[BucketCount];
+
+    void record(qint64 lateness_us);
+
+    quint64 count(int bucket) const {
+        return m_counts[bucket].load(std::memory_order_relaxed);
+    }
+    quint64 total() const {
+        return m_total.load(std::memory_order_relaxed);
+    }
+    qint64 max() const {
+        return m_max.load(std::memory_order_relaxed);
+    }
+
+    // upper bound of the bucket the percentile falls in, so it never understates the jitter
+    qint64 percentile(double fraction) const;
+
+private:
+    std::atomic<quint64> m_counts[BucketCount] {};
+    std::atomic<quint64> m_total { 0 };
+    std::atomic<qint64> m_max { 0 };
+};
+
+
+/*
+ * Sends the RC channels to the ground station at a fixed cadence on its own thread, so
+ * nothing happening on the GUI thread can delay a control packet.
+ *
+ * On the Pi and desktop Linux the thread sleeps with clock_nanosleep() until the absolute
+ * time of the next slot, so the cadence doesn't drift with however long sending took, and
+ * runs with SCHED_FIFO when the rc_realtime_priority setting is above 0 (which needs
+ * CAP_SYS_NICE or root). Everywhere else a precise QTimer on the same thread is used.
+ *
+ * OpenHDRC writes the channels into a triple buffer whenever an input changes, each packet
+ * picks up the newest complete set without either side ever waiting on the other.
+ *
+ * With the rc_send_on_change setting the thread is also woken by every input, and sends right
+ * away when a channel moved further than rc_deadband from what was last sent. Otherwise it
+ * only sends a keepalive every rc_keepalive_ms. A token bucket filled at the fixed rate limits
+ * how often it can send, so the average packet rate never goes above the fixed mode's and a
+ * change that finds the bucket empty goes out in the next slot.
+ *
+ * Every packet's input_ns is compared with the time the socket write returned, that latency
+ * is recorded once per input.
+ *
+ * The rc_output setting picks where the channels go: "wifibroadcast" sends the RC frame to
+ * the ground station, 8 channels (21 bytes) or with rc_channel_count 16 all of them (37 bytes,
+ * with the is16 flag set), "mavlink" sends RC_CHANNELS_OVERRIDE through MavlinkTelemetry
+ * instead, for the same number of channels. Channels nothing is mapped to are released
+ * there, so the flight controller goes back to its own receiver for them, and the ones past
+ * the count are marked as ignored. Both settings are read when the thread starts.
+ */
+class RCSender: public QObject {
+    Q_OBJECT
+
+public:
+    explicit RCSender(QObject *parent = nullptr);
+    ~RCSender();
+
+    static RCSender* instance();
+
+    static const qint64 IntervalNs = 15000000; // about 60Hz
+
+    // packets send-on-change can send back to back before it's held to IntervalNs
+    static const int BurstPackets = 2;
+
+    // monotonic clock the input timestamps and the sender share
+    static qint64 clockNs();
+
+    // called on the GUI thread
+    void setChannels(const RCChannels &channels);
+    void setEnabled(bool enabled);
+    void setGroundIP(QString address);
+
+    // safe to call from any thread
+    Q_INVOKABLE quint64 packetsSent() const {
+        return m_packets.load(std::memory_order_relaxed);
+    }
+    Q_INVOKABLE qint64 jitterPercentileUs(double fraction) const {
+        return m_jitter.percentile(fraction);
+    }
+    Q_INVOKABLE qint64 jitterMaxUs() const {
+        return m_jitter.max();
+    }
+    Q_INVOKABLE qint64 latencyPercentileUs(double fraction) const {
+        return m_latency.percentile(fraction);
+    }
+    Q_INVOKABLE qint64 latencyMaxUs() const {
+        return m_latency.max();
+    }
+
+    // one entry per bucket, { "limit_us": upper bound or -1 for the last, "count": packets }
+    Q_INVOKABLE QVariantList jitterHistogram() const;
+    Q_INVOKABLE QVariantList latencyHistogram() const;
+
+public slots:
+    void onStarted();
+    void onStopped();
+
+private:
+    static QVariantList histogramBuckets(const JitterHistogram &histogram);
+
+    // slot is true when called for a scheduled slot rather than an input
+    void process(qint64 now_ns, bool slot);
+    bool exceedsDeadband(const RCChannels &channels) const;
+    void send();
+    int encodeFrame(uint8_t* packet, const RCChannels &channels);
+
+    TripleBuffer<RCChannels> m_channels;
+    std::atomic<bool> m_enabled { false };
+    std::atomic<quint32> m_ground_address { 0 };
+    std::atomic<bool> m_running { false };
+    std::atomic<bool> m_send_on_change { false };
+
+    std::atomic<quint64> m_packets { 0 };
+    JitterHistogram m_jitter;
+    JitterHistogram m_latency;
+
+    uint8_t m_seqno = 0;
+    RCOutput m_output = RCOutputWifibroadcast;
+    bool m_16_channels = false;
+
+    // send-on-change state, only touched on the sender thread
+    int m_deadband = 5;
+    qint64 m_keepalive_ns = 100000000;
+    double m_tokens = BurstPackets;
+    qint64 m_tokens_ns = 0;
+    qint64 m_last_send_ns = 0;
+    bool m_pending = false;
+    RCChannels m_last_sent;
+    qint64 m_measured_input_ns = 0;
+
+#if defined(RC_SENDER_REALTIME)
+    void run();
+
+    int m_socket = -1;
+    // written by setChannels() to wake the sender in send-on-change mode
+    int m_wakeup = -1;
+#else
+    void tick();
+
+    QUdpSocket* m_socket = nullptr;
+    QTimer* m_timer = nullptr;
+    qint64 m_next_ns = 0;
+#endif
+};
+
+#endif // RCSENDER_H
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstddef>
+
+/*
+ * Fixed capacity ring buffer that overwrites its oldest entry once it's full.
+ *
+ * Storage is allocated once up front, so pushing never allocates no matter how long the
+ * buffer has been running. Entries are indexed from the oldest (0) to the newest (size() - 1).
+ */
+template <typename T, size_t Capacity>
+class RingBuffer {
+public:
+    RingBuffer() {}
+
+    void push(const T &value) {
+        m_values[m_head] = value;
+        m_head = (m_head + 1) % Capacity;
+        if (m_size < Capacity) {
+            m_size++;
+        }
+    }
+
+    void clear() {
+        m_head = 0;
+        m_size = 0;
+    }
+
+    // forgets the oldest count entries, they're overwritten by later pushes
+    void drop_front(size_t count) {
+        m_size = count < m_size ? m_size - count : 0;
+    }
+
+    size_t size() const {
+        return m_size;
+    }
+
+    static constexpr size_t capacity() {
+        return Capacity;
+    }
+
+    bool empty() const {
+        return m_size == 0;
+    }
+
+    const T& at(size_t index) const {
+        return m_values[(m_head + Capacity - m_size + index) % Capacity];
+    }
+
+    T& at(size_t index) {
+        return m_values[(m_head + Capacity - m_size + index) % Capacity];
+    }
+
+    const T& last() const {
+        return at(m_size - 1);
+    }
+
+private:
+    T m_values[Capacity];
+    size_t m_head = 0;
+    size_t m_size = 0;
+};
@@ -0,0 +1,117 @@
+#ifndef SETTINGSSENDER_H
+#define SETTINGSSENDER_H
+
+#include <QObject>
+#include <QtQuick>
+
+class QUdpSocket;
+
+
+typedef enum SettingsProtocol {
+    // nothing has been saved to this ground station yet
+    SettingsProtocolUnknown,
+    SettingsProtocolBatched,
+    // ground images that only understand one RequestChangeSettings per datagram
+    SettingsProtocolLegacy
+} SettingsProtocol;
+
+
+typedef struct SettingsBatch {
+    uint32_t sequence;
+    QByteArray datagram;
+    int keys;
+    int retries;
+    qint64 sent_ms;
+} SettingsBatch;
+
+
+/*
+ * Sends changed ground settings on its own thread, so saving never blocks the UI.
+ *
+ * Settings are packed into as few datagrams as possible, each one
+ *
+ *   RequestSettingsBatch<sequence>\n<key>=<value>\n<key>=<value>...
+ *
+ * and the ground station answers each with "SavedBatch<sequence>" once all of its keys are
+ * written. Every batch goes out at once and unacknowledged batches are retransmitted until
+ * MaxRetries is reached, so a save normally completes in a single round trip.
+ *
+ * Older ground images ignore the batch request. If the first batch sent to a ground station
+ * is never acknowledged it falls back to the old one key per datagram protocol, paced by a
+ * timer instead of sleeping, and completion is counted from the "SavedGround" replies as
+ * before. The ground station may only have been busy booting though, so batches are tried
+ * again on the first save after ReprobeInterval, or on the next save after a late
+ * "SavedBatch" shows up.
+ */
+class SettingsSender: public QObject {
+    Q_OBJECT
+
+public:
+    explicit SettingsSender(QObject *parent = nullptr);
+
+    static SettingsSender* instance();
+
+    // keeps a batch in a single datagram without IP fragmentation
+    static const int MaxBatchSize = 1200;
+
+    static const int AckTimeout = 100;
+    static const int MaxRetries = 5;
+
+    // what the old ground images could keep up with
+    static const int LegacyInterval = 30;
+    static const int LegacyTimeout = 30000;
+
+    // how long to stick with the legacy protocol before trying batches again
+    static const int ReprobeInterval = 60000;
+
+signals:
+    void saveFinished();
+    void saveFailed(qint64 failCount);
+
+public slots:
+    void onStarted();
+
+    void setGroundIP(QString address);
+
+    void save(QVariantMap settings);
+
+    // a "SavedGround" reply arrived on the main settings socket
+    void legacySaved();
+
+private slots:
+    void processDatagrams();
+    void checkBatches();
+    void sendNextLegacy();
+
+private:
+    SettingsBatch newBatch();
+    void send(SettingsBatch &batch);
+    void startLegacy();
+    void finish(int failed);
+
+    QUdpSocket* m_socket = nullptr;
+    QString m_ground_address;
+
+    SettingsProtocol m_protocol = SettingsProtocolUnknown;
+    qint64 m_legacy_since = 0;
+    // the ground station acknowledged a batch after we had already given up on them
+    bool m_reprobe = false;
+
+    QElapsedTimer m_clock;
+
+    bool m_active = false;
+    QVariantMap m_settings;
+
+    uint32_t m_sequence = 0;
+    QList<SettingsBatch> m_pending;
+    QTimer* m_retry_timer = nullptr;
+    // keys in batches that ran out of retries
+    int m_failed = 0;
+
+    QList<QByteArray> m_legacy_queue;
+    int m_legacy_remaining = 0;
+    qint64 m_legacy_start = 0;
+    QTimer* m_legacy_timer = nullptr;
+};
+
+#endif // SETTINGSSENDER_H
@@ -5,31 +5,20 @@
 #include <QtQuick>
 
 #include "constants.h"
+#include "ingestreactor.h"
+#include "telemetryframing.h"
+#include "telemetrystate.h"
 
 
-typedef struct {
-    uint16_t id;
-    union {
-        uint32_t u32;
-        int32_t i32;
-        uint16_t u16;
-        int16_t i16;
-        uint8_t u8;
-        uint8_t b[4];
-        int8_t i8;
-        float f;
-    } data;
-    uint8_t crc;
-} tSPortData;
-
-
-class QUdpSocket;
-
-class SmartportTelemetry: public QObject {
+class SmartportTelemetry: public QObject, public IngestHandler {
     Q_OBJECT
 
 public:
-    explicit SmartportTelemetry(QObject *parent = nullptr);
+    explicit SmartportTelemetry(quint16 port, QObject *parent = nullptr);
+    ~SmartportTelemetry();
+
+    void ingestDatagram(const uint8_t* data, int size) override;
+    void ingestFinished() override;
 
 
     Q_PROPERTY(QString last_heartbeat MEMBER m_last_heartbeat WRITE set_last_heartbeat NOTIFY last_heartbeat_changed)
@@ -39,16 +28,12 @@ signals:
     void last_heartbeat_changed(QString last_heartbeat);
 
 
-private slots:
-    void processSmartportDatagrams();
-
 private:
-    void smartport_read(uint8_t *buf, int buflen);
-    uint8_t u8CheckCrcSPORT(uint8_t *t);
-
-    void processSmartportMessage(uint8_t *b);
+    void processSmartportMessage(FrameReader payload);
 
-    QUdpSocket *smartportSocket = nullptr;
+    TelemetryFramer m_framer;
+    TelemetryPublisher m_telemetry;
+    quint16 m_port;
 
     QString m_last_heartbeat = "N/A";
     qint64 last_heartbeat_timestamp;
@@ -5,6 +5,7 @@
 #include <QtQuick>
 
 #include "mavlinkbase.h"
+#include "ringbuffer.h"
 
 
 // matches struct defined in OpenHDMicroservice::StatusMicroservice
@@ -17,6 +18,19 @@ struct StatusMessage {
 };
 
 
+/*
+ * The most recent Capacity status messages from the air and ground units.
+ *
+ * addMessage() can be called from any thread, messages are queued and inserted into the model
+ * together on the next pass through the GUI thread's event loop, so a unit replaying its whole
+ * log after a reconnect is one row insertion rather than hundreds. Once it's full the oldest
+ * rows are removed as new ones arrive.
+ *
+ * Every message has a sequence number, the row of a message is its distance from the oldest
+ * one. Lists of sequence numbers per severity and per sysid are kept alongside, so changing
+ * severity_filter (show messages at least this severe, 7 shows everything) or sysid_filter
+ * (-1 for every unit) rebuilds the visible rows from those instead of scanning every message.
+ */
 class StatusLogModel : public QAbstractListModel {
     Q_OBJECT
 
@@ -25,6 +39,10 @@ public:
 
     static StatusLogModel* instance();
 
+    static const int Capacity = 1000;
+
+    // MAV_SEVERITY_EMERGENCY (0) to MAV_SEVERITY_DEBUG (7)
+    static const int SeverityCount = 8;
 
     void addMessage(StatusMessage message);
 
@@ -34,11 +52,50 @@ public:
     //QModelIndex index(int row, int column, const QModelIndex &parent = QModelIndex()) const;
     //QModelIndex parent(const QModelIndex &child) const;
 
+    Q_PROPERTY(int severity_filter MEMBER m_severity_filter WRITE set_severity_filter NOTIFY severity_filter_changed)
+    void set_severity_filter(int severity_filter);
+
+    Q_PROPERTY(int sysid_filter MEMBER m_sysid_filter WRITE set_sysid_filter NOTIFY sysid_filter_changed)
+    void set_sysid_filter(int sysid_filter);
+
+    // messages currently held, whether or not they pass the filters
+    Q_INVOKABLE int severityCount(int severity) const;
+    Q_INVOKABLE int sysidCount(int sysid) const;
+
+signals:
+    void severity_filter_changed(int severity_filter);
+    void sysid_filter_changed(int sysid_filter);
+
 protected :
       QHash<int, QByteArray> roleNames() const;
 
+private slots:
+    void flush();
+
 private:
-    QList<StatusMessage> m_messages;
+    static int severityIndex(int severity);
+
+    bool filtered() const;
+    bool matches(const StatusMessage &message) const;
+    const StatusMessage& messageForRow(int row) const;
+    void rebuildVisible();
+
+    RingBuffer<StatusMessage, Capacity> m_messages;
+    // sequence number of m_messages.at(0)
+    quint64 m_first_seq = 0;
+
+    QList<quint64> m_by_severity[SeverityCount];
+    QHash<int, QList<quint64>> m_by_sysid;
+
+    // sequence numbers of the rows shown while a filter is set
+    QList<quint64> m_visible;
+
+    int m_severity_filter = SeverityCount - 1;
+    int m_sysid_filter = -1;
+
+    QMutex m_pending_mutex;
+    QList<StatusMessage> m_pending;
+    bool m_flush_scheduled = false;
 };
 
 #endif // STATUSLOGMODEL_H
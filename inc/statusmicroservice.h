@@ -11,6 +11,7 @@
 
 #include "util.h"
 
+#include "logger.h"
 #include "mavlinkbase.h"
 
 #include "statuslogmodel.h"
@@ -43,6 +44,9 @@ private:
 
     uint64_t m_last_timestamp = 0;
 
+    // the air and ground instances each log their own unmatched messages
+    LogRateLimit m_unmatched_log { 1000 };
+
     QString m_openHDVersion = "Checking...";
 };
 
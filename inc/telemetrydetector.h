@@ -0,0 +1,130 @@
+#ifndef TELEMETRYDETECTOR_H
+#define TELEMETRYDETECTOR_H
+
+#include <QObject>
+#include <QtQuick>
+
+#include <atomic>
+
+#include "ingestreactor.h"
+#include "mspprotocol.h"
+#include "telemetryframing.h"
+
+
+typedef enum TelemetryProtocol {
+    TelemetryProtocolUnknown,
+    TelemetryProtocolMavlink,
+    TelemetryProtocolLTM,
+    TelemetryProtocolVector,
+    TelemetryProtocolFrSky,
+    TelemetryProtocolSmartPort,
+    TelemetryProtocolMSP
+} TelemetryProtocol;
+
+
+class TelemetryDetector;
+class MSPTelemetry;
+class QUdpSocket;
+
+
+/*
+ * Watches one port for TelemetryDetector, on the ingest thread. The serial protocols are
+ * recognised by running the stream through a framer for each of them, so a protocol only
+ * counts once whole frames with valid checksums turn up, not just its sync bytes.
+ */
+class TelemetrySniffer: public IngestHandler {
+public:
+    TelemetrySniffer(TelemetryDetector* detector, quint16 port);
+
+    void ingestDatagram(const uint8_t* data, int size) override;
+
+    const quint16 port;
+
+private:
+    TelemetryProtocol sniff(const uint8_t* data, int size);
+
+    TelemetryDetector* m_detector;
+
+    TelemetryFramer m_ltm;
+    TelemetryFramer m_vector;
+    TelemetryFramer m_frsky;
+    TelemetryFramer m_smartport;
+    MSPParser m_msp;
+
+    int m_mavlink_count = 0;
+};
+
+
+/*
+ * Listens on the ports the legacy telemetry protocols can arrive on until one of them shows
+ * up, then releases all of them and starts only the parser for that protocol, on the port it
+ * was seen on. Until then none of the parsers exist at all.
+ *
+ * MAVLink arriving on one of these ports is recognised too, it's handled by MavlinkTelemetry
+ * so no parser is started for it, but the ports are still released.
+ *
+ * An MSP flight controller stays silent until it's polled, so while nothing has been found an
+ * MSP_STATUS request goes out on the MSP uplink once a second.
+ *
+ * Once MavlinkTelemetry hears from a flight controller, or nothing has turned up after
+ * DetectTimeoutMs, the probe stops and the ports are released without starting anything.
+ */
+class TelemetryDetector: public QObject {
+    Q_OBJECT
+
+public:
+    explicit TelemetryDetector(QObject *parent = nullptr);
+
+    static TelemetryDetector* instance();
+
+    void onStarted();
+
+    // how many frames of a protocol have to be seen before it's trusted
+    static const int DetectFrames = 5;
+
+    // how long to keep probing and sniffing before giving up
+    static const int DetectTimeoutMs = 120000;
+
+    Q_PROPERTY(QString protocol MEMBER m_protocol NOTIFY protocol_changed)
+
+signals:
+    void protocol_changed(QString protocol);
+
+public slots:
+    void setGroundIP(QString address);
+
+    void onMavlinkHeartbeat();
+
+private slots:
+    void sendProbe();
+
+    void onDetectTimeout();
+
+private:
+    friend class TelemetrySniffer;
+
+    // called on the ingest thread, the first detection wins
+    void detected(TelemetryProtocol protocol, quint16 port);
+
+    void activate(TelemetryProtocol protocol, quint16 port);
+
+    // stops the probe and closes every sniffer port
+    void release();
+
+    // gives up on the legacy protocols, unless one has already been found
+    void stop(QString reason);
+
+    QList<TelemetrySniffer*> m_sniffers;
+    std::atomic<bool> m_detected;
+
+    QUdpSocket* m_probe_socket = nullptr;
+    QTimer* m_probe_timer = nullptr;
+    QTimer* m_detect_timer = nullptr;
+    QString m_ground_address = "127.0.0.1";
+
+    MSPTelemetry* m_msp_telemetry = nullptr;
+
+    QString m_protocol = "N/A";
+};
+
+#endif // TELEMETRYDETECTOR_H
@@ -0,0 +1,209 @@
+#ifndef TELEMETRYFRAMING_H
+#define TELEMETRYFRAMING_H
+
+#include <stdint.h>
+
+
+/*
+ * Framing for the serial telemetry protocols we receive over UDP (LTM, Vector Open Telemetry,
+ * FrSky D and FrSky SmartPort).
+ *
+ * Each protocol is described by a FrameProtocol table rather than its own hand written state
+ * machine, and all parse state lives in a TelemetryFramer instance, so any number of them can
+ * run at once on any thread. Frame lengths only ever come from the tables, never from the
+ * stream, so a corrupted stream can cost us frames but can't make the framer read out of
+ * bounds or wait for a frame that will never finish.
+ *
+ * Nothing in here depends on Qt so the framers can be built into the fuzz and benchmark
+ * targets on their own.
+ */
+
+
+typedef enum FrameChecksum {
+    FrameChecksumNone,
+    // 1 byte, xor of the payload (LTM)
+    FrameChecksumXor,
+    // 1 byte, 0xff minus the carry-folded sum of everything before it (SmartPort)
+    FrameChecksumSmartPort,
+    // 2 bytes little endian, Vector CRC16 of everything before it
+    FrameChecksumVector
+} FrameChecksum;
+
+
+typedef struct FrameType {
+    uint8_t id;
+    // payload bytes following the type byte, not counting the checksum
+    uint8_t length;
+} FrameType;
+
+
+typedef struct FrameProtocol {
+    const char* name;
+
+    uint8_t sync[4];
+    uint8_t sync_length;
+
+    /*
+     * When typed, the byte after the sync selects an entry in types. If there is no table
+     * every type id is accepted and has fixed_length bytes of payload, which is also the
+     * payload length of untyped frames.
+     */
+    bool typed;
+    const FrameType* types;
+    int type_count;
+    uint8_t fixed_length;
+
+    // bytes after the sync that equal escape are dropped and the next byte is xored with escape_xor
+    bool escaped;
+    uint8_t escape;
+    uint8_t escape_xor;
+
+    // a raw delimiter can only appear between frames, seeing one aborts any partial frame
+    bool delimited;
+    uint8_t delimiter;
+
+    FrameChecksum checksum;
+} FrameProtocol;
+
+
+extern const FrameProtocol LTMFrameProtocol;
+extern const FrameProtocol VectorFrameProtocol;
+extern const FrameProtocol FrSkyFrameProtocol;
+extern const FrameProtocol SmartPortFrameProtocol;
+
+
+int frameChecksumLength(FrameChecksum checksum);
+
+/*
+ * Checksum of the first length bytes of a frame with any escaping already undone, where
+ * payload_offset is the first byte after the sync and type.
+ */
+uint16_t frameChecksum(const FrameProtocol &protocol, const uint8_t* frame, int length, int payload_offset);
+
+
+/*
+ * Reads fields out of a frame payload. Every read is bounds checked, reading past the end
+ * returns 0 and marks the reader as overrun instead of touching memory outside the payload.
+ */
+class FrameReader {
+public:
+    FrameReader(const uint8_t* data, int size): m_data(data), m_size(size) {}
+
+    uint8_t u8() {
+        if (m_position >= m_size) {
+            m_overrun = true;
+            return 0;
+        }
+        return m_data[m_position++];
+    }
+
+    uint16_t u16() {
+        uint16_t t = u8();
+        t |= (uint16_t)u8() << 8;
+        return t;
+    }
+
+    uint32_t u32() {
+        uint32_t t = u16();
+        t |= (uint32_t)u16() << 16;
+        return t;
+    }
+
+    uint16_t u16_be() {
+        uint16_t t = (uint16_t)u8() << 8;
+        t |= u8();
+        return t;
+    }
+
+    uint32_t u32_be() {
+        uint32_t t = (uint32_t)u16_be() << 16;
+        t |= u16_be();
+        return t;
+    }
+
+    int16_t i16() { return (int16_t)u16(); }
+    int32_t i32() { return (int32_t)u32(); }
+    int16_t i16_be() { return (int16_t)u16_be(); }
+    int32_t i32_be() { return (int32_t)u32_be(); }
+
+    void skip(int count) {
+        if (count > remaining()) {
+            m_overrun = true;
+            m_position = m_size;
+            return;
+        }
+        m_position += count;
+    }
+
+    int size() const { return m_size; }
+    int remaining() const { return m_size - m_position; }
+    bool overrun() const { return m_overrun; }
+
+private:
+    const uint8_t* m_data;
+    int m_size;
+    int m_position = 0;
+    bool m_overrun = false;
+};
+
+
+typedef struct FramerStats {
+    uint64_t bytes = 0;
+    uint64_t frames = 0;
+    uint64_t checksum_errors = 0;
+    // frames abandoned because of an unknown type byte or a delimiter in the middle
+    uint64_t dropped = 0;
+} FramerStats;
+
+
+typedef enum FramerState {
+    FramerStateSync,
+    FramerStateType,
+    FramerStatePayload
+} FramerState;
+
+
+class TelemetryFramer {
+public:
+    // sync + type + largest possible payload + checksum, lengths in the tables are 8 bit
+    static const int MaxFrameSize = 4 + 1 + 255 + 2;
+
+    explicit TelemetryFramer(const FrameProtocol &protocol);
+
+    /*
+     * Feed one byte from the stream. Returns true when it completed a frame with a valid
+     * checksum, which can then be read with type() and payload() until the next call.
+     */
+    bool push(uint8_t byte);
+
+    void reset();
+
+    uint8_t type() const { return m_type; }
+    FrameReader payload() const { return FrameReader(m_frame + m_payload_offset, m_payload_length); }
+
+    FramerState state() const { return m_state; }
+    const FrameProtocol& protocol() const { return m_protocol; }
+    const FramerStats& stats() const { return m_stats; }
+
+private:
+    void beginFrame();
+    void beginPayload(int length);
+    void resync(uint8_t byte);
+
+    const FrameProtocol &m_protocol;
+    FramerStats m_stats;
+
+    FramerState m_state = FramerStateSync;
+    int m_sync_index = 0;
+    bool m_escape_pending = false;
+
+    uint8_t m_frame[MaxFrameSize];
+    int m_frame_length = 0;
+    int m_expected_length = 0;
+
+    uint8_t m_type = 0;
+    int m_payload_offset = 0;
+    int m_payload_length = 0;
+};
+
+#endif // TELEMETRYFRAMING_H
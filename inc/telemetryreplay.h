@@ -0,0 +1,151 @@
+#ifndef TELEMETRYREPLAY_H
+#define TELEMETRYREPLAY_H
+
+#include <QObject>
+#include <QtQuick>
+#include <QFile>
+
+#include <atomic>
+
+#include "flightrecorder.h"
+
+class MavlinkBase;
+class OpenHDTelemetry;
+
+
+/*
+ * Plays a segment written by FlightRecorder back through the same decoders live data goes
+ * through, MavlinkBase::replayData() for MAVLink and OpenHDTelemetry::replayDatagram() for
+ * wifibroadcast status, so the whole UI behaves as it did during the flight.
+ *
+ * While a segment is open the targets ignore live input, and MavlinkBase sends nothing the
+ * replayed state would trigger and forwards none of it to the GCS endpoints, so the vehicle
+ * and other ground control software never see the replay.
+ *
+ * Playback runs on its own thread and hands each batch of records to the thread that owns the
+ * target. At SpeedMax records are sent as fast as the targets consume them, which makes replay
+ * a benchmark of the complete telemetry -> OpenHD -> QML path, see messages_per_second and
+ * gui_ns_per_message.
+ */
+class TelemetryReplay: public QObject {
+    Q_OBJECT
+
+public:
+    explicit TelemetryReplay(QObject *parent = nullptr);
+    static TelemetryReplay* instance();
+
+    typedef enum ReplaySpeed {
+        SpeedMax = 0,
+        SpeedNormal = 1,
+        SpeedFast = 4
+    } ReplaySpeed;
+    Q_ENUM(ReplaySpeed)
+
+    void addMavlinkTarget(MavlinkBase* target);
+    void setOpenHDTarget(OpenHDTelemetry* target);
+
+    Q_INVOKABLE QStringList recordings();
+
+    Q_INVOKABLE void open(QString path);
+    Q_INVOKABLE void close();
+    Q_INVOKABLE void play();
+    Q_INVOKABLE void pause();
+    Q_INVOKABLE void seek(double position);
+    Q_INVOKABLE void setSpeed(int speed);
+
+    Q_PROPERTY(QString path MEMBER m_path WRITE set_path NOTIFY path_changed)
+    void set_path(QString path);
+
+    Q_PROPERTY(bool active MEMBER m_active WRITE set_active NOTIFY active_changed)
+    void set_active(bool active);
+
+    Q_PROPERTY(bool playing MEMBER m_playing WRITE set_playing NOTIFY playing_changed)
+    void set_playing(bool playing);
+
+    Q_PROPERTY(int speed MEMBER m_speed WRITE set_speed NOTIFY speed_changed)
+    void set_speed(int speed);
+
+    Q_PROPERTY(double duration MEMBER m_duration WRITE set_duration NOTIFY duration_changed)
+    void set_duration(double duration);
+
+    Q_PROPERTY(double position MEMBER m_position WRITE set_position NOTIFY position_changed)
+    void set_position(double position);
+
+    Q_PROPERTY(double messages_per_second MEMBER m_messages_per_second WRITE set_messages_per_second NOTIFY messages_per_second_changed)
+    void set_messages_per_second(double messages_per_second);
+
+    Q_PROPERTY(double gui_ns_per_message MEMBER m_gui_ns_per_message WRITE set_gui_ns_per_message NOTIFY gui_ns_per_message_changed)
+    void set_gui_ns_per_message(double gui_ns_per_message);
+
+signals:
+    void path_changed(QString path);
+    void active_changed(bool active);
+    void playing_changed(bool playing);
+    void speed_changed(int speed);
+    void duration_changed(double duration);
+    void position_changed(double position);
+    void messages_per_second_changed(double messages_per_second);
+    void gui_ns_per_message_changed(double gui_ns_per_message);
+
+    void openFailed(QString path);
+
+public slots:
+    void onStarted();
+
+private slots:
+    void tick();
+
+private:
+    void openSegment(QString path);
+    void closeSegment();
+    void setTargetsReplaying(bool replaying);
+    void playSegment();
+    void pauseSegment();
+    void seekSegment(double position);
+    void changeSpeed(int speed);
+
+    void deliver(int from, int to);
+    void updateStats();
+
+    typedef struct {
+        qint64 offset;
+        qint64 timestamp_ns;
+    } ReplayRecord;
+
+    QList<MavlinkBase*> m_mavlink_targets;
+    OpenHDTelemetry* m_openhd_target = nullptr;
+
+    QFile m_file;
+    const uchar* m_data = nullptr;
+    QVector<ReplayRecord> m_records;
+    int m_next = 0;
+
+    QTimer* timer = nullptr;
+    QElapsedTimer m_tick_time;
+    qint64 m_position_ns = 0;
+
+    bool m_recorder_was_enabled = false;
+
+    // batches handed to target threads that haven't been processed yet
+    std::atomic<int> m_pending;
+
+    // updated from whichever thread processes the records
+    std::atomic<quint64> m_delivered;
+    std::atomic<quint64> m_gui_nsecs;
+
+    QElapsedTimer m_stats_time;
+    quint64 m_stats_delivered = 0;
+    quint64 m_stats_gui_nsecs = 0;
+    quint64 m_stats_sync_nsecs = 0;
+
+    QString m_path;
+    bool m_active = false;
+    bool m_playing = false;
+    int m_speed = SpeedNormal;
+    double m_duration = 0.0;
+    double m_position = 0.0;
+    double m_messages_per_second = 0.0;
+    double m_gui_ns_per_message = 0.0;
+};
+
+#endif
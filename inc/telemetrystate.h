@@ -0,0 +1,256 @@
+#ifndef TELEMETRYSTATE_H
+#define TELEMETRYSTATE_H
+
+#include <stdint.h>
+#include <string.h>
+
+#include <atomic>
+
+#include "triplebuffer.h"
+
+
+/*
+ * Bit flags recording which fields of a TelemetryState a source has written at least once,
+ * so that OpenHD only applies values a protocol actually provides.
+ */
+enum TelemetryField : uint64_t {
+    TelemetryFieldArmed              = 1ULL << 0,
+    TelemetryFieldFlightMode         = 1ULL << 1,
+    TelemetryFieldBatteryVoltage     = 1ULL << 2,
+    TelemetryFieldBatteryCurrent     = 1ULL << 3,
+    TelemetryFieldBatteryPercent     = 1ULL << 4,
+    TelemetryFieldSatellitesVisible  = 1ULL << 5,
+    TelemetryFieldGpsHdop            = 1ULL << 6,
+    TelemetryFieldFcTemp             = 1ULL << 7,
+    TelemetryFieldPitch              = 1ULL << 8,
+    TelemetryFieldRoll               = 1ULL << 9,
+    TelemetryFieldLat                = 1ULL << 10,
+    TelemetryFieldLon                = 1ULL << 11,
+    TelemetryFieldBootTime           = 1ULL << 12,
+    TelemetryFieldAltRel             = 1ULL << 13,
+    TelemetryFieldAltMsl             = 1ULL << 14,
+    TelemetryFieldHdg                = 1ULL << 15,
+    TelemetryFieldVx                 = 1ULL << 16,
+    TelemetryFieldVy                 = 1ULL << 17,
+    TelemetryFieldVz                 = 1ULL << 18,
+    TelemetryFieldRcRssi             = 1ULL << 19,
+    TelemetryFieldControl            = 1ULL << 20,
+    TelemetryFieldRCChannels         = 1ULL << 21,
+    TelemetryFieldThrottle           = 1ULL << 22,
+    TelemetryFieldAirspeed           = 1ULL << 23,
+    TelemetryFieldSpeed              = 1ULL << 24,
+    TelemetryFieldVsi                = 1ULL << 25,
+    TelemetryFieldMavWind            = 1ULL << 26,
+    TelemetryFieldFlightMah          = 1ULL << 27,
+    TelemetryFieldVibration          = 1ULL << 28,
+    TelemetryFieldHome               = 1ULL << 29
+};
+
+
+/*
+ * Plain copy of everything a telemetry protocol can tell us about the vehicle. It holds no
+ * Qt types so it can be copied between threads with memcpy, and is only ever written by the
+ * thread that parses the protocol.
+ *
+ * position_seq and battery_seq are bumped each time a position or battery message has been
+ * processed, so the GUI side knows when to rerun the derived calculations (home distance,
+ * flight distance, wind, mAh) even if none of the raw values happened to change.
+ */
+struct TelemetryState {
+    uint64_t fields = 0;
+
+    uint32_t position_seq = 0;
+    uint32_t battery_seq = 0;
+
+    bool armed = false;
+    char flight_mode[32] = "------";
+
+    double battery_voltage = 0.0;
+    double battery_current = 0.0;
+    int battery_percent = 0;
+
+    int satellites_visible = 0;
+    double gps_hdop = 99.00;
+
+    int fc_temp = 0;
+
+    double pitch = 0.0;
+    double roll = 0.0;
+
+    double lat = 0.0;
+    double lon = 0.0;
+    int boot_time = 0;
+    double alt_rel = 0.0;
+    double alt_msl = 0.0;
+    int hdg = 0;
+
+    double vx = 0.0;
+    double vy = 0.0;
+    double vz = 0.0;
+
+    int rc_rssi = 0;
+
+    int control_pitch = 0;
+    int control_roll = 0;
+    int control_throttle = 0;
+    int control_yaw = 0;
+
+    int rc_channels[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+
+    double throttle = 0.0;
+    double airspeed = 0.0;
+    double speed = 0.0;
+    float vsi = 0.0;
+
+    float mav_wind_direction = 0.0;
+    float mav_wind_speed = 0.0;
+
+    double flight_mah = 0.0;
+
+    float vibration_x = 0.0;
+    float vibration_y = 0.0;
+    float vibration_z = 0.0;
+    float clipping_x = 0.0;
+    float clipping_y = 0.0;
+    float clipping_z = 0.0;
+
+    double homelat = 0.0;
+    double homelon = 0.0;
+};
+
+
+/*
+ * Told about every publish(), on the publishing thread. OpenHD uses it to ask for a frame so
+ * a new snapshot is applied even when nothing else in the scene is changing.
+ */
+class TelemetryListener {
+public:
+    virtual ~TelemetryListener() {}
+    virtual void telemetryPublished() = 0;
+};
+
+
+/*
+ * Owned by a telemetry protocol class and written only from the thread that protocol runs on.
+ *
+ * The setters mirror the ones on OpenHD so a parser reads the same way it used to, but they
+ * only touch the private working copy. Calling publish() hands a complete copy of it to the
+ * GUI thread, where OpenHD::syncTelemetry() picks it up once per frame.
+ */
+class TelemetryPublisher {
+public:
+    TelemetryPublisher() {}
+
+    void publish() {
+        m_buffer.back() = m_state;
+        m_buffer.publish();
+
+        auto listener = m_listener.load(std::memory_order_acquire);
+        if (listener != nullptr) {
+            listener->telemetryPublished();
+        }
+    }
+
+    // set by OpenHD when the publisher is registered, the protocol may already be publishing
+    void setListener(TelemetryListener* listener) {
+        m_listener.store(listener, std::memory_order_release);
+    }
+
+    // GUI thread only
+    bool update() {
+        return m_buffer.update();
+    }
+
+    // GUI thread only
+    const TelemetryState& snapshot() const {
+        return m_buffer.front();
+    }
+
+    void set_armed(bool armed) { m_state.armed = armed; m_state.fields |= TelemetryFieldArmed; }
+
+    void set_flight_mode(const char* flight_mode) {
+        strncpy(m_state.flight_mode, flight_mode, sizeof(m_state.flight_mode) - 1);
+        m_state.flight_mode[sizeof(m_state.flight_mode) - 1] = '\0';
+        m_state.fields |= TelemetryFieldFlightMode;
+    }
+
+    void set_battery_voltage(double battery_voltage) { m_state.battery_voltage = battery_voltage; m_state.fields |= TelemetryFieldBatteryVoltage; }
+    void set_battery_current(double battery_current) { m_state.battery_current = battery_current; m_state.fields |= TelemetryFieldBatteryCurrent; }
+    void set_battery_percent(int battery_percent) { m_state.battery_percent = battery_percent; m_state.fields |= TelemetryFieldBatteryPercent; }
+
+    void set_satellites_visible(int satellites_visible) { m_state.satellites_visible = satellites_visible; m_state.fields |= TelemetryFieldSatellitesVisible; }
+    void set_gps_hdop(double gps_hdop) { m_state.gps_hdop = gps_hdop; m_state.fields |= TelemetryFieldGpsHdop; }
+
+    void set_fc_temp(int fc_temp) { m_state.fc_temp = fc_temp; m_state.fields |= TelemetryFieldFcTemp; }
+
+    void set_pitch(double pitch) { m_state.pitch = pitch; m_state.fields |= TelemetryFieldPitch; }
+    void set_roll(double roll) { m_state.roll = roll; m_state.fields |= TelemetryFieldRoll; }
+
+    void set_lat(double lat) { m_state.lat = lat; m_state.fields |= TelemetryFieldLat; }
+    void set_lon(double lon) { m_state.lon = lon; m_state.fields |= TelemetryFieldLon; }
+    void set_boot_time(int boot_time) { m_state.boot_time = boot_time; m_state.fields |= TelemetryFieldBootTime; }
+    void set_alt_rel(double alt_rel) { m_state.alt_rel = alt_rel; m_state.fields |= TelemetryFieldAltRel; }
+    void set_alt_msl(double alt_msl) { m_state.alt_msl = alt_msl; m_state.fields |= TelemetryFieldAltMsl; }
+    void set_hdg(int hdg) { m_state.hdg = hdg; m_state.fields |= TelemetryFieldHdg; }
+
+    void set_vx(double vx) { m_state.vx = vx; m_state.fields |= TelemetryFieldVx; }
+    void set_vy(double vy) { m_state.vy = vy; m_state.fields |= TelemetryFieldVy; }
+    void set_vz(double vz) { m_state.vz = vz; m_state.fields |= TelemetryFieldVz; }
+
+    void set_rc_rssi(int rc_rssi) { m_state.rc_rssi = rc_rssi; m_state.fields |= TelemetryFieldRcRssi; }
+
+    void set_control(int control_pitch, int control_roll, int control_throttle, int control_yaw) {
+        m_state.control_pitch = control_pitch;
+        m_state.control_roll = control_roll;
+        m_state.control_throttle = control_throttle;
+        m_state.control_yaw = control_yaw;
+        m_state.fields |= TelemetryFieldControl;
+    }
+
+    void set_rc_channel(int channel, int value) {
+        if (channel < 0 || channel >= 8) {
+            return;
+        }
+        m_state.rc_channels[channel] = value;
+        m_state.fields |= TelemetryFieldRCChannels;
+    }
+
+    void set_throttle(double throttle) { m_state.throttle = throttle; m_state.fields |= TelemetryFieldThrottle; }
+    void set_airspeed(double airspeed) { m_state.airspeed = airspeed; m_state.fields |= TelemetryFieldAirspeed; }
+    void set_speed(double speed) { m_state.speed = speed; m_state.fields |= TelemetryFieldSpeed; }
+    void set_vsi(float vsi) { m_state.vsi = vsi; m_state.fields |= TelemetryFieldVsi; }
+
+    void set_mav_wind(float mav_wind_direction, float mav_wind_speed) {
+        m_state.mav_wind_direction = mav_wind_direction;
+        m_state.mav_wind_speed = mav_wind_speed;
+        m_state.fields |= TelemetryFieldMavWind;
+    }
+
+    void set_flight_mah(double flight_mah) { m_state.flight_mah = flight_mah; m_state.fields |= TelemetryFieldFlightMah; }
+
+    void set_vibration(float vibration_x, float vibration_y, float vibration_z, float clipping_x, float clipping_y, float clipping_z) {
+        m_state.vibration_x = vibration_x;
+        m_state.vibration_y = vibration_y;
+        m_state.vibration_z = vibration_z;
+        m_state.clipping_x = clipping_x;
+        m_state.clipping_y = clipping_y;
+        m_state.clipping_z = clipping_z;
+        m_state.fields |= TelemetryFieldVibration;
+    }
+
+    void set_home(double homelat, double homelon) {
+        m_state.homelat = homelat;
+        m_state.homelon = homelon;
+        m_state.fields |= TelemetryFieldHome;
+    }
+
+    void position_updated() { m_state.position_seq++; }
+    void battery_updated() { m_state.battery_seq++; }
+
+private:
+    TelemetryState m_state;
+    TripleBuffer<TelemetryState> m_buffer;
+    std::atomic<TelemetryListener*> m_listener { nullptr };
+};
+
+#endif // TELEMETRYSTATE_H
@@ -0,0 +1,44 @@
+#ifndef TELEMETRYSUBSCRIPTIONS_H
+#define TELEMETRYSUBSCRIPTIONS_H
+
+#include <QObject>
+#include <QtQuick>
+#include <QMutex>
+
+
+/*
+ * Keeps track of which MAVLink messages the visible OSD widgets need and how often.
+ *
+ * Each widget subscribes with a map of message names to rates in Hz while it is visible. The
+ * combined rate for a message is the highest rate any subscriber asked for. MavlinkTelemetry
+ * turns those into MAV_CMD_SET_MESSAGE_INTERVAL requests, and turns off managed messages that
+ * nobody subscribes to so they don't waste telemetry bandwidth. While MAVLink is forwarded to
+ * other ground control software those are put back to their default rate instead.
+ *
+ * Only messages listed in managedMessages() are ever touched, everything else is left at
+ * whatever rate the flight controller streams it.
+ */
+class TelemetrySubscriptions: public QObject {
+    Q_OBJECT
+
+public:
+    explicit TelemetrySubscriptions(QObject *parent = nullptr);
+    static TelemetrySubscriptions* instance();
+
+    Q_INVOKABLE void subscribe(QString subscriber, QVariantMap messages);
+    Q_INVOKABLE void unsubscribe(QString subscriber);
+
+    // message id -> rate in Hz, 0 means nobody needs it. Can be called from any thread.
+    QMap<uint32_t, double> rates();
+
+    static const QMap<QString, uint32_t>& managedMessages();
+
+signals:
+    void ratesChanged();
+
+private:
+    QMutex m_mutex;
+    QMap<QString, QMap<uint32_t, double>> m_subscriptions;
+};
+
+#endif
@@ -0,0 +1,96 @@
+#ifndef TIMESERIESSTORE_H
+#define TIMESERIESSTORE_H
+
+#include <QObject>
+#include <QtQuick>
+
+#if defined(ENABLE_CHARTS)
+#include <QtCharts/QXYSeries>
+QT_CHARTS_USE_NAMESPACE
+#endif
+
+
+/*
+ * Columnar store for chart data.
+ *
+ * Every column, including the shared x column, is allocated once for the whole retention
+ * window and then written as a ring, so memory use doesn't change no matter how long the
+ * session runs. Old rows are simply overwritten.
+ *
+ * Charts don't get one point per row. Series are attached to a column, and a few times a
+ * second each one is replaced in a single call with the visible span of the column decimated
+ * to the width of the chart: the lowest and highest value for every pixel column, so spikes
+ * still show up. The span's first row is found with a binary search, so the work done per
+ * update depends on the span and the chart width rather than the amount of history.
+ */
+class TimeSeriesStore : public QObject {
+    Q_OBJECT
+
+public:
+    explicit TimeSeriesStore(QStringList columns, int retention, QObject *parent = nullptr);
+
+    void append(double x, const QVector<double> &values);
+
+    void decimate(int column, double min_x, double max_x, int pixels, QVector<QPointF> &points) const;
+
+    int column(QString name) const;
+
+#if defined(ENABLE_CHARTS)
+    Q_INVOKABLE void attach(QAbstractSeries* series, QString column);
+    Q_INVOKABLE void detach(QAbstractSeries* series);
+#endif
+
+    // x range currently shown, charts bind their axis to these
+    Q_PROPERTY(double first_x MEMBER m_first_x NOTIFY range_changed)
+    Q_PROPERTY(double last_x MEMBER m_last_x NOTIFY range_changed)
+
+    // how far back from the newest row the attached series go, 0 for all of the history
+    Q_PROPERTY(double span MEMBER m_span WRITE set_span NOTIFY span_changed)
+    void set_span(double span);
+
+    // width of the plot area the attached series are decimated for
+    Q_PROPERTY(int pixels MEMBER m_pixels WRITE set_pixels NOTIFY pixels_changed)
+    void set_pixels(int pixels);
+
+signals:
+    void range_changed();
+    void span_changed(double span);
+    void pixels_changed(int pixels);
+
+private slots:
+    void updateSeries();
+
+private:
+    int lowerBound(double x) const;
+
+    double xAt(int row) const {
+        return m_x[(m_head + m_retention - m_size + row) % m_retention];
+    }
+
+    double valueAt(int column, int row) const {
+        return m_columns[column][(m_head + m_retention - m_size + row) % m_retention];
+    }
+
+    QStringList m_names;
+    int m_retention;
+
+    QVector<double> m_x;
+    QVector<QVector<double>> m_columns;
+    int m_head = 0;
+    int m_size = 0;
+
+    double m_first_x = 0.0;
+    double m_last_x = 0.0;
+    double m_span = 0.0;
+    int m_pixels = 600;
+
+#if defined(ENABLE_CHARTS)
+    QList<QPair<QPointer<QXYSeries>, int>> m_series;
+    QVector<QPointF> m_points;
+#endif
+
+    bool m_dirty = false;
+    QTimer* m_timer = nullptr;
+};
+
+#endif // TIMESERIESSTORE_H
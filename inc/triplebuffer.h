@@ -0,0 +1,57 @@
+#pragma once
+
+#include <atomic>
+
+/*
+ * Single-producer, single-consumer triple buffer.
+ *
+ * The writer always owns one buffer (back), the reader always owns one buffer (front),
+ * and the third buffer sits in the middle waiting to be picked up. Handing a buffer over
+ * is a single atomic exchange on either side, so neither side ever blocks or retries and
+ * the reader always sees a complete value rather than a half-written one.
+ *
+ * The writer fills back() and calls publish(). The reader calls update(), which returns
+ * true if a newer value was published since the last call, and then reads front().
+ */
+template <typename T>
+class TripleBuffer {
+public:
+    TripleBuffer() {}
+
+    T& back() {
+        return m_buffers[m_back].value;
+    }
+
+    void publish() {
+        int previous = m_middle.exchange(m_back | DirtyBit, std::memory_order_acq_rel);
+        m_back = previous & IndexMask;
+    }
+
+    bool update() {
+        if ((m_middle.load(std::memory_order_relaxed) & DirtyBit) == 0) {
+            return false;
+        }
+        int previous = m_middle.exchange(m_front, std::memory_order_acq_rel);
+        m_front = previous & IndexMask;
+        return true;
+    }
+
+    const T& front() const {
+        return m_buffers[m_front].value;
+    }
+
+private:
+    static constexpr int IndexMask = 0x3;
+    static constexpr int DirtyBit = 0x4;
+
+    // keep each buffer on its own cache line so the two threads don't false-share
+    struct alignas(64) Slot {
+        T value;
+    };
+
+    Slot m_buffers[3];
+
+    int m_back = 0;
+    std::atomic<int> m_middle { 1 };
+    int m_front = 2;
+};
@@ -0,0 +1,67 @@
+#ifndef VSIGAUGE_H
+#define VSIGAUGE_H
+
+#include "osdinstrument.h"
+
+
+class QSGTransformNode;
+
+
+class VsiGaugeNode: public OSDInstrumentNode {
+public:
+    QSGTransformNode* needle_transform = nullptr;
+    QSGGeometryNode* needle = nullptr;
+};
+
+
+/*
+ * The vertical speed dial, laid out the way the CircularGauge it replaces was: a 270 degree
+ * arc open to the right, zero pointing left and climbing turning the needle up. Ticks every
+ * 10 except at zero, and maximum / 5 between labels.
+ *
+ * The dial is only rebuilt when the size, range or colors change, a new value just rotates
+ * the needle's transform.
+ */
+class VsiGauge: public OSDInstrument {
+    Q_OBJECT
+
+public:
+    explicit VsiGauge(QQuickItem *parent = nullptr);
+
+    Q_PROPERTY(double value MEMBER m_value WRITE set_value NOTIFY value_changed)
+    void set_value(double value);
+
+    // the dial runs from -maximum to maximum
+    Q_PROPERTY(double maximum MEMBER m_maximum WRITE set_maximum NOTIFY maximum_changed)
+    void set_maximum(double maximum);
+
+    // labels and the needle
+    Q_PROPERTY(QColor text_color MEMBER m_text_color WRITE set_text_color NOTIFY text_color_changed)
+    void set_text_color(QColor text_color);
+
+signals:
+    void value_changed(double value);
+    void maximum_changed(double maximum);
+    void text_color_changed(QColor text_color);
+
+protected:
+    QSGNode* updatePaintNode(QSGNode* old, UpdatePaintNodeData* data) override;
+
+private:
+    // clockwise from 12 o'clock
+    double valueAngle(double value) const;
+
+    void buildDial(VsiGaugeNode* node, QPointF center, qreal radius);
+
+    double m_value = 0;
+    double m_maximum = 20;
+    QColor m_text_color = QColor("white");
+
+    // what the dial was last built for
+    QSizeF m_dial_size;
+    double m_dial_maximum = 0;
+    QColor m_dial_color;
+    QColor m_dial_text_color;
+};
+
+#endif // VSIGAUGE_H
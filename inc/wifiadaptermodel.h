@@ -0,0 +1,74 @@
+#ifndef WIFIADAPTERMODEL_H
+#define WIFIADAPTERMODEL_H
+
+#include <QObject>
+#include <QtQuick>
+
+#include "wifibroadcaststatus.h"
+
+
+class WifiAdapter {
+public:
+    WifiAdapterStatus status;
+
+    // packets per second over the last RateWindow
+    int packet_rate = 0;
+
+    // recent (timestamp, received_packet_cnt) samples the packet rate is calculated from
+    QVector<QPair<qint64, uint32_t>> samples;
+};
+
+
+/*
+ * One row per wifi card on the ground station, as reported in the wifibroadcast status.
+ *
+ * Ground stations with several diversity cards send an update for every card several times
+ * a second, most of them identical to the last, so rows are only signalled when a value in
+ * them actually changed, and only for the roles that changed.
+ */
+class WifiAdapterModel : public QAbstractListModel {
+    Q_OBJECT
+
+public:
+    explicit WifiAdapterModel(QObject *parent = nullptr);
+
+    static WifiAdapterModel* instance();
+
+    typedef enum WifiAdapterRole {
+        ReceivedPacketCountRole = Qt::UserRole + 1,
+        SignalRole,
+        SignalGoodRole,
+        TypeRole,
+        PacketRateRole,
+        BestRole
+    } WifiAdapterRole;
+
+    void updateAdapters(const QVector<WifiAdapterStatus> &adapters);
+
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const;
+    int rowCount(const QModelIndex &parent = QModelIndex()) const;
+
+    Q_PROPERTY(int count READ rowCount NOTIFY count_changed)
+
+    Q_PROPERTY(int best_adapter MEMBER m_best_adapter NOTIFY best_adapter_changed)
+    void set_best_adapter(int best_adapter);
+
+signals:
+    void count_changed(int count);
+    void best_adapter_changed(int best_adapter);
+
+protected:
+    QHash<int, QByteArray> roleNames() const;
+
+private:
+    int updatePacketRate(WifiAdapter &adapter, qint64 now);
+    int findBestAdapter();
+
+    QVector<WifiAdapter> m_adapters;
+
+    int m_best_adapter = -1;
+
+    QElapsedTimer m_clock;
+};
+
+#endif // WIFIADAPTERMODEL_H
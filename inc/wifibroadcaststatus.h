@@ -0,0 +1,72 @@
+#ifndef WIFIBROADCASTSTATUS_H
+#define WIFIBROADCASTSTATUS_H
+
+#include <QVector>
+
+#include "stdint.h"
+
+
+typedef enum WifibroadcastStatusLayout {
+    // the original 113 byte layout, always carries 6 adapter slots whether they're used or not
+    WifibroadcastStatusLayoutLegacy,
+    // same header, but only as many adapter entries as there are adapters, 7 bytes each
+    WifibroadcastStatusLayoutVariable,
+    // same header, adapter entries carry extra fields after the ones we know about
+    WifibroadcastStatusLayoutExtended
+} WifibroadcastStatusLayout;
+
+
+class WifiAdapterStatus {
+public:
+    uint32_t received_packet_cnt = 0;
+    int8_t current_signal_dbm = -127;
+    int8_t type = 0;
+    int8_t signal_good = 0;
+};
+
+
+/*
+ * Decoded form of wifibroadcast_rx_status_forward_t, see wifibroadcast.h.
+ *
+ * The fields are read at fixed offsets rather than by copying the datagram over the packed
+ * struct, so a ground station running a newer wifibroadcast that appends fields, sends more
+ * than 6 adapters, or grows the per-adapter entry can still be read. Anything after the
+ * fields we know about is ignored.
+ */
+class WifibroadcastStatus {
+public:
+    static const int HeaderSize = 71;
+    static const int AdapterSize = 7;
+    static const int LegacySize = HeaderSize + 6 * AdapterSize;
+
+    bool decode(const char* data, int size);
+
+    WifibroadcastStatusLayout layout = WifibroadcastStatusLayoutLegacy;
+
+    uint32_t damaged_block_cnt = 0;
+    uint32_t lost_packet_cnt = 0;
+    uint32_t skipped_packet_cnt = 0;
+    uint32_t injection_fail_cnt = 0;
+    uint32_t received_packet_cnt = 0;
+    uint32_t kbitrate = 0;
+    uint32_t kbitrate_measured = 0;
+    uint32_t kbitrate_set = 0;
+    uint32_t lost_packet_cnt_telemetry_up = 0;
+    uint32_t lost_packet_cnt_telemetry_down = 0;
+    uint32_t lost_packet_cnt_msp_up = 0;
+    uint32_t lost_packet_cnt_msp_down = 0;
+    uint32_t lost_packet_cnt_rc = 0;
+    int8_t current_signal_joystick_uplink = 0;
+    int8_t current_signal_telemetry_uplink = 0;
+    int8_t joystick_connected = 0;
+    float HomeLat = 0.0f;
+    float HomeLon = 0.0f;
+    uint8_t cpuload_gnd = 0;
+    uint8_t temp_gnd = 0;
+    uint8_t cpuload_air = 0;
+    uint8_t temp_air = 0;
+
+    QVector<WifiAdapterStatus> adapters;
+};
+
+#endif // WIFIBROADCASTSTATUS_H
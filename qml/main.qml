@@ -82,6 +82,7 @@ ApplicationWindow {
         property bool enable_speech: true
         property bool enable_imperial: false
         property bool enable_rc: false
+        onEnable_rcChanged: openHDRC.enable_rc = enable_rc
 
         property string color_shape: "white"
         property string color_text: "white"
@@ -243,27 +244,6 @@ ApplicationWindow {
         property bool stereo_mode: false
     }
 
-
-    FrSkyTelemetry {
-        id: frskyTelemetry
-    }
-
-    //MSPTelemetry {
-    //    id: mspTelemetry
-    //}
-
-    SmartportTelemetry {
-        id: smartportTelemetry
-    }
-
-    LTMTelemetry {
-        id: ltmTelemetry
-    }
-
-    VectorTelemetry {
-        id: vectorTelemetry
-    }
-
     Loader {
         anchors.fill: parent
         z: 1.0
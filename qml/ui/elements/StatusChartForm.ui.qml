@@ -188,25 +188,47 @@ Item {
         antialiasing: true
 
 
-        property int chartData: 0
-
-
-        property int lostPacketsLast: 0
-        property int lostPacketsMax: 0
-
-        property int damagedBlocksLast: 0
-        property int damagedBlocksMax: 0
+        /*
+         * Series and the LinkAnalytics metric each one plots. All of the rate and delta
+         * calculations happen in LinkAnalytics, and the series are filled in by its history
+         * store, already decimated to the width of the chart.
+         */
+        property var plots: [
+            { series: lostPacketAxis, metric: "lost_packets" },
+            { series: damagedBlockAxis, metric: "damaged_blocks" },
+            { series: injectionFailAxis, metric: "injection_fail" },
+            { series: skippedPacketAxis, metric: "skipped_packets" },
+            { series: airCPUAxis, metric: "cpuload_air" },
+            { series: gndCPUAxis, metric: "cpuload_gnd" },
+            { series: airTempAxis, metric: "temp_air" },
+            { series: gndTempAxis, metric: "temp_gnd" },
+            { series: downlinkRSSIAxis, metric: "downlink_rssi" },
+            { series: uplinkRSSIAxis, metric: "uplink_rssi" },
+            { series: bitrateAxis, metric: "bitrate" }
+        ]
+
+        Binding {
+            target: LinkAnalytics.store
+            property: "pixels"
+            value: Math.max(1, Math.round(chart.plotArea.width))
+        }
 
-        property int injectionFailLast: 0
-        property int injectionFailMax: 0
+        Component.onCompleted: {
+            for (var i = 0; i < plots.length; i++) {
+                LinkAnalytics.store.attach(plots[i].series, plots[i].metric);
+            }
+        }
 
-        property int skippedPacketsLast: 0
-        property int skippedPacketsMax: 0
+        Component.onDestruction: {
+            for (var i = 0; i < plots.length; i++) {
+                LinkAnalytics.store.detach(plots[i].series);
+            }
+        }
 
         ValueAxis {
             id: valueAxis
-            min: 0
-            max: 300
+            min: LinkAnalytics.store.first_x
+            max: Math.max(LinkAnalytics.store.last_x, LinkAnalytics.store.first_x + 1)
             labelsVisible: false
             color: "black"
             labelsFont: Qt.font({pixelSize: 12})
@@ -343,69 +365,5 @@ Item {
             width: 2
             useOpenGL: true
         }
-
-        Timer {
-            id: chartTimer
-            running: true
-            interval: 1000
-            repeat: true
-            onTriggered: {
-                if (chart.lostPacketsLast != 0) {
-                    var lostPacketsDifference = OpenHD.lost_packet_cnt - chart.lostPacketsLast;
-                    lostPacketAxis.append(chart.chartData, lostPacketsDifference);
-                }
-                chart.lostPacketsLast = OpenHD.lost_packet_cnt;
-
-                if (chart.damagedBlocksLast != 0) {
-                    var damagedBlocksDifference = OpenHD.damaged_block_cnt - chart.damagedBlocksLast;
-                    damagedBlockAxis.append(chart.chartData, damagedBlocksDifference);
-                }
-                chart.damagedBlocksLast = OpenHD.damaged_block_cnt;
-
-                if (chart.injectionFailLast != 0) {
-                    var injectionFailDifference = OpenHD.injection_fail_cnt - chart.injectionFailLast;
-                    injectionFailAxis.append(chart.chartData, injectionFailDifference);
-                }
-                chart.injectionFailLast = OpenHD.injection_fail_cnt;
-
-                if (chart.skippedPacketsLast != 0) {
-                    var skippedPacketDifference = OpenHD.skipped_packet_cnt - chart.skippedPacketsLast;
-                    skippedPacketAxis.append(chart.chartData, skippedPacketDifference);
-                }
-                chart.skippedPacketsLast = OpenHD.skipped_packet_cnt;
-
-                airCPUAxis.append(chart.chartData, OpenHD.cpuload_air);
-                gndCPUAxis.append(chart.chartData, OpenHD.cpuload_gnd);
-                airTempAxis.append(chart.chartData, OpenHD.temp_air);
-                gndTempAxis.append(chart.chartData, OpenHD.temp_gnd);
-                downlinkRSSIAxis.append(chart.chartData, OpenHD.downlink_rssi);
-                uplinkRSSIAxis.append(chart.chartData, OpenHD.current_signal_joystick_uplink);
-
-                bitrateAxis.append(chart.chartData, OpenHD.kbitrate / 1024);
-
-                chart.chartData++;
-
-                if (chart.chartData > 300) {
-                    valueAxis.min++;
-                    valueAxis.max++;
-
-                    lostPacketAxis.remove(1);
-                    damagedBlockAxis.remove(1);
-
-                    airCPUAxis.remove(1);
-                    gndCPUAxis.remove(1);
-                    airTempAxis.remove(1);
-                    gndTempAxis.remove(1);
-
-                    downlinkRSSIAxis.remove(1);
-                    uplinkRSSIAxis.remove(1);
-
-                    injectionFailAxis.remove(1);
-                    skippedPacketAxis.remove(1);
-
-                    bitrateAxis.remove(1);
-                }
-            }
-        }
     }
 }
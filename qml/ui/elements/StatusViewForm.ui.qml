@@ -20,18 +20,9 @@ Item {
         Component.onCompleted: {
             messageList.positionViewAtEnd()
         }
-    }
-
-    Connections {
-        target: AirStatusMicroservice
-        function onStatusMessage() {
-            messageList.positionViewAtEnd()
-        }
-    }
 
-    Connections {
-        target: GroundStatusMicroservice
-        function onStatusMessage() {
+        // messages are inserted in batches after the microservices announce them
+        onCountChanged: {
             messageList.positionViewAtEnd()
         }
     }
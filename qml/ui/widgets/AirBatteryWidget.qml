@@ -3,5 +3,6 @@ import QtQuick.Window 2.12
 import QtQuick.Layouts 1.12
 
 AirBatteryWidgetForm {
+    telemetrySubscriptions: ({ "SYS_STATUS": 2, "BATTERY_STATUS": 1 })
 
 }
@@ -39,8 +39,34 @@ BaseWidgetForm {
         }
     }
 
+    /*
+     * MAVLink messages this widget displays and the rate in Hz it needs them at, for example
+     * ({ "ATTITUDE": 25 }). They're only requested from the flight controller while the widget
+     * is visible.
+     */
+    property var telemetrySubscriptions: ({})
+
+    onVisibleChanged: updateSubscriptions()
+    onTelemetrySubscriptionsChanged: updateSubscriptions()
+
+    function updateSubscriptions() {
+        if (widgetIdentifier === "") {
+            return;
+        }
+        if (visible && Object.keys(telemetrySubscriptions).length > 0) {
+            TelemetrySubscriptions.subscribe(widgetIdentifier, telemetrySubscriptions);
+        } else {
+            TelemetrySubscriptions.unsubscribe(widgetIdentifier);
+        }
+    }
+
     Component.onCompleted: {
         loadAlignment();
+        updateSubscriptions();
+    }
+
+    Component.onDestruction: {
+        TelemetrySubscriptions.unsubscribe(widgetIdentifier);
     }
 
     SequentialAnimation {
@@ -59,22 +85,6 @@ BaseWidgetForm {
         ]
     }
 
-    Timer {
-        interval: 50;
-        running: dragging;
-        repeat: true
-        onTriggered: {
-            var point = calculateOffsets();
-            var _xOffset = point.x;
-            var _yOffset = point.y;
-
-            var _hCenter = getHCenter();
-            var _vCenter = getVCenter();
-
-            link.setWidgetLocation(widgetIdentifier, alignmentType, _xOffset, _yOffset, _hCenter, _vCenter)
-        }
-    }
-
     function _onClicked(drag) {
         if (dragging) {
             drag.target = null
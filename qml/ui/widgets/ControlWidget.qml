@@ -4,5 +4,6 @@ import QtQuick.Layouts 1.12
 import OpenHD 1.0
 
 ControlWidgetForm {
+    telemetrySubscriptions: ({ "RC_CHANNELS": 10 })
 
 }
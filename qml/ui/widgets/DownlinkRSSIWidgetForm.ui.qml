@@ -28,39 +28,6 @@ BaseWidget {
     widgetDetailHeight: 320
 
     widgetDetailComponent: Column {
-        Connections {
-            target: OpenHD
-            function onWifiAdapter0Changed(received_packet_cnt, current_signal_dbm, signal_good) {
-                card0textlower.text = Number(current_signal_dbm).toLocaleString(Qt.locale(), 'f', 0) + qsTr(" dBm");
-                card0textlower.visible = true;
-            }
-
-            function onWifiAdapter1Changed(received_packet_cnt, current_signal_dbm, signal_good) {
-                card1textlower.text = Number(current_signal_dbm).toLocaleString(Qt.locale(), 'f', 0) + qsTr(" dBm");
-                card1textlower.visible = true;
-            }
-
-            function onWifiAdapter2Changed(received_packet_cnt, current_signal_dbm, signal_good) {
-                card2textlower.text = Number(current_signal_dbm).toLocaleString(Qt.locale(), 'f', 0) + qsTr(" dBm");
-                card2textlower.visible = true;
-            }
-
-            function onWifiAdapter3Changed(received_packet_cnt, current_signal_dbm, signal_good) {
-                card3textlower.text = Number(current_signal_dbm).toLocaleString(Qt.locale(), 'f', 0) + qsTr(" dBm");
-                card3textlower.visible = true;
-            }
-
-            function onWifiAdapter4Changed(received_packet_cnt, current_signal_dbm, signal_good) {
-                card4textlower.text = Number(current_signal_dbm).toLocaleString(Qt.locale(), 'f', 0) + qsTr(" dBm");
-                card4textlower.visible = true;
-            }
-
-            function onWifiAdapter5Changed(received_packet_cnt, current_signal_dbm, signal_good) {
-                card5textlower.text = Number(current_signal_dbm).toLocaleString(Qt.locale(), 'f', 0) + qsTr(" dBm");
-                card5textlower.visible = true;
-            }
-        }
-
         Item {
             width: parent.width
             height: 32
@@ -286,171 +253,44 @@ BaseWidget {
 
             visible: settings.downlink_cards_right
 
-            Row {
-                height: 18
-                spacing: 6
-
-                Text {
-                    height: parent.height
-                    color: settings.color_shape
-                    text: "\uf381"
-                    visible: card0textlower.visible
-                    verticalAlignment: Text.AlignVCenter
-                    font.family: "Font Awesome 5 Free"
-                    styleColor: "#f7f7f7"
-                    font.pixelSize: 12
-                    horizontalAlignment: Text.AlignRight
-                }
-
-                Text {
-                    id: card0textlower
-                    height: parent.height
-                    color: settings.color_text
-                    visible: false
-                    verticalAlignment: Text.AlignVCenter
-                    font.pixelSize: 14
-                    horizontalAlignment: Text.AlignLeft
-                    wrapMode: Text.NoWrap
-                }
-            }
-
-            Row {
-                height: 18
-                spacing: 6
-
-                Text {
-                    height: parent.height
-                    color: settings.color_shape
-                    text: "\uf381"
-                    visible: card1textlower.visible
-                    verticalAlignment: Text.AlignVCenter
-                    font.family: "Font Awesome 5 Free"
-                    styleColor: "#f7f7f7"
-                    font.pixelSize: 12
-                    horizontalAlignment: Text.AlignRight
-                }
-
-                Text {
-                    id: card1textlower
-                    height: parent.height
-                    color: settings.color_text
-                    visible: false
-                    verticalAlignment: Text.AlignVCenter
-                    font.pixelSize: 14
-                    horizontalAlignment: Text.AlignLeft
-                    wrapMode: Text.NoWrap
-                }
-            }
-
-            Row {
-                height: 18
-                spacing: 6
-
-                Text {
-                    height: parent.height
-                    color: settings.color_shape
-                    text: "\uf381"
-                    visible: card2textlower.visible
-                    verticalAlignment: Text.AlignVCenter
-                    font.family: "Font Awesome 5 Free"
-                    styleColor: "#f7f7f7"
-                    font.pixelSize: 12
-                    horizontalAlignment: Text.AlignRight
-                }
-
-                Text {
-                    id: card2textlower
-                    height: parent.height
-                    color: settings.color_text
-                    visible: false
-                    verticalAlignment: Text.AlignVCenter
-                    font.pixelSize: 14
-                    horizontalAlignment: Text.AlignLeft
-                    wrapMode: Text.NoWrap
-                }
-            }
-
-            Row {
-                height: 18
-                spacing: 6
-
-                Text {
-                    height: parent.height
-                    color: settings.color_shape
-                    text: "\uf381"
-                    visible: card3textlower.visible
-                    verticalAlignment: Text.AlignVCenter
-                    font.family: "Font Awesome 5 Free"
-                    styleColor: "#f7f7f7"
-                    font.pixelSize: 12
-                    horizontalAlignment: Text.AlignRight
-                }
-
-                Text {
-                    id: card3textlower
-                    height: parent.height
-                    color: settings.color_text
-                    visible: false
-                    verticalAlignment: Text.AlignVCenter
-                    font.pixelSize: 14
-                    horizontalAlignment: Text.AlignLeft
-                    wrapMode: Text.NoWrap
-                }
-            }
-
-            Row {
-                height: 18
-                spacing: 6
-
-                Text {
-                    height: parent.height
-                    color: settings.color_shape
-                    text: "\uf381"
-                    visible: card4textlower.visible
-                    verticalAlignment: Text.AlignVCenter
-                    font.family: "Font Awesome 5 Free"
-                    styleColor: "#f7f7f7"
-                    font.pixelSize: 12
-                    horizontalAlignment: Text.AlignRight
-                }
-
-                Text {
-                    id: card4textlower
-                    height: parent.height
-                    color: settings.color_text
-                    visible: false
-                    verticalAlignment: Text.AlignVCenter
-                    font.pixelSize: 14
-                    horizontalAlignment: Text.AlignLeft
-                    wrapMode: Text.NoWrap
-                }
-            }
-
-            Row {
-                height: 18
-                spacing: 6
-
-                Text {
-                    height: parent.height
-                    color: settings.color_shape
-                    text: "\uf381"
-                    visible: card5textlower.visible
-                    verticalAlignment: Text.AlignVCenter
-                    font.family: "Font Awesome 5 Free"
-                    styleColor: "#f7f7f7"
-                    font.pixelSize: 12
-                    horizontalAlignment: Text.AlignRight
-                }
-
-                Text {
-                    id: card5textlower
-                    height: parent.height
-                    color: settings.color_text
-                    visible: false
-                    verticalAlignment: Text.AlignVCenter
-                    font.pixelSize: 14
-                    horizontalAlignment: Text.AlignLeft
-                    wrapMode: Text.NoWrap
+            Repeater {
+                model: WifiAdapterModel
+
+                Row {
+                    height: 18
+                    spacing: 6
+
+                    Text {
+                        height: parent.height
+                        color: settings.color_shape
+                        text: "\uf381"
+                        verticalAlignment: Text.AlignVCenter
+                        font.family: "Font Awesome 5 Free"
+                        styleColor: "#f7f7f7"
+                        font.pixelSize: 12
+                        horizontalAlignment: Text.AlignRight
+                    }
+
+                    Text {
+                        height: parent.height
+                        color: settings.color_text
+                        text: Number(model.current_signal_dbm).toLocaleString(Qt.locale(), 'f', 0) + qsTr(" dBm")
+                        font.bold: model.best
+                        verticalAlignment: Text.AlignVCenter
+                        font.pixelSize: 14
+                        horizontalAlignment: Text.AlignLeft
+                        wrapMode: Text.NoWrap
+                    }
+
+                    Text {
+                        height: parent.height
+                        color: settings.color_text
+                        text: qsTr("%L1 pkt/s").arg(model.packet_rate)
+                        verticalAlignment: Text.AlignVCenter
+                        font.pixelSize: 12
+                        horizontalAlignment: Text.AlignLeft
+                        wrapMode: Text.NoWrap
+                    }
                 }
             }
         }
@@ -8,6 +8,7 @@ import "../elements";
 
 MapWidgetForm {
     id: mapWidget
+    telemetrySubscriptions: ({ "GLOBAL_POSITION_INT": 5, "GPS_RAW_INT": 1 })
 
     useDragHandle: true
 
@@ -4,6 +4,7 @@ import QtQuick.Layouts 1.12
 import OpenHD 1.0
 
 ThrottleWidgetForm {
+    telemetrySubscriptions: ({ "VFR_HUD": 5 })
 
     function map(input, input_start, input_end, output_start, output_end) {
         var input_range = input_end - input_start;
@@ -1,7 +1,5 @@
 import QtQuick 2.12
 import QtQuick.Controls 2.12
-import QtQuick.Controls.Styles 1.4
-import QtQuick.Extras 1.4
 import QtQuick.Layouts 1.12
 import QtGraphicalEffects 1.12
 import QtQuick.Shapes 1.0
@@ -103,72 +101,13 @@ BaseWidget {
         opacity: settings.vsi_opacity
 
 
-        CircularGauge {
+        VsiGauge {
             id: gauge
             anchors.fill: parent
-            antialiasing: true
-
-            rotation: 270
-
-            minimumValue: settings.vsi_max*-1
-            maximumValue: settings.vsi_max
-
+            color: settings.color_shape
+            text_color: settings.color_text
+            maximum: settings.vsi_max
             value: OpenHD.vsi
-
-            style: CircularGaugeStyle {
-                labelInset: outerRadius * -.3
-                minorTickmarkCount : 0
-                // @disable-check M223
-                labelStepSize : {settings.vsi_max/5}
-                maximumValueAngle : 135
-                minimumValueAngle : -135
-
-                tickmark: Rectangle {
-                    visible: styleData.value
-                    implicitWidth: outerRadius * 0.05
-                    antialiasing: true
-                    implicitHeight: outerRadius * 0.09
-                    color: settings.color_shape
-                }
-
-                tickmarkLabel:  Text {
-                    rotation: 90
-                    //font.pixelSize: Math.max(6, outerRadius * 0.1)
-                    font.pixelSize: 9
-                    text: styleData.value
-                    color: settings.color_text
-                    antialiasing: true
-                }
-
-                needle: Rectangle {
-                    y: outerRadius * -.01 //this is the needle base closest to axis
-                    implicitWidth: outerRadius * 0.05
-                    implicitHeight: outerRadius
-                    antialiasing: true
-                    color: settings.color_text
-                }
-
-                function degreesToRadians(degrees) {
-                    return degrees * (Math.PI / 180);
-                }
-
-                background: Canvas {
-                    // @disable-check M223
-                    onPaint: {
-                    var ctx = getContext("2d");
-                    ctx.reset();
-
-                    ctx.beginPath();
-                    ctx.strokeStyle = settings.color_shape
-                    ctx.lineWidth = outerRadius * 0.02;
-
-                    ctx.arc(outerRadius, outerRadius, outerRadius - ctx.lineWidth / 2,
-                        degreesToRadians(valueToAngle(settings.vsi_max*-1) - 90),
-                        degreesToRadians(valueToAngle(settings.vsi_max) - 90));
-                    ctx.stroke();
-                    }
-                }
-            }
         }
     }
 }
@@ -0,0 +1,135 @@
+# Everything QOpenHD runs that doesn't need QML or video: telemetry ingest and parsing,
+# the microservices, settings and RC. Shared by QOpenHD.pro and headless/headless.pro so the
+# same stack can run without a display for soak and performance testing.
+
+QT += qml quick concurrent network
+
+INCLUDEPATH += $$PWD/inc
+INCLUDEPATH += $$PWD/lib
+INCLUDEPATH += $$PWD/lib/mavlink_generated/include/mavlink/v2.0
+
+INCLUDEPATH += $$PWD/lib/GeographicLib-1.50/include
+
+
+SOURCES += \
+    $$PWD/src/flightrecorder.cpp \
+    $$PWD/src/frskytelemetry.cpp \
+    $$PWD/src/gpiomicroservice.cpp \
+    $$PWD/src/ingestreactor.cpp \
+    $$PWD/src/linkanalytics.cpp \
+    $$PWD/src/linkprotocol.cpp \
+    $$PWD/src/localmessage.cpp \
+    $$PWD/src/logger.cpp \
+    $$PWD/src/ltmtelemetry.cpp \
+    $$PWD/src/mavlinkbase.cpp \
+    $$PWD/src/mavlinkrouter.cpp \
+    $$PWD/src/mavlinktelemetry.cpp \
+    $$PWD/src/migration.cpp \
+    $$PWD/src/mspprotocol.cpp \
+    $$PWD/src/msptelemetry.cpp \
+    $$PWD/src/openhd.cpp \
+    $$PWD/src/openhdrc.cpp \
+    $$PWD/src/openhdsettings.cpp \
+    $$PWD/src/openhdtelemetry.cpp \
+    $$PWD/src/powermicroservice.cpp \
+    $$PWD/src/qopenhdlink.cpp \
+    $$PWD/src/rcmapper.cpp \
+    $$PWD/src/rcsender.cpp \
+    $$PWD/src/settingssender.cpp \
+    $$PWD/src/smartporttelemetry.cpp \
+    $$PWD/src/statuslogmodel.cpp \
+    $$PWD/src/statusmicroservice.cpp \
+    $$PWD/src/telemetrydetector.cpp \
+    $$PWD/src/telemetryframing.cpp \
+    $$PWD/src/telemetryreplay.cpp \
+    $$PWD/src/telemetrysubscriptions.cpp \
+    $$PWD/src/timeseriesstore.cpp \
+    $$PWD/src/util.cpp \
+    $$PWD/src/vectortelemetry.cpp \
+    $$PWD/src/wifiadaptermodel.cpp \
+    $$PWD/src/wifibroadcaststatus.cpp
+
+HEADERS += \
+    $$PWD/inc/constants.h \
+    $$PWD/inc/flightrecorder.h \
+    $$PWD/inc/frskytelemetry.h \
+    $$PWD/inc/gpiomicroservice.h \
+    $$PWD/inc/ingestreactor.h \
+    $$PWD/inc/linkanalytics.h \
+    $$PWD/inc/linkprotocol.h \
+    $$PWD/inc/localmessage.h \
+    $$PWD/inc/localmessage_t.h \
+    $$PWD/inc/logger.h \
+    $$PWD/inc/ltmtelemetry.h \
+    $$PWD/inc/mavlinkbase.h \
+    $$PWD/inc/mavlinkrouter.h \
+    $$PWD/inc/mavlinktelemetry.h \
+    $$PWD/inc/migration.hpp \
+    $$PWD/inc/mspprotocol.h \
+    $$PWD/inc/msptelemetry.h \
+    $$PWD/inc/openhd.h \
+    $$PWD/inc/openhdrc.h \
+    $$PWD/inc/openhdsettings.h \
+    $$PWD/inc/openhdtelemetry.h \
+    $$PWD/inc/powermicroservice.h \
+    $$PWD/inc/qopenhdlink.h \
+    $$PWD/inc/rcmapper.h \
+    $$PWD/inc/rcsender.h \
+    $$PWD/inc/ringbuffer.h \
+    $$PWD/inc/settingssender.h \
+    $$PWD/inc/sharedqueue.h \
+    $$PWD/inc/smartporttelemetry.h \
+    $$PWD/inc/statuslogmodel.h \
+    $$PWD/inc/statusmicroservice.h \
+    $$PWD/inc/telemetrydetector.h \
+    $$PWD/inc/telemetryframing.h \
+    $$PWD/inc/telemetryreplay.h \
+    $$PWD/inc/telemetrystate.h \
+    $$PWD/inc/telemetrysubscriptions.h \
+    $$PWD/inc/timeseriesstore.h \
+    $$PWD/inc/triplebuffer.h \
+    $$PWD/inc/util.h \
+    $$PWD/inc/vectortelemetry.h \
+    $$PWD/inc/wifiadaptermodel.h \
+    $$PWD/inc/wifibroadcast.h \
+    $$PWD/inc/wifibroadcaststatus.h
+
+SOURCES += \
+    $$PWD/lib/GeographicLib-1.50/src/Accumulator.cpp \
+    $$PWD/lib/GeographicLib-1.50/src/AlbersEqualArea.cpp \
+    $$PWD/lib/GeographicLib-1.50/src/AzimuthalEquidistant.cpp \
+    $$PWD/lib/GeographicLib-1.50/src/CassiniSoldner.cpp \
+    $$PWD/lib/GeographicLib-1.50/src/CircularEngine.cpp \
+    $$PWD/lib/GeographicLib-1.50/src/DMS.cpp \
+    $$PWD/lib/GeographicLib-1.50/src/Ellipsoid.cpp \
+    $$PWD/lib/GeographicLib-1.50/src/EllipticFunction.cpp \
+    $$PWD/lib/GeographicLib-1.50/src/GARS.cpp \
+    $$PWD/lib/GeographicLib-1.50/src/GeoCoords.cpp \
+    $$PWD/lib/GeographicLib-1.50/src/Geocentric.cpp \
+    $$PWD/lib/GeographicLib-1.50/src/Geodesic.cpp \
+    $$PWD/lib/GeographicLib-1.50/src/GeodesicExact.cpp \
+    $$PWD/lib/GeographicLib-1.50/src/GeodesicExactC4.cpp \
+    $$PWD/lib/GeographicLib-1.50/src/GeodesicLine.cpp \
+    $$PWD/lib/GeographicLib-1.50/src/GeodesicLineExact.cpp \
+    $$PWD/lib/GeographicLib-1.50/src/Geohash.cpp \
+    $$PWD/lib/GeographicLib-1.50/src/Geoid.cpp \
+    $$PWD/lib/GeographicLib-1.50/src/Georef.cpp \
+    $$PWD/lib/GeographicLib-1.50/src/Gnomonic.cpp \
+    $$PWD/lib/GeographicLib-1.50/src/GravityCircle.cpp \
+    $$PWD/lib/GeographicLib-1.50/src/GravityModel.cpp \
+    $$PWD/lib/GeographicLib-1.50/src/LambertConformalConic.cpp \
+    $$PWD/lib/GeographicLib-1.50/src/LocalCartesian.cpp \
+    $$PWD/lib/GeographicLib-1.50/src/MGRS.cpp \
+    $$PWD/lib/GeographicLib-1.50/src/MagneticCircle.cpp \
+    $$PWD/lib/GeographicLib-1.50/src/MagneticModel.cpp \
+    $$PWD/lib/GeographicLib-1.50/src/Math.cpp \
+    $$PWD/lib/GeographicLib-1.50/src/NormalGravity.cpp \
+    $$PWD/lib/GeographicLib-1.50/src/OSGB.cpp \
+    $$PWD/lib/GeographicLib-1.50/src/PolarStereographic.cpp \
+    $$PWD/lib/GeographicLib-1.50/src/PolygonArea.cpp \
+    $$PWD/lib/GeographicLib-1.50/src/Rhumb.cpp \
+    $$PWD/lib/GeographicLib-1.50/src/SphericalEngine.cpp \
+    $$PWD/lib/GeographicLib-1.50/src/TransverseMercator.cpp \
+    $$PWD/lib/GeographicLib-1.50/src/TransverseMercatorExact.cpp \
+    $$PWD/lib/GeographicLib-1.50/src/UTMUPS.cpp \
+    $$PWD/lib/GeographicLib-1.50/src/Utility.cpp
@@ -0,0 +1,314 @@
+#include "flightrecorder.h"
+
+#include <QtNetwork>
+#include <QThread>
+#include <QDir>
+#include <QStandardPaths>
+
+#include <chrono>
+#include <string.h>
+
+#include "constants.h"
+
+
+int64_t flight_record_monotonic_ns() {
+    auto now = std::chrono::steady_clock::now().time_since_epoch();
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(now).count();
+}
+
+
+/*
+ * Single-producer, single-consumer byte ring holding records in the same layout they have on
+ * disk. The producer is whichever ingest thread claimed it, the consumer is the recorder thread.
+ */
+class FlightRecorderRing {
+public:
+    static const uint32_t Size = 512 * 1024;
+
+    bool push(FlightRecordType type, uint16_t port, const char* data, uint16_t length) {
+        uint32_t total = flight_record_padded_size(length);
+        uint64_t head = m_head.load(std::memory_order_relaxed);
+        uint64_t tail = m_tail.load(std::memory_order_acquire);
+
+        if (Size - (head - tail) < total) {
+            return false;
+        }
+
+        flight_record_header_t header;
+        memset(&header, 0, sizeof(header));
+        header.timestamp_ns = flight_record_monotonic_ns();
+        header.length = length;
+        header.port = port;
+        header.type = type;
+
+        write(head, &header, sizeof(header));
+        write(head + sizeof(header), data, length);
+
+        m_head.store(head + total, std::memory_order_release);
+        return true;
+    }
+
+    uint64_t head() const {
+        return m_head.load(std::memory_order_acquire);
+    }
+
+    uint64_t tail() const {
+        return m_tail.load(std::memory_order_relaxed);
+    }
+
+    void release(uint64_t tail) {
+        m_tail.store(tail, std::memory_order_release);
+    }
+
+    void read(uint64_t position, void* out, uint32_t length) const {
+        uint32_t offset = position % Size;
+        uint32_t first = qMin(length, Size - offset);
+        memcpy(out, m_data + offset, first);
+        memcpy((char*)out + first, m_data, length - first);
+    }
+
+private:
+    void write(uint64_t position, const void* in, uint32_t length) {
+        uint32_t offset = position % Size;
+        uint32_t first = qMin(length, Size - offset);
+        memcpy(m_data + offset, in, first);
+        memcpy(m_data, (const char*)in + first, length - first);
+    }
+
+    alignas(64) std::atomic<uint64_t> m_head { 0 };
+    alignas(64) std::atomic<uint64_t> m_tail { 0 };
+    char m_data[Size];
+};
+
+
+static const qint64 SegmentSize = 16 * 1024 * 1024;
+
+
+static FlightRecorder* _instance = nullptr;
+
+FlightRecorder* FlightRecorder::instance() {
+    if (_instance == nullptr) {
+        _instance = new FlightRecorder();
+    }
+    return _instance;
+}
+
+FlightRecorder::FlightRecorder(QObject *parent): QObject(parent), m_ring_count(0), m_enabled(false), m_dropped(0) {
+    qDebug() << "FlightRecorder::FlightRecorder()";
+    for (int i = 0; i < MaxRings; i++) {
+        m_rings[i].store(nullptr);
+    }
+}
+
+
+QString FlightRecorder::recordingDirectory() {
+    return QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation) + "/recordings";
+}
+
+
+void FlightRecorder::onStarted() {
+    qDebug() << "FlightRecorder::onStarted()";
+
+    QSettings settings;
+    auto enable_flight_recorder = settings.value("enable_flight_recorder", QVariant(true)).toBool();
+    auto budget_mb = settings.value("flight_recorder_budget_mb", QVariant(256)).toInt();
+
+    m_budget = qMax(budget_mb, 1) * 1024LL * 1024LL;
+    m_segment_size = qMin(SegmentSize, m_budget);
+
+    QDir().mkpath(recordingDirectory());
+
+    timer = new QTimer(this);
+    connect(timer, &QTimer::timeout, this, &FlightRecorder::flush);
+    timer->start(100);
+
+    set_enabled(enable_flight_recorder);
+}
+
+
+void FlightRecorder::onStopped() {
+    qDebug() << "FlightRecorder::onStopped()";
+    m_enabled.store(false);
+    if (timer) {
+        timer->stop();
+    }
+    flush();
+    closeSegment();
+}
+
+
+bool FlightRecorder::get_enabled() const {
+    return m_enabled.load(std::memory_order_relaxed);
+}
+
+
+void FlightRecorder::set_enabled(bool enabled) {
+    m_enabled.store(enabled, std::memory_order_relaxed);
+    emit enabled_changed(enabled);
+}
+
+
+quint64 FlightRecorder::get_dropped_records() const {
+    return m_dropped.load(std::memory_order_relaxed);
+}
+
+
+void FlightRecorder::set_recording_path(QString recording_path) {
+    m_recording_path = recording_path;
+    emit recording_path_changed(m_recording_path);
+}
+
+
+/*
+ * Called from the ingest threads. The only time this does anything other than copy into the
+ * calling thread's ring is the first call on a new thread, which allocates that ring.
+ */
+void FlightRecorder::record(FlightRecordType type, uint16_t port, const char* data, int length) {
+    if (!m_enabled.load(std::memory_order_relaxed)) {
+        return;
+    }
+
+    static thread_local FlightRecorderRing* ring = nullptr;
+
+    if (ring == nullptr) {
+        int index = m_ring_count.fetch_add(1);
+        if (index >= MaxRings) {
+            m_ring_count.fetch_sub(1);
+            m_dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        ring = new FlightRecorderRing();
+        m_rings[index].store(ring, std::memory_order_release);
+    }
+
+    if (length > 0xFFFF) {
+        length = 0xFFFF;
+    }
+
+    if (!ring->push(type, port, data, (uint16_t)length)) {
+        m_dropped.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+
+void FlightRecorder::flush() {
+    int ring_count = qMin(m_ring_count.load(), (int)MaxRings);
+
+    for (int i = 0; i < ring_count; i++) {
+        auto ring = m_rings[i].load(std::memory_order_acquire);
+        if (ring == nullptr) {
+            continue;
+        }
+
+        uint64_t head = ring->head();
+        uint64_t tail = ring->tail();
+
+        while (tail < head) {
+            flight_record_header_t header;
+            ring->read(tail, &header, sizeof(header));
+            uint32_t total = flight_record_padded_size(header.length);
+
+            // always leave room for a zeroed header after the last record
+            if (m_segment_data == nullptr || m_segment_pos + total + (qint64)sizeof(flight_record_header_t) > m_segment_size) {
+                closeSegment();
+                if (!m_enabled.load(std::memory_order_relaxed) || !openSegment()) {
+                    // nowhere to put it, discard what is queued
+                    tail = head;
+                    break;
+                }
+            }
+
+            ring->read(tail, m_segment_data + m_segment_pos, total);
+            m_segment_pos += total;
+            tail += total;
+        }
+
+        ring->release(tail);
+    }
+
+    auto dropped = m_dropped.load(std::memory_order_relaxed);
+    if (dropped != m_reported_dropped) {
+        m_reported_dropped = dropped;
+        emit dropped_records_changed(dropped);
+    }
+}
+
+
+bool FlightRecorder::openSegment() {
+    enforceBudget();
+
+    auto name = QString("%1-%2.qrec").arg(QDateTime::currentDateTime().toString("yyyyMMdd-hhmmss")).arg(m_segment_index++, 4, 10, QChar('0'));
+    auto path = recordingDirectory() + "/" + name;
+
+    m_segment.setFileName(path);
+    if (!m_segment.open(QIODevice::ReadWrite | QIODevice::Truncate)) {
+        qDebug() << "FlightRecorder: failed to open" << path;
+        return false;
+    }
+
+    if (!m_segment.resize(m_segment_size)) {
+        qDebug() << "FlightRecorder: failed to preallocate" << path;
+        m_segment.close();
+        m_segment.remove();
+        return false;
+    }
+
+    m_segment_data = m_segment.map(0, m_segment_size);
+    if (m_segment_data == nullptr) {
+        qDebug() << "FlightRecorder: failed to map" << path;
+        m_segment.close();
+        m_segment.remove();
+        return false;
+    }
+
+    flight_record_segment_header_t header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, FLIGHT_RECORD_MAGIC, sizeof(FLIGHT_RECORD_MAGIC));
+    header.version = FLIGHT_RECORD_VERSION;
+    header.header_size = sizeof(header);
+    header.wall_clock_ms = QDateTime::currentMSecsSinceEpoch();
+    header.monotonic_ns = flight_record_monotonic_ns();
+
+    memcpy(m_segment_data, &header, sizeof(header));
+    m_segment_pos = sizeof(header);
+
+    set_recording_path(path);
+    return true;
+}
+
+
+void FlightRecorder::closeSegment() {
+    if (m_segment_data == nullptr) {
+        return;
+    }
+    m_segment.unmap(m_segment_data);
+    m_segment_data = nullptr;
+
+    // give back the preallocated space that wasn't used
+    m_segment.resize(m_segment_pos);
+    m_segment.close();
+    m_segment_pos = 0;
+}
+
+
+/*
+ * Removes the oldest segments until there is room for a new one within the configured budget.
+ * Segment names start with their creation time, so sorting by name sorts them by age.
+ */
+void FlightRecorder::enforceBudget() {
+    QDir dir(recordingDirectory());
+    auto segments = dir.entryInfoList(QStringList() << "*.qrec", QDir::Files, QDir::Name);
+
+    qint64 total = 0;
+    for (auto &segment : segments) {
+        total += segment.size();
+    }
+
+    for (auto &segment : segments) {
+        if (total + m_segment_size <= m_budget) {
+            break;
+        }
+        total -= segment.size();
+        QFile::remove(segment.absoluteFilePath());
+    }
+}
@@ -16,6 +16,7 @@
 #include "constants.h"
 
 #include "openhd.h"
+#include "ingestreactor.h"
 
 
 
@@ -58,55 +59,61 @@
 #define ID_VERT_SPEED 0x30 //opentx vario
 
 
-FrSkyTelemetry::FrSkyTelemetry(QObject *parent): QObject(parent) {
+FrSkyTelemetry::FrSkyTelemetry(quint16 port, QObject *parent): QObject(parent), m_framer(FrSkyFrameProtocol), m_port(port) {
     qDebug() << "FrSkyTelemetry::FrSkyTelemetry()";
 
-    frskySocket = new QUdpSocket(this);
-    frskySocket->bind(QHostAddress::Any, 5002);
-    connect(frskySocket, &QUdpSocket::readyRead, this, &FrSkyTelemetry::processFrSkyDatagrams);
+    OpenHD::instance()->registerTelemetryPublisher(&m_telemetry);
+    IngestReactor::instance()->addPort(m_port, this);
 }
 
 
-void FrSkyTelemetry::processFrSkyDatagrams() {
-    QByteArray datagram;
+FrSkyTelemetry::~FrSkyTelemetry() {
+    IngestReactor::instance()->removePort(m_port);
+    OpenHD::instance()->unregisterTelemetryPublisher(&m_telemetry);
+}
+
 
-    while (frskySocket->hasPendingDatagrams()) {
-        datagram.resize(int(frskySocket->pendingDatagramSize()));
-        frskySocket->readDatagram(datagram.data(), datagram.size());
-        frsky_parse_buffer((uint8_t*)datagram.data(), datagram.length());
+// called on the ingest thread
+void FrSkyTelemetry::ingestDatagram(const uint8_t* data, int size) {
+    for (int i = 0; i < size; i++) {
+        if (m_framer.push(data[i])) {
+            processFrSkyMessage(m_framer.type(), m_framer.payload());
+        }
     }
 }
 
 
-void FrSkyTelemetry::processFrSkyMessage() {
-    uint16_t data;
+void FrSkyTelemetry::ingestFinished() {
+    m_telemetry.publish();
+}
+
+
+void FrSkyTelemetry::processFrSkyMessage(uint8_t id, FrameReader payload) {
+    uint16_t data = payload.u16();
 
-    data = *(uint16_t*)(state.pkg+1);
-    switch(state.pkg[0]) {
+    switch(id) {
         case ID_VOLTAGE_AMP: {
             // no idea what this is here for, it was commented out in the old OSD
-            //uint16_t val = (state.pkg[2] >> 8) | ((state.pkg[1] & 0xf) << 8);
+            //uint16_t val = (pkg[2] >> 8) | ((pkg[1] & 0xf) << 8);
             //float battery = 3.0f * val / 500.0f;
             //td->voltage = battery;
             auto battery_voltage = data / 10.0f;
 
-            OpenHD::instance()->set_battery_voltage(battery_voltage);
+            m_telemetry.set_battery_voltage(battery_voltage);
 
-            // no current provided? is it in the 3rd byte of state.pkg?
-            //OpenHD::instance()->set_battery_current(ampere);
+            // no current provided? is it in the 3rd byte of the frame?
+            //m_telemetry.set_battery_current(ampere);
 
             QSettings settings;
             auto battery_cells = settings.value("battery_cells", QVariant(3)).toInt();
             int battery_percent = lipo_battery_voltage_to_percent(battery_cells, battery_voltage);
-            OpenHD::instance()->set_battery_percent(battery_percent);
-            QString battery_gauge_glyph = battery_gauge_glyph_from_percentage(battery_percent);
-            OpenHD::instance()->set_battery_gauge(battery_gauge_glyph);
+            m_telemetry.set_battery_percent(battery_percent);
 
             break;
         }
         case ID_ALTITUDE_BP: {
             auto rel_altitude = data;
-            OpenHD::instance()->set_alt_rel(rel_altitude);
+            m_telemetry.set_alt_rel(rel_altitude);
             break;
         }
         case ID_ALTITUDE_AP: {
@@ -116,60 +123,60 @@ void FrSkyTelemetry::processFrSkyMessage() {
         }
         case ID_GPS_ALTITUDE_BP: {
             auto gps_altitude = data;
-            OpenHD::instance()->set_alt_msl(gps_altitude);
+            m_telemetry.set_alt_msl(gps_altitude);
             break;
         }
         case ID_LONGITUDE_BP: {
             _lon = data / 100;
             _lon += 1.0 * (data - _lon * 100) / 60;
-            OpenHD::instance()->set_lon((ew == 'E' ? 1 : -1) * _lon);
+            m_telemetry.set_lon((ew == 'E' ? 1 : -1) * _lon);
             break;
         }
         case ID_LONGITUDE_AP: {
             _lon +=  1.0 * data / 60 / 10000;
-            OpenHD::instance()->set_lon((ew == 'E' ? 1 : -1) * _lon);
+            m_telemetry.set_lon((ew == 'E' ? 1 : -1) * _lon);
             break;
         }
         case ID_LATITUDE_BP: {
             _lat = data / 100;
             _lat += 1.0 * (data - _lat * 100) / 60;
-            OpenHD::instance()->set_lat((ns == 'N' ? 1 : -1) * _lat);
+            m_telemetry.set_lat((ns == 'N' ? 1 : -1) * _lat);
             break;
         }
         case ID_LATITUDE_AP: {
             _lat +=  1.0 * data / 60 / 10000;
-            OpenHD::instance()->set_lat((ns == 'N' ? 1 : -1) * _lat);
+            m_telemetry.set_lat((ns == 'N' ? 1 : -1) * _lat);
             break;
         }
         case ID_COURSE_BP: {
             auto heading = data;
-            OpenHD::instance()->set_hdg(heading);
+            m_telemetry.set_hdg(heading);
             break;
         }
         case ID_GPS_SPEED_BP: {
             _speed = 1.0 * data / 0.0194384449;
-            OpenHD::instance()->set_speed((int)_speed);
+            m_telemetry.set_speed((int)_speed);
             break;
         }
         case ID_GPS_SPEED_AP: {
             _speed += 1.0 * data / 1.94384449; //now we are in cm/s
             _speed = _speed / 100 / 1000 * 3600; //now we are in km/h
-            OpenHD::instance()->set_speed((int)_speed);
+            m_telemetry.set_speed((int)_speed);
             break;
         }
         case ID_ACC_X: {
             auto x = data;
-            OpenHD::instance()->set_vx(x);
+            m_telemetry.set_vx(x);
             break;
         }
         case ID_ACC_Y: {
             auto y = data;
-            OpenHD::instance()->set_vy(y);
+            m_telemetry.set_vy(y);
             break;
         }
         case ID_ACC_Z: {
             auto z = data;
-            OpenHD::instance()->set_vz(z);
+            m_telemetry.set_vz(z);
             break;
         }
         case ID_E_W: {
@@ -192,45 +199,3 @@ void FrSkyTelemetry::set_last_heartbeat(QString last_heartbeat) {
     emit last_heartbeat_changed(m_last_heartbeat);
 }
 
-
-void FrSkyTelemetry::frsky_parse_buffer(uint8_t *buf, int buflen) {
-    int i;
-
-    for (i = 0; i < buflen; ++i) {
-        uint8_t ch = buf[i];
-        switch(state.sm_state) {
-            case 0: {
-                if (ch == 0x5e)
-                    state.sm_state = 1;
-                break;
-            }
-            case 1: {
-                if (ch == 0x5e)
-                    state.sm_state = 2;
-                else
-                    state.sm_state = 0;
-                break;
-            }
-            case 2: {
-                if (ch == 0x5e) {
-                    state.pkg_pos = 0;
-                    processFrSkyMessage();
-                }
-                else {
-                    if(state.pkg_pos >= sizeof(state.pkg)) {
-                        state.pkg_pos = 0;
-                        state.sm_state = 0;
-                    } else {
-                        state.pkg[state.pkg_pos] = ch;
-                        state.pkg_pos++;
-                    }
-                }
-                break;
-            }
-            default: {
-                state.sm_state = 0;
-                break;
-            }
-        }
-    }
-}
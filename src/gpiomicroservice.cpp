@@ -14,6 +14,7 @@
 
 #include <openhd/mavlink.h>
 
+#include "logger.h"
 #include "util.h"
 #include "constants.h"
 
@@ -140,7 +141,8 @@ void GPIOMicroservice::onProcessMavlinkMessage(mavlink_message_t msg) {
             break;
         }
         default: {
-            printf("GPIOMicroservice received unmatched message with ID %d, sequence: %d from component %d of system %d\n", msg.msgid, msg.seq, msg.compid, msg.sysid);
+            LOG_EVENT(LogEventUnmatchedMavlink, msg.msgid, msg.sysid << 8 | msg.compid);
+            LOG_RATE_LIMITED(1000, QtDebugMsg, "GPIOMicroservice received unmatched message with ID %d, sequence: %d from component %d of system %d", msg.msgid, msg.seq, msg.compid, msg.sysid);
             break;
         }
     }
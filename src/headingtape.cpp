@@ -0,0 +1,147 @@
+#include "headingtape.h"
+
+#include <QtMath>
+
+
+static const int HeadingRange = 180;
+
+// "home" in Font Awesome 5
+static const QString HomeIcon = QString(QChar(0xf015));
+
+
+static int wrapDegrees(int degrees) {
+    degrees %= 360;
+    if (degrees < 0) {
+        degrees += 360;
+    }
+    return degrees;
+}
+
+
+HeadingTape::HeadingTape(QQuickItem *parent): OSDInstrument(parent) {}
+
+
+void HeadingTape::set_heading(double heading) {
+    if (m_heading == heading) {
+        return;
+    }
+    m_heading = heading;
+    emit heading_changed(m_heading);
+    update();
+}
+
+
+void HeadingTape::set_ladder_text(bool ladder_text) {
+    m_ladder_text = ladder_text;
+    emit ladder_text_changed(m_ladder_text);
+    update();
+}
+
+
+void HeadingTape::set_direction_names(QStringList direction_names) {
+    m_direction_names = direction_names;
+    emit direction_names_changed(m_direction_names);
+    update();
+}
+
+
+void HeadingTape::set_show_ticks(bool show_ticks) {
+    m_show_ticks = show_ticks;
+    emit show_ticks_changed(m_show_ticks);
+    update();
+}
+
+
+void HeadingTape::set_compass_gap(bool compass_gap) {
+    m_compass_gap = compass_gap;
+    emit compass_gap_changed(m_compass_gap);
+    update();
+}
+
+
+void HeadingTape::set_show_home(bool show_home) {
+    m_show_home = show_home;
+    emit show_home_changed(m_show_home);
+    update();
+}
+
+
+void HeadingTape::set_home_heading(double home_heading) {
+    if (m_home_heading == home_heading) {
+        return;
+    }
+    m_home_heading = home_heading;
+    emit home_heading_changed(m_home_heading);
+    if (m_show_home) {
+        update();
+    }
+}
+
+
+QSGNode* HeadingTape::updatePaintNode(QSGNode* old, UpdatePaintNodeData* data) {
+    Q_UNUSED(data)
+
+    auto node = instrumentNode(old);
+    setShapeColor(node->shapes, m_color);
+
+    m_vertices.clear();
+    beginLabels(node);
+
+    const qreal center = width() / 2;
+    const float y = 25;
+    const qreal y_label = 22;
+    const double ratio = width() / HeadingRange;
+
+    const auto font = ladderFont();
+    QFont home_font("Font Awesome 5 Free");
+    home_font.setPixelSize(14);
+
+    const int home = wrapDegrees(qRound(m_home_heading));
+    bool home_drawn = false;
+
+    for (int k = qCeil(m_heading - HeadingRange / 2); k <= qFloor(m_heading + HeadingRange / 2); k++) {
+        float x = center + (k - m_heading) * ratio;
+        int direction = wrapDegrees(k);
+
+        if (m_show_home && direction == home) {
+            addLabel(node, HomeIcon, home_font, m_color, x, y_label, Qt::AlignHCenter);
+            home_drawn = true;
+        }
+
+        if (!m_show_ticks) {
+            continue;
+        }
+
+        if (k % 30 == 0) {
+            appendRect(m_vertices, x, y, 3, 8);
+        } else if (k % 15 == 0) {
+            appendRect(m_vertices, x, y + 3, 2, 5);
+        } else {
+            continue;
+        }
+
+        // don't draw through the heading widget's pointer
+        if (m_compass_gap && x >= center - 26 && x <= center + 31) {
+            continue;
+        }
+
+        if (direction % 45 == 0) {
+            int index = direction / 45;
+            auto text = m_ladder_text && index < m_direction_names.size() ? m_direction_names.at(index) : QString::number(direction);
+            addLabel(node, text, font, m_color, x, y_label, Qt::AlignHCenter);
+        }
+    }
+
+    // home is behind, put it on the edge it's closest to
+    if (m_show_home && !home_drawn) {
+        auto left = wrapDegrees(qRound(m_heading) - home);
+        auto right = wrapDegrees(home - qRound(m_heading));
+        auto x = left < right ? 7 : width() - 7;
+        addLabel(node, HomeIcon, home_font, m_color, x, y_label, Qt::AlignHCenter);
+    }
+
+    commitShapes(node->shapes, m_vertices);
+    endLabels(node);
+
+    return node;
+}
@@ -0,0 +1,301 @@
+#include "ingestreactor.h"
+
+#include <QtNetwork>
+
+#if defined(INGEST_REACTOR_EPOLL)
+#include <sys/epoll.h>
+#include <netinet/in.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#include <string.h>
+#endif
+
+
+static IngestReactor* _instance = nullptr;
+
+IngestReactor* IngestReactor::instance() {
+    if (_instance == nullptr) {
+        _instance = new IngestReactor();
+    }
+    return _instance;
+}
+
+
+IngestReactor::IngestReactor(QObject *parent): QObject(parent) {
+    qDebug() << "IngestReactor::IngestReactor()";
+
+#if defined(INGEST_REACTOR_EPOLL)
+    /*
+     * Created up front rather than in onStarted() so ports can be added before the thread is
+     * running, epoll_ctl() is safe to call while another thread is polling the set.
+     */
+    m_epoll = epoll_create1(EPOLL_CLOEXEC);
+
+    for (int i = 0; i < BatchSize; i++) {
+        m_vectors[i].iov_base = m_buffers[i];
+        m_vectors[i].iov_len = MaxDatagramSize;
+    }
+#endif
+}
+
+
+IngestReactor::~IngestReactor() {
+#if defined(INGEST_REACTOR_EPOLL)
+    for (auto it = m_ports.constBegin(); it != m_ports.constEnd(); ++it) {
+        close(it.key());
+    }
+    close(m_epoll);
+#endif
+}
+
+
+void IngestReactor::onStarted() {
+    qDebug() << "IngestReactor::onStarted()";
+
+#if defined(INGEST_REACTOR_EPOLL)
+    // the epoll fd is readable whenever any socket in the set is
+    m_notifier = new QSocketNotifier(m_epoll, QSocketNotifier::Read, this);
+    connect(m_notifier, QOverload<int>::of(&QSocketNotifier::activated), this, [this] {
+        poll();
+    });
+#endif
+}
+
+
+void IngestReactor::onStopped() {
+    QMetaObject::invokeMethod(this, [this] {
+        thread()->quit();
+    }, Qt::QueuedConnection);
+}
+
+
+void IngestReactor::beginDispatch(IngestHandler* handler) {
+    m_dispatching = handler;
+}
+
+
+void IngestReactor::endDispatch() {
+    m_dispatching = nullptr;
+    m_dispatch_done.wakeAll();
+}
+
+
+/*
+ * A handler removing its own port is being called right now on this very thread, waiting
+ * for it to return would never end.
+ */
+void IngestReactor::waitForDispatch(IngestHandler* handler) {
+    if (handler == nullptr || QThread::currentThread() == thread()) {
+        return;
+    }
+    while (m_dispatching == handler) {
+        m_dispatch_done.wait(&m_mutex);
+    }
+}
+
+
+#if defined(INGEST_REACTOR_EPOLL)
+bool IngestReactor::addPort(quint16 port, IngestHandler* handler) {
+    int fd = socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        qDebug() << "IngestReactor: failed to create socket for port" << port;
+        return false;
+    }
+
+    int reuse = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+    sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_ANY);
+    address.sin_port = htons(port);
+
+    if (bind(fd, (sockaddr*)&address, sizeof(address)) < 0) {
+        qDebug() << "IngestReactor: failed to bind port" << port << strerror(errno);
+        close(fd);
+        return false;
+    }
+
+    QMutexLocker locker(&m_mutex);
+    m_ports.insert(fd, { port, handler });
+
+    epoll_event event;
+    memset(&event, 0, sizeof(event));
+    event.events = EPOLLIN;
+    event.data.fd = fd;
+    epoll_ctl(m_epoll, EPOLL_CTL_ADD, fd, &event);
+
+    return true;
+}
+
+
+void IngestReactor::removePort(quint16 port) {
+    QMutexLocker locker(&m_mutex);
+    for (auto it = m_ports.begin(); it != m_ports.end(); ++it) {
+        if (it.value().port != port) {
+            continue;
+        }
+        auto fd = it.key();
+        auto handler = it.value().handler;
+
+        epoll_ctl(m_epoll, EPOLL_CTL_DEL, fd, nullptr);
+        m_ports.erase(it);
+
+        if (QThread::currentThread() == thread() && m_dispatching == handler) {
+            // drain() may still be reading it, the fd number mustn't be reused before it's done
+            m_closing.append(fd);
+            return;
+        }
+
+        waitForDispatch(handler);
+        close(fd);
+        return;
+    }
+}
+
+
+void IngestReactor::poll() {
+    epoll_event events[16];
+
+    int count = epoll_wait(m_epoll, events, 16, 0);
+    if (count < 0) {
+        if (errno != EINTR) {
+            qDebug() << "IngestReactor: epoll_wait failed" << strerror(errno);
+        }
+        return;
+    }
+
+    m_wakeup_count.fetch_add(1, std::memory_order_relaxed);
+
+    for (int i = 0; i < count; i++) {
+        drain(events[i].data.fd);
+    }
+}
+
+
+void IngestReactor::drain(int fd) {
+    IngestHandler* handler;
+    {
+        QMutexLocker locker(&m_mutex);
+        // the port may have been removed since epoll_wait() returned
+        auto it = m_ports.constFind(fd);
+        if (it == m_ports.constEnd()) {
+            return;
+        }
+        handler = it.value().handler;
+        beginDispatch(handler);
+    }
+
+    int received;
+    do {
+        for (int i = 0; i < BatchSize; i++) {
+            memset(&m_messages[i], 0, sizeof(mmsghdr));
+            m_messages[i].msg_hdr.msg_iov = &m_vectors[i];
+            m_messages[i].msg_hdr.msg_iovlen = 1;
+        }
+
+        received = recvmmsg(fd, m_messages, BatchSize, MSG_DONTWAIT, nullptr);
+        if (received <= 0) {
+            break;
+        }
+
+        for (int i = 0; i < received; i++) {
+            handler->ingestDatagram(m_buffers[i], int(m_messages[i].msg_len));
+        }
+        m_datagram_count.fetch_add(received, std::memory_order_relaxed);
+
+        // a handler, or another thread, may have removed the port in the meantime
+        QMutexLocker locker(&m_mutex);
+        if (!m_ports.contains(fd)) {
+            break;
+        }
+    } while (received == BatchSize);
+
+    handler->ingestFinished();
+
+    QMutexLocker locker(&m_mutex);
+    endDispatch();
+    for (auto closing : m_closing) {
+        close(closing);
+    }
+    m_closing.clear();
+}
+
+#else
+
+bool IngestReactor::addPort(quint16 port, IngestHandler* handler) {
+    {
+        QMutexLocker locker(&m_mutex);
+        m_handlers.insert(port, handler);
+    }
+
+    // sockets have to be created on the thread that reads them
+    QMetaObject::invokeMethod(this, [this, port] {
+        QMutexLocker locker(&m_mutex);
+        if (!m_handlers.contains(port)) {
+            // removed again before we got to it
+            return;
+        }
+
+        auto socket = new QUdpSocket(this);
+        if (!socket->bind(QHostAddress::Any, port)) {
+            qDebug() << "IngestReactor: failed to bind port" << port;
+            delete socket;
+            return;
+        }
+
+        connect(socket, &QUdpSocket::readyRead, this, [this, socket, port] {
+            IngestHandler* handler;
+            {
+                QMutexLocker locker(&m_mutex);
+                handler = m_handlers.value(port);
+                if (handler == nullptr) {
+                    return;
+                }
+                beginDispatch(handler);
+            }
+
+            QByteArray datagram;
+            m_wakeup_count.fetch_add(1, std::memory_order_relaxed);
+
+            while (socket->hasPendingDatagrams()) {
+                datagram.resize(int(socket->pendingDatagramSize()));
+                socket->readDatagram(datagram.data(), datagram.size());
+                handler->ingestDatagram((const uint8_t*)datagram.constData(), datagram.size());
+                m_datagram_count.fetch_add(1, std::memory_order_relaxed);
+
+                // the socket is only deleted later, but the handler may be gone
+                QMutexLocker locker(&m_mutex);
+                if (m_handlers.value(port) != handler) {
+                    break;
+                }
+            }
+
+            handler->ingestFinished();
+
+            QMutexLocker locker(&m_mutex);
+            endDispatch();
+        });
+
+        m_sockets.insert(port, socket);
+    }, Qt::QueuedConnection);
+
+    return true;
+}
+
+
+void IngestReactor::removePort(quint16 port) {
+    QMutexLocker locker(&m_mutex);
+    auto handler = m_handlers.take(port);
+
+    auto socket = m_sockets.take(port);
+    if (socket != nullptr) {
+        socket->deleteLater();
+    }
+
+    waitForDispatch(handler);
+}
+
+#endif
@@ -0,0 +1,89 @@
+#include "laddertape.h"
+
+
+LadderTape::LadderTape(QQuickItem *parent): OSDInstrument(parent) {
+    // the canvas this replaces cut off whatever fell outside it
+    setClip(true);
+}
+
+
+void LadderTape::set_value(double value) {
+    if (m_value == value) {
+        return;
+    }
+    // the ladder only moves in whole units
+    bool moved = qRound(m_value) != qRound(value);
+    m_value = value;
+    emit value_changed(m_value);
+    if (moved) {
+        update();
+    }
+}
+
+
+void LadderTape::set_range(int range) {
+    m_range = range;
+    emit range_changed(m_range);
+    update();
+}
+
+
+void LadderTape::set_minimum(int minimum) {
+    m_minimum = minimum;
+    emit minimum_changed(m_minimum);
+    update();
+}
+
+
+void LadderTape::set_mirrored(bool mirrored) {
+    m_mirrored = mirrored;
+    emit mirrored_changed(m_mirrored);
+    update();
+}
+
+
+QSGNode* LadderTape::updatePaintNode(QSGNode* old, UpdatePaintNodeData* data) {
+    Q_UNUSED(data)
+
+    auto node = instrumentNode(old);
+    setShapeColor(node->shapes, m_color);
+
+    m_vertices.clear();
+    beginLabels(node);
+
+    if (m_range > 0 && height() > 0) {
+        const float tick_x = m_mirrored ? 32 : 6;
+        const float minor_tick_x = m_mirrored ? tick_x + 5 : tick_x;
+        const float marker_offset = m_mirrored ? 12 : 15;
+        const qreal label_x = m_mirrored ? 10 : 25;
+
+        const auto font = ladderFont();
+        const int value = qRound(m_value);
+        const double y_position = height() / 2 + 11;
+        const double ratio = height() / m_range;
+
+        for (int k = value - m_range / 2; k <= value + m_range / 2; k++) {
+            float y = y_position - (k - value) * ratio;
+
+            if (k % 10 == 0) {
+                if (k >= 0) {
+                    appendRect(m_vertices, tick_x, y, 12, 3);
+                    // the current value is in the pointer, no label underneath it
+                    if (k > value + 5 || k < value - 5) {
+                        addLabel(node, QString::number(k), font, m_color, label_x, y + 6, Qt::AlignLeft);
+                    }
+                }
+                if (k < m_minimum) {
+                    appendRect(m_vertices, tick_x, y - marker_offset, 15, 15);
+                }
+            } else if (k % 5 == 0 && k > m_minimum) {
+                appendRect(m_vertices, minor_tick_x, y, 7, 2);
+            }
+        }
+    }
+
+    commitShapes(node->shapes, m_vertices);
+    endLabels(node);
+
+    return node;
+}
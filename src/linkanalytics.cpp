@@ -0,0 +1,211 @@
+#include "linkanalytics.h"
+
+#include <algorithm>
+
+
+// how much of each new 1 second value goes into the EWMA
+static const double EWMAWeight = 0.2;
+
+
+static LinkAnalytics* _instance = nullptr;
+
+LinkAnalytics* LinkAnalytics::instance() {
+    if (_instance == nullptr) {
+        _instance = new LinkAnalytics();
+    }
+    return _instance;
+}
+
+
+LinkAnalytics::LinkAnalytics(QObject *parent): QObject(parent) {
+    qDebug() << "LinkAnalytics::LinkAnalytics()";
+    m_clock.start();
+
+    QStringList columns;
+    for (int i = 0; i < LinkMetricCount; i++) {
+        columns.append(metricName(LinkMetric(i)));
+    }
+    m_store = new TimeSeriesStore(columns, HistoryRetention, this);
+    m_store->set_span(ChartSpan);
+
+    m_timer = new QTimer(this);
+    connect(m_timer, &QTimer::timeout, this, &LinkAnalytics::updateStatistics);
+    m_timer->start(1000);
+}
+
+
+const char* LinkAnalytics::metricName(LinkMetric metric) {
+    switch (metric) {
+        case LinkMetricLostPackets: return "lost_packets";
+        case LinkMetricDamagedBlocks: return "damaged_blocks";
+        case LinkMetricInjectionFail: return "injection_fail";
+        case LinkMetricSkippedPackets: return "skipped_packets";
+        case LinkMetricReceivedPackets: return "received_packets";
+        case LinkMetricDownlinkRSSI: return "downlink_rssi";
+        case LinkMetricUplinkRSSI: return "uplink_rssi";
+        case LinkMetricBitrate: return "bitrate";
+        case LinkMetricCPULoadAir: return "cpuload_air";
+        case LinkMetricCPULoadGround: return "cpuload_gnd";
+        case LinkMetricTempAir: return "temp_air";
+        case LinkMetricTempGround: return "temp_gnd";
+        default: return "";
+    }
+}
+
+
+bool LinkAnalytics::isCounter(LinkMetric metric) {
+    return metric <= LinkMetricReceivedPackets;
+}
+
+
+void LinkAnalytics::addSample(const WifibroadcastStatus &status, int downlink_rssi) {
+    m_timestamps.push(m_clock.elapsed());
+
+    addCounter(LinkMetricLostPackets, status.lost_packet_cnt);
+    addCounter(LinkMetricDamagedBlocks, status.damaged_block_cnt);
+    addCounter(LinkMetricInjectionFail, status.injection_fail_cnt);
+    addCounter(LinkMetricSkippedPackets, status.skipped_packet_cnt);
+    addCounter(LinkMetricReceivedPackets, status.received_packet_cnt);
+
+    addValue(LinkMetricDownlinkRSSI, downlink_rssi);
+    addValue(LinkMetricUplinkRSSI, status.current_signal_joystick_uplink);
+    addValue(LinkMetricBitrate, status.kbitrate / 1024.0);
+    addValue(LinkMetricCPULoadAir, status.cpuload_air);
+    addValue(LinkMetricCPULoadGround, status.cpuload_gnd);
+    addValue(LinkMetricTempAir, status.temp_air);
+    addValue(LinkMetricTempGround, status.temp_gnd);
+}
+
+
+void LinkAnalytics::addValue(LinkMetric metric, double value) {
+    m_samples[metric].push(value);
+}
+
+
+void LinkAnalytics::addCounter(LinkMetric metric, uint32_t value) {
+    if (value < m_counter_last[metric]) {
+        m_counter_offset[metric] += m_counter_last[metric];
+    }
+    m_counter_last[metric] = value;
+    addValue(metric, m_counter_offset[metric] + value);
+}
+
+
+/*
+ * Index of the newest sample at or before the timestamp, or the oldest sample if they're all
+ * newer than that. The timestamps are in order, so this is a binary search.
+ */
+int LinkAnalytics::sampleAt(qint64 timestamp) const {
+    int low = 0;
+    int high = int(m_timestamps.size()) - 1;
+    int found = 0;
+
+    while (low <= high) {
+        int middle = (low + high) / 2;
+        if (m_timestamps.at(middle) <= timestamp) {
+            found = middle;
+            low = middle + 1;
+        } else {
+            high = middle - 1;
+        }
+    }
+    return found;
+}
+
+
+double LinkAnalytics::windowed(LinkMetric metric, qint64 window_ms) const {
+    if (m_timestamps.empty()) {
+        return 0.0;
+    }
+
+    auto &samples = m_samples[metric];
+    int last = int(m_timestamps.size()) - 1;
+    int first = sampleAt(m_clock.elapsed() - window_ms);
+
+    if (isCounter(metric)) {
+        auto elapsed = m_timestamps.at(last) - m_timestamps.at(first);
+        if (elapsed <= 0) {
+            return 0.0;
+        }
+        return (samples.at(last) - samples.at(first)) * 1000.0 / elapsed;
+    }
+
+    // nothing arrived within the window, the last value we have is the best we can do
+    if (m_timestamps.at(first) < m_clock.elapsed() - window_ms) {
+        first++;
+    }
+    if (first > last) {
+        return samples.at(last);
+    }
+
+    double sum = 0.0;
+    for (int i = first; i <= last; i++) {
+        sum += samples.at(i);
+    }
+    return sum / (last - first + 1);
+}
+
+
+double LinkAnalytics::percent(LinkMetric metric, LinkMetric of, qint64 window_ms) const {
+    auto total = windowed(of, window_ms);
+    if (total <= 0.0) {
+        return 0.0;
+    }
+    return windowed(metric, window_ms) / total * 100.0;
+}
+
+
+double LinkAnalytics::percentile(const RingBuffer<double, PercentileWindow> &history, double fraction) {
+    int count = int(history.size());
+    if (count == 0) {
+        return 0.0;
+    }
+
+    QVarLengthArray<double, PercentileWindow> values;
+    for (int i = 0; i < count; i++) {
+        values.append(history.at(i));
+    }
+
+    auto nth = values.begin() + qMin(count - 1, int(fraction * count));
+    std::nth_element(values.begin(), nth, values.end());
+    return *nth;
+}
+
+
+void LinkAnalytics::updateStatistics() {
+    QVariantMap statistics;
+    QVector<double> values(LinkMetricCount);
+
+    for (int i = 0; i < LinkMetricCount; i++) {
+        auto metric = LinkMetric(i);
+        auto &history = m_history[metric];
+
+        auto value = windowed(metric, 1000);
+        m_ewma[metric] = history.empty() ? value : EWMAWeight * value + (1.0 - EWMAWeight) * m_ewma[metric];
+        history.push(value);
+        values[metric] = value;
+
+        QVariantMap entry;
+        entry.insert("value_1s", value);
+        entry.insert("value_10s", windowed(metric, 10000));
+        entry.insert("value_60s", windowed(metric, 60000));
+        entry.insert("ewma", m_ewma[metric]);
+        entry.insert("p50", percentile(history, 0.50));
+        entry.insert("p95", percentile(history, 0.95));
+        entry.insert("p99", percentile(history, 0.99));
+
+        if (isCounter(metric) && metric != LinkMetricReceivedPackets) {
+            entry.insert("percent_10s", percent(metric, LinkMetricReceivedPackets, 10000));
+            entry.insert("percent_60s", percent(metric, LinkMetricReceivedPackets, 60000));
+        }
+
+        statistics.insert(metricName(metric), entry);
+    }
+
+    m_tick++;
+    m_store->append(m_tick, values);
+
+    m_statistics = statistics;
+    emit statistics_changed();
+}
+
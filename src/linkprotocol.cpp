@@ -0,0 +1,145 @@
+#include "linkprotocol.h"
+
+
+bool linkIsBinary(const QByteArray &buffer) {
+    return buffer.size() >= 3 &&
+           (uint8_t)buffer[0] == LinkProtocolMagic[0] &&
+           (uint8_t)buffer[1] == LinkProtocolMagic[1];
+}
+
+
+static void appendU8(QByteArray &buffer, int value) {
+    buffer.append((char)(uint8_t)value);
+}
+
+
+static void appendI16(QByteArray &buffer, int value) {
+    auto v = (uint16_t)(int16_t)value;
+    buffer.append((char)(v & 0xff));
+    buffer.append((char)(v >> 8));
+}
+
+
+static void appendName(QByteArray &buffer, const QString &name) {
+    auto utf8 = name.toUtf8().left(255);
+    appendU8(buffer, utf8.size());
+    buffer.append(utf8);
+}
+
+
+static QByteArray encodeRecord(const LinkRecord &record) {
+    QByteArray buffer;
+    appendU8(buffer, record.type);
+
+    switch (record.type) {
+        case LinkRecordHello: {
+            appendU8(buffer, record.version);
+            break;
+        }
+        case LinkRecordWidgetLocation: {
+            appendName(buffer, record.widget_name);
+            appendU8(buffer, record.alignment);
+            appendI16(buffer, record.x_offset);
+            appendI16(buffer, record.y_offset);
+            appendU8(buffer, (record.h_center ? 0x1 : 0) | (record.v_center ? 0x2 : 0));
+            break;
+        }
+        case LinkRecordWidgetEnabled: {
+            appendName(buffer, record.widget_name);
+            appendU8(buffer, record.enabled ? 1 : 0);
+            break;
+        }
+    }
+    return buffer;
+}
+
+
+void linkEncode(const QVector<LinkRecord> &records, QVector<QByteArray> &messages) {
+    QByteArray message;
+
+    for (auto &record : records) {
+        auto encoded = encodeRecord(record);
+
+        if (!message.isEmpty() && message.size() + encoded.size() > LinkMaxMessageSize) {
+            messages.append(message);
+            message.clear();
+        }
+        if (message.isEmpty()) {
+            appendU8(message, LinkProtocolMagic[0]);
+            appendU8(message, LinkProtocolMagic[1]);
+            appendU8(message, LinkProtocolVersion);
+        }
+        message.append(encoded);
+    }
+
+    if (!message.isEmpty()) {
+        messages.append(message);
+    }
+}
+
+
+static QString readName(FrameReader &reader) {
+    int length = reader.u8();
+    if (length > reader.remaining()) {
+        reader.skip(length);
+        return QString();
+    }
+    // FrameReader has no way to hand out a pointer, the names are short enough to copy bytewise
+    QByteArray utf8(length, Qt::Uninitialized);
+    for (int i = 0; i < length; i++) {
+        utf8[i] = (char)reader.u8();
+    }
+    return QString::fromUtf8(utf8);
+}
+
+
+bool linkDecode(const QByteArray &buffer, QVector<LinkRecord> &records) {
+    if (!linkIsBinary(buffer)) {
+        return false;
+    }
+    FrameReader reader((const uint8_t*)buffer.constData(), buffer.size());
+    reader.skip(2);
+    if (reader.u8() > LinkProtocolVersion) {
+        return false;
+    }
+
+    while (reader.remaining() > 0) {
+        LinkRecord record;
+        auto type = reader.u8();
+
+        switch (type) {
+            case LinkRecordHello: {
+                record.type = LinkRecordHello;
+                record.version = reader.u8();
+                break;
+            }
+            case LinkRecordWidgetLocation: {
+                record.type = LinkRecordWidgetLocation;
+                record.widget_name = readName(reader);
+                record.alignment = reader.u8();
+                record.x_offset = reader.i16();
+                record.y_offset = reader.i16();
+                auto flags = reader.u8();
+                record.h_center = flags & 0x1;
+                record.v_center = flags & 0x2;
+                break;
+            }
+            case LinkRecordWidgetEnabled: {
+                record.type = LinkRecordWidgetEnabled;
+                record.widget_name = readName(reader);
+                record.enabled = reader.u8() != 0;
+                break;
+            }
+            default: {
+                // there's no way to know how long it is, so nothing after it can be trusted
+                return false;
+            }
+        }
+
+        if (reader.overrun()) {
+            return false;
+        }
+        records.append(record);
+    }
+    return true;
+}
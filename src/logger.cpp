@@ -0,0 +1,320 @@
+#include "logger.h"
+
+#include <QtCore>
+
+#include <algorithm>
+#include <chrono>
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+
+
+struct LogRing {
+    LogRecord records[Logger::RingSize];
+
+    // head is only written by the owning thread and tail only by whoever drains
+    std::atomic<uint32_t> head { 0 };
+    std::atomic<uint32_t> tail { 0 };
+
+    // set once the owning thread has exited, the ring is freed after its last records are out
+    std::atomic<bool> orphaned { false };
+};
+
+
+struct LogRingOwner {
+    LogRing* ring = nullptr;
+
+    ~LogRingOwner() {
+        if (ring != nullptr) {
+            ring->orphaned.store(true, std::memory_order_release);
+            ring = nullptr;
+        }
+    }
+};
+
+static thread_local LogRingOwner t_owner;
+
+
+bool LogRateLimit::allow(int &suppressed) {
+    auto now = Logger::clockNs();
+    auto next = m_next_ns.load(std::memory_order_relaxed);
+
+    if (now < next || !m_next_ns.compare_exchange_strong(next, now + m_interval_ns, std::memory_order_relaxed)) {
+        m_suppressed.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    suppressed = m_suppressed.exchange(0, std::memory_order_relaxed);
+    return true;
+}
+
+
+static Logger* _instance = nullptr;
+
+Logger* Logger::instance() {
+    if (_instance == nullptr) {
+        _instance = new Logger();
+    }
+    return _instance;
+}
+
+
+qint64 Logger::clockNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+
+void Logger::install() {
+    if (m_running.load()) {
+        return;
+    }
+
+    openEvents();
+
+    m_running.store(true, std::memory_order_release);
+    m_flusher = std::thread(&Logger::run, this);
+
+    m_previous = qInstallMessageHandler(Logger::messageHandler);
+
+    // the application object is gone by the time static destructors run, flush before that
+    qAddPostRoutine([] {
+        Logger::instance()->stop();
+    });
+}
+
+
+void Logger::stop() {
+    if (!m_running.exchange(false)) {
+        return;
+    }
+
+    qInstallMessageHandler(m_previous);
+
+    m_wake.notify_one();
+    if (m_flusher.joinable()) {
+        m_flusher.join();
+    }
+    drain();
+
+    if (m_events_file != nullptr) {
+        fclose(m_events_file);
+        m_events_file = nullptr;
+    }
+}
+
+
+void Logger::flush() {
+    drain();
+}
+
+
+void Logger::openEvents() {
+    QSettings settings;
+    if (!settings.value("log_events", false).toBool()) {
+        return;
+    }
+
+    QDir dir(QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation) + "/logs");
+    if (!dir.mkpath(".")) {
+        return;
+    }
+
+    auto name = QString("events-%1.bin").arg(QDateTime::currentDateTime().toString("yyyyMMdd-hhmmss"));
+    m_events_file = fopen(dir.filePath(name).toLocal8Bit().constData(), "wb");
+}
+
+
+LogRing* Logger::ring() {
+    if (t_owner.ring == nullptr) {
+        auto ring = new LogRing();
+        {
+            std::lock_guard<std::mutex> lock(m_rings_mutex);
+            m_rings.push_back(ring);
+        }
+        t_owner.ring = ring;
+    }
+    return t_owner.ring;
+}
+
+
+LogRecord* Logger::reserve(LogRing* ring) {
+    auto head = ring->head.load(std::memory_order_relaxed);
+    auto used = head - ring->tail.load(std::memory_order_acquire);
+
+    if (used >= (uint32_t)RingSize) {
+        m_dropped.fetch_add(1, std::memory_order_relaxed);
+        return nullptr;
+    }
+    return &ring->records[head % RingSize];
+}
+
+
+void Logger::commit(LogRing* ring) {
+    auto head = ring->head.load(std::memory_order_relaxed) + 1;
+    ring->head.store(head, std::memory_order_release);
+
+    // a burst is filling the ring faster than the flusher's interval, get it going early
+    if (head - ring->tail.load(std::memory_order_relaxed) == (uint32_t)(RingSize * 3 / 4)) {
+        m_wake.notify_one();
+    }
+}
+
+
+void Logger::text(QtMsgType type, int suppressed, const char* format, ...) {
+    LogRecord direct;
+    auto ring = m_running.load(std::memory_order_acquire) ? this->ring() : nullptr;
+    auto record = ring != nullptr ? reserve(ring) : &direct;
+    if (record == nullptr) {
+        return;
+    }
+
+    record->wall_ms = QDateTime::currentMSecsSinceEpoch();
+    record->kind = LogRecordText;
+    record->type = type;
+    record->suppressed = suppressed;
+
+    va_list args;
+    va_start(args, format);
+    auto length = vsnprintf(record->text, LogTextSize, format, args);
+    va_end(args);
+    record->length = length < 0 ? 0 : qMin(length, LogTextSize - 1);
+
+    if (suppressed > 0) {
+        m_suppressed.fetch_add(suppressed, std::memory_order_relaxed);
+    }
+
+    if (ring != nullptr) {
+        commit(ring);
+    } else {
+        writeRecord(direct);
+    }
+}
+
+
+void Logger::event(LogEvent event, int64_t a, int64_t b) {
+    m_events.fetch_add(1, std::memory_order_relaxed);
+
+    // nowhere to write it, counting it is all there is to do
+    if (m_events_file == nullptr || !m_running.load(std::memory_order_acquire)) {
+        return;
+    }
+
+    auto ring = this->ring();
+    auto record = reserve(ring);
+    if (record == nullptr) {
+        return;
+    }
+
+    record->wall_ms = QDateTime::currentMSecsSinceEpoch();
+    record->kind = LogRecordEvent;
+    record->event = event;
+    record->a = a;
+    record->b = b;
+
+    commit(ring);
+}
+
+
+void Logger::messageHandler(QtMsgType type, const QMessageLogContext &context, const QString &message) {
+    auto logger = Logger::instance();
+
+    if (type == QtFatalMsg || !logger->m_running.load(std::memory_order_acquire)) {
+        // whatever was queued before this has to come out first, the previous handler aborts
+        if (type == QtFatalMsg) {
+            logger->drain();
+        }
+        if (logger->m_previous != nullptr) {
+            logger->m_previous(type, context, message);
+        }
+        return;
+    }
+
+    auto ring = logger->ring();
+    auto record = logger->reserve(ring);
+    if (record == nullptr) {
+        return;
+    }
+
+    record->wall_ms = QDateTime::currentMSecsSinceEpoch();
+    record->kind = LogRecordText;
+    record->type = type;
+    record->suppressed = 0;
+
+    auto utf8 = message.toUtf8();
+    record->length = qMin(utf8.size(), LogTextSize - 1);
+    memcpy(record->text, utf8.constData(), record->length);
+    record->text[record->length] = '\0';
+
+    logger->commit(ring);
+}
+
+
+void Logger::run() {
+    while (m_running.load(std::memory_order_acquire)) {
+        {
+            std::unique_lock<std::mutex> lock(m_wake_mutex);
+            m_wake.wait_for(lock, std::chrono::milliseconds(FlushIntervalMs));
+        }
+        drain();
+    }
+}
+
+
+void Logger::drain() {
+    std::lock_guard<std::mutex> drain_lock(m_drain_mutex);
+
+    std::vector<LogRing*> rings;
+    {
+        std::lock_guard<std::mutex> lock(m_rings_mutex);
+        rings = m_rings;
+    }
+
+    for (auto ring : rings) {
+        // checked before reading head, so a ring seen orphaned has nothing more coming
+        auto orphaned = ring->orphaned.load(std::memory_order_acquire);
+
+        auto tail = ring->tail.load(std::memory_order_relaxed);
+        auto head = ring->head.load(std::memory_order_acquire);
+        for (; tail != head; tail++) {
+            writeRecord(ring->records[tail % RingSize]);
+        }
+        ring->tail.store(tail, std::memory_order_release);
+
+        if (orphaned) {
+            std::lock_guard<std::mutex> lock(m_rings_mutex);
+            m_rings.erase(std::find(m_rings.begin(), m_rings.end(), ring));
+            delete ring;
+        }
+    }
+
+    if (m_events_file != nullptr) {
+        fflush(m_events_file);
+    }
+}
+
+
+void Logger::writeRecord(const LogRecord &record) {
+    if (record.kind == LogRecordEvent) {
+        if (m_events_file == nullptr) {
+            return;
+        }
+        uint8_t buffer[32] = {};
+        qToLittleEndian<qint64>(record.wall_ms, buffer);
+        qToLittleEndian<quint16>(record.event, buffer + 8);
+        qToLittleEndian<qint64>(record.a, buffer + 16);
+        qToLittleEndian<qint64>(record.b, buffer + 24);
+        fwrite(buffer, sizeof(buffer), 1, m_events_file);
+        return;
+    }
+
+    auto message = QString::fromUtf8(record.text, record.length);
+    if (record.suppressed > 0) {
+        message += QString(" (%1 similar suppressed)").arg(record.suppressed);
+    }
+
+    if (m_previous != nullptr) {
+        m_previous((QtMsgType)record.type, QMessageLogContext(), message);
+    } else {
+        fprintf(stderr, "%s\n", message.toLocal8Bit().constData());
+    }
+    m_written.fetch_add(1, std::memory_order_relaxed);
+}
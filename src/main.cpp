@@ -14,22 +14,21 @@ const QVector<QString> permissions({"android.permission.INTERNET",
 #endif
 
 #include "constants.h"
+#include "logger.h"
 
 #include "migration.hpp"
 #include "openhdtelemetry.h"
 #include "openhdrc.h"
 #include "openhdsettings.h"
+#include "settingssender.h"
 #include "openhdpi.h"
 #include "openhd.h"
 #include "mavlinktelemetry.h"
 #include "localmessage.h"
-#include "frskytelemetry.h"
-#include "msptelemetry.h"
-#include "ltmtelemetry.h"
-#include "vectortelemetry.h"
-#include "smartporttelemetry.h"
+#include "telemetrydetector.h"
 
 #include "qopenhdlink.h"
+#include "rcsender.h"
 
 #include "powermicroservice.h"
 
@@ -38,9 +37,20 @@ const QVector<QString> permissions({"android.permission.INTERNET",
 #include "statusmicroservice.h"
 
 #include "statuslogmodel.h"
+#include "wifiadaptermodel.h"
+#include "linkanalytics.h"
+
+#include "flightrecorder.h"
+#include "ingestreactor.h"
+#include "telemetryreplay.h"
+#include "telemetrysubscriptions.h"
 
 #include "opensky.h"
 
+#include "headingtape.h"
+#include "laddertape.h"
+#include "vsigauge.h"
+
 #if defined(__ios__)
 #include "appleplatform.h"
 #endif
@@ -88,6 +98,8 @@ int main(int argc, char *argv[]) {
     QCoreApplication::setOrganizationDomain("open.hd");
     QCoreApplication::setApplicationName("Open.HD");
 
+    Logger::instance()->install();
+
     QSettings settings;
 
     double global_scale = settings.value("global_scale", 1.0).toDouble();
@@ -154,12 +166,6 @@ int main(int argc, char *argv[]) {
     QFontDatabase::addApplicationFont(":/osdicons.ttf");
 
     QFontDatabase::addApplicationFont(":/materialdesignicons-webfont.ttf");
-    qmlRegisterType<FrSkyTelemetry>("OpenHD", 1, 0, "FrSkyTelemetry");
-    qmlRegisterType<MSPTelemetry>("OpenHD", 1, 0, "MSPTelemetry");
-    qmlRegisterType<LTMTelemetry>("OpenHD", 1, 0, "LTMTelemetry");
-    qmlRegisterType<VectorTelemetry>("OpenHD", 1, 0, "VectorTelemetry");
-    qmlRegisterType<SmartportTelemetry>("OpenHD", 1, 0, "SmartportTelemetry");
-
     qmlRegisterType<OpenHDRC>("OpenHD", 1, 0, "OpenHDRC");
 
     qmlRegisterSingletonType<OpenHDPi>("OpenHD", 1, 0, "OpenHDPi", openHDPiSingletonProvider);
@@ -169,6 +175,10 @@ int main(int argc, char *argv[]) {
 
     qmlRegisterType<QOpenHDLink>("OpenHD", 1,0, "QOpenHDLink");
 
+    qmlRegisterType<LadderTape>("OpenHD", 1, 0, "LadderTape");
+    qmlRegisterType<HeadingTape>("OpenHD", 1, 0, "HeadingTape");
+    qmlRegisterType<VsiGauge>("OpenHD", 1, 0, "VsiGauge");
+
 #if defined(ENABLE_VIDEO_RENDER)
 #if defined(__android__)
     qmlRegisterType<OpenHDAndroidVideo>("OpenHD", 1, 0, "OpenHDAndroidVideo");
@@ -272,6 +282,27 @@ OpenHDAppleVideo *pipVideo = new OpenHDAppleVideo(OpenHDStreamTypePiP);
     auto openHDSettings = new OpenHDSettings();
     engine.rootContext()->setContextProperty("openHDSettings", openHDSettings);
 
+    auto settingsSender = SettingsSender::instance();
+    QThread *settingsThread = new QThread();
+    settingsThread->setObjectName("settingsSenderThread");
+    QObject::connect(settingsThread, &QThread::started, settingsSender, &SettingsSender::onStarted);
+    settingsSender->moveToThread(settingsThread);
+    QObject::connect(openHDSettings, &OpenHDSettings::groundStationIPUpdated, settingsSender, &SettingsSender::setGroundIP, Qt::QueuedConnection);
+    settingsThread->start();
+
+
+    /*
+     * RC packets go out from their own thread at a fixed cadence, OpenHDRC only hands it the
+     * channel values, the ground address and whether RC is enabled.
+     */
+    auto rcSender = RCSender::instance();
+    engine.rootContext()->setContextProperty("RCSender", rcSender);
+    QThread *rcThread = new QThread();
+    rcThread->setObjectName("rcSenderThread");
+    QObject::connect(rcThread, &QThread::started, rcSender, &RCSender::onStarted);
+    rcSender->moveToThread(rcThread);
+    QObject::connect(&app, &QApplication::aboutToQuit, rcSender, &RCSender::onStopped, Qt::DirectConnection);
+    rcThread->start();
 
     auto openHDRC = new OpenHDRC();
     QObject::connect(openHDSettings, &OpenHDSettings::groundStationIPUpdated, openHDRC, &OpenHDRC::setGroundIP, Qt::QueuedConnection);
@@ -283,6 +314,42 @@ OpenHDAppleVideo *pipVideo = new OpenHDAppleVideo(OpenHDStreamTypePiP);
     engine.rootContext()->setContextProperty("link", link);
 
 
+    /*
+     * The recorder has to exist before any of the telemetry threads start so they all share
+     * the same instance.
+     */
+    auto flightRecorder = FlightRecorder::instance();
+    engine.rootContext()->setContextProperty("FlightRecorder", flightRecorder);
+    QThread *recorderThread = new QThread();
+    recorderThread->setObjectName("flightRecorderThread");
+    QObject::connect(recorderThread, &QThread::started, flightRecorder, &FlightRecorder::onStarted);
+    flightRecorder->moveToThread(recorderThread);
+    QObject::connect(&app, &QApplication::aboutToQuit, flightRecorder, &FlightRecorder::onStopped, Qt::BlockingQueuedConnection);
+    recorderThread->start();
+
+
+    /*
+     * All of the receive-only telemetry ports are read on this thread, it has to be running
+     * before OpenHDTelemetry and the telemetry detector add their ports to it.
+     */
+    auto ingestReactor = IngestReactor::instance();
+    engine.rootContext()->setContextProperty("IngestReactor", ingestReactor);
+    QThread *ingestThread = new QThread();
+    ingestThread->setObjectName("ingestThread");
+    QObject::connect(ingestThread, &QThread::started, ingestReactor, &IngestReactor::onStarted);
+    ingestReactor->moveToThread(ingestThread);
+    QObject::connect(&app, &QApplication::aboutToQuit, ingestReactor, &IngestReactor::onStopped, Qt::DirectConnection);
+    ingestThread->start();
+
+    auto telemetryDetector = TelemetryDetector::instance();
+    engine.rootContext()->setContextProperty("TelemetryDetector", telemetryDetector);
+    QObject::connect(openHDSettings, &OpenHDSettings::groundStationIPUpdated, telemetryDetector, &TelemetryDetector::setGroundIP, Qt::QueuedConnection);
+    telemetryDetector->onStarted();
+
+
+    auto telemetrySubscriptions = TelemetrySubscriptions::instance();
+    engine.rootContext()->setContextProperty("TelemetrySubscriptions", telemetrySubscriptions);
+
     auto mavlinkTelemetry = MavlinkTelemetry::instance();
     engine.rootContext()->setContextProperty("MavlinkTelemetry", mavlinkTelemetry);
     QThread *mavlinkThread = new QThread();
@@ -290,6 +357,7 @@ OpenHDAppleVideo *pipVideo = new OpenHDAppleVideo(OpenHDStreamTypePiP);
     QObject::connect(mavlinkThread, &QThread::started, mavlinkTelemetry, &MavlinkTelemetry::onStarted);
     mavlinkTelemetry->moveToThread(mavlinkThread);
     QObject::connect(openHDSettings, &OpenHDSettings::groundStationIPUpdated, mavlinkTelemetry, &MavlinkTelemetry::setGroundIP, Qt::QueuedConnection);
+    QObject::connect(mavlinkTelemetry, &MavlinkTelemetry::heartbeat_received, telemetryDetector, &TelemetryDetector::onMavlinkHeartbeat, Qt::QueuedConnection);
     mavlinkThread->start();
 
 
@@ -333,9 +401,30 @@ OpenHDAppleVideo *pipVideo = new OpenHDAppleVideo(OpenHDStreamTypePiP);
     airStatusMicroservice->onStarted();
 
 
+    auto telemetryReplay = TelemetryReplay::instance();
+    telemetryReplay->addMavlinkTarget(mavlinkTelemetry);
+    telemetryReplay->addMavlinkTarget(airGPIOMicroservice);
+    telemetryReplay->addMavlinkTarget(groundPowerMicroservice);
+    telemetryReplay->addMavlinkTarget(groundStatusMicroservice);
+    telemetryReplay->addMavlinkTarget(airStatusMicroservice);
+    telemetryReplay->setOpenHDTarget(openhdTelemetry);
+    engine.rootContext()->setContextProperty("TelemetryReplay", telemetryReplay);
+    QThread *replayThread = new QThread();
+    replayThread->setObjectName("telemetryReplayThread");
+    QObject::connect(replayThread, &QThread::started, telemetryReplay, &TelemetryReplay::onStarted);
+    telemetryReplay->moveToThread(replayThread);
+    replayThread->start();
+
+
     auto statusLogModel = StatusLogModel::instance();
     engine.rootContext()->setContextProperty("StatusLogModel", statusLogModel);
 
+    auto wifiAdapterModel = WifiAdapterModel::instance();
+    engine.rootContext()->setContextProperty("WifiAdapterModel", wifiAdapterModel);
+
+    auto linkAnalytics = LinkAnalytics::instance();
+    engine.rootContext()->setContextProperty("LinkAnalytics", linkAnalytics);
+
     auto opensky = new OpenSky();
     engine.rootContext()->setContextProperty("OpenSky", opensky);
 
@@ -385,6 +474,16 @@ OpenHDAppleVideo *pipVideo = new OpenHDAppleVideo(OpenHDStreamTypePiP);
 
     engine.load(QUrl(QLatin1String("qrc:/main.qml")));
 
+    /*
+     * Telemetry parsed on other threads is applied to the OpenHD properties once per frame,
+     * after animations have advanced and before the scene graph is synchronized. A static
+     * scene doesn't render any frames, so publishing a snapshot schedules one (the signal
+     * comes from the publisher's thread and is queued to the window).
+     */
+    QQuickWindow *mainWindow = qobject_cast<QQuickWindow *>(engine.rootObjects().first());
+    QObject::connect(mainWindow, &QQuickWindow::afterAnimating, openhd, &OpenHD::syncTelemetry);
+    QObject::connect(openhd, &OpenHD::telemetry_published, mainWindow, &QQuickWindow::update, Qt::QueuedConnection);
+
 #if defined(__android__)
     QtAndroid::hideSplashScreen();
 #endif
@@ -11,12 +11,18 @@
 #include <QtConcurrent>
 #include <QFutureWatcher>
 #include <QFuture>
+#include <QStandardPaths>
+#include <QJsonDocument>
+#include <QJsonObject>
 
 #include <openhd/mavlink.h>
 
 #include "util.h"
 #include "constants.h"
 
+#include "flightrecorder.h"
+#include "mavlinkrouter.h"
+
 
 MavlinkBase::MavlinkBase(QObject *parent,  MavlinkType mavlink_type): QObject(parent), m_ground_available(false), m_mavlink_type(mavlink_type) {
     qDebug() << "MavlinkBase::MavlinkBase()";
@@ -49,11 +55,6 @@ void MavlinkBase::onStarted() {
         }
     }
 
-    m_command_timer = new QTimer(this);
-    connect(m_command_timer, &QTimer::timeout, this, &MavlinkBase::commandStateLoop);
-    m_command_timer->start(200);
-
-
     m_heartbeat_timer = new QTimer(this);
     connect(m_heartbeat_timer, &QTimer::timeout, this, &MavlinkBase::sendHeartbeat);
     m_heartbeat_timer->start(5000);
@@ -106,6 +107,21 @@ void MavlinkBase::setGroundIP(QString address) {
 }
 
 
+quint16 MavlinkBase::get_local_port() const {
+    return localPort;
+}
+
+
+void MavlinkBase::setReplaying(bool replaying) {
+    m_replaying = replaying;
+}
+
+
+void MavlinkBase::replayData(QByteArray data) {
+    parseData(data);
+}
+
+
 void MavlinkBase::set_loading(bool loading) {
     m_loading = loading;
     emit loadingChanged(m_loading);
@@ -119,6 +135,14 @@ void MavlinkBase::set_saving(bool saving) {
 
 
 void MavlinkBase::sendData(char* data, int len) {
+    if (m_replaying) {
+        return;
+    }
+    writeData(data, len);
+}
+
+
+void MavlinkBase::writeData(char* data, int len) {
     switch (m_mavlink_type) {
         case MavlinkTypeUDP: {
             ((QUdpSocket*)mavlinkSocket)->writeDatagram((char*)data, len, QHostAddress(groundAddress), groundUDPPort);
@@ -181,20 +205,44 @@ bool MavlinkBase::isConnectionLost() {
 void MavlinkBase::resetParamVars() {
     m_allParameters.clear();
     parameterCount = 0;
-    parameterIndex = 0;
     initialConnectTimer = -1;
+    m_parameter_received.clear();
+    m_parameter_received_count = 0;
+    m_parameter_hash_received = false;
+    m_parameter_hash = 0;
     /* give the MavlinkStateGetParameters state a chance to receive a parameter
        before timing out */
     parameterLastReceivedTime = QDateTime::currentMSecsSinceEpoch();
 }
 
 
+void MavlinkBase::set_parameter_download_ms(qint64 parameter_download_ms) {
+    m_parameter_download_ms = parameter_download_ms;
+    emit parameter_download_ms_changed(m_parameter_download_ms);
+}
+
+
+void MavlinkBase::set_parameter_retries(int parameter_retries) {
+    m_parameter_retries = parameter_retries;
+    emit parameter_retries_changed(m_parameter_retries);
+}
+
+
+/*
+ * Parameter download:
+ *
+ * Once a heartbeat has been seen, and the autopilot is PX4, we ask for _HASH_CHECK, a hash of
+ * the whole parameter set PX4 computes on request. ArduPilot and the OpenHD microservices
+ * don't implement it, so asking would only mean waiting for the request to time out. If we
+ * have a cached copy of the set with that hash we use it and we're done. Otherwise, or
+ * without hash support, the full list is requested and every index that arrives is
+ * marked in a bitmap. When the stream stalls, only the indexes still missing are requested
+ * again with PARAM_REQUEST_READ, a batch at a time, rather than starting over.
+ */
 void MavlinkBase::stateLoop() {
     qint64 current_timestamp = QDateTime::currentMSecsSinceEpoch();
     set_last_heartbeat(current_timestamp - last_heartbeat_timestamp);
 
-    return;
-
     switch (state) {
         case MavlinkStateDisconnected: {
             set_loading(false);
@@ -205,35 +253,76 @@ void MavlinkBase::stateLoop() {
             break;
         }
         case MavlinkStateConnected: {
-            if (initialConnectTimer == -1) {
-                initialConnectTimer = QDateTime::currentMSecsSinceEpoch();
-            } else if (current_timestamp - initialConnectTimer < 5000) {
+            if (isConnectionLost()) {
+                // wait for the vehicle to show up
+                break;
+            }
+            resetParamVars();
+            set_parameter_retries(0);
+            m_parameter_download_time.start();
+
+            if (m_autopilot == MAV_AUTOPILOT_PX4) {
+                requestParameterHash();
+                state = MavlinkStateCheckParameterHash;
+            } else {
+                fetchParameters();
                 state = MavlinkStateGetParameters;
-                resetParamVars();
+            }
+            break;
+        }
+        case MavlinkStateCheckParameterHash: {
+            set_loading(true);
+
+            if (m_parameter_hash_received) {
+                if (loadParameterCache(m_parameter_hash)) {
+                    qDebug() << "MavlinkBase: loaded" << m_allParameters.size() << "parameters from cache in" << m_parameter_download_time.elapsed() << "ms";
+                    finishParameterDownload();
+                    break;
+                }
+                fetchParameters();
+                state = MavlinkStateGetParameters;
+            } else if (current_timestamp - parameterLastReceivedTime > 1000) {
+                // no hash support, so no caching either
                 fetchParameters();
+                state = MavlinkStateGetParameters;
             }
             break;
         }
         case MavlinkStateGetParameters: {
             set_loading(true);
             set_saving(false);
-            qint64 currentTime = QDateTime::currentMSecsSinceEpoch();
 
             if (isConnectionLost()) {
                 resetParamVars();
                 m_ground_available = false;
                 state = MavlinkStateDisconnected;
+                break;
             }
 
-            if ((parameterCount != 0) && parameterIndex == (parameterCount - 1)) {
-                emit allParametersChanged();
-                state = MavlinkStateIdle;
+            if (parameterCount != 0 && m_parameter_received_count == parameterCount) {
+                qDebug() << "MavlinkBase: downloaded" << parameterCount << "parameters in" << m_parameter_download_time.elapsed() << "ms with" << m_parameter_retries << "retries";
+                if (m_parameter_hash_received) {
+                    saveParameterCache(m_parameter_hash);
+                }
+                finishParameterDownload();
+                break;
             }
 
-            if (currentTime - parameterLastReceivedTime > 7000) {
-                resetParamVars();
-                m_ground_available = false;
-                state = MavlinkStateDisconnected;
+            if (current_timestamp - parameterLastReceivedTime > 1000) {
+                if (m_parameter_retries >= 20) {
+                    qDebug() << "MavlinkBase: giving up on parameters with" << m_parameter_received_count << "of" << parameterCount << "received";
+                    finishParameterDownload();
+                    break;
+                }
+                set_parameter_retries(m_parameter_retries + 1);
+
+                if (parameterCount == 0) {
+                    // nothing at all has arrived, the list request itself must have been lost
+                    fetchParameters();
+                } else {
+                    requestMissingParameters();
+                }
+                parameterLastReceivedTime = current_timestamp;
             }
             break;
         }
@@ -252,9 +341,137 @@ void MavlinkBase::stateLoop() {
 }
 
 
+void MavlinkBase::finishParameterDownload() {
+    set_parameter_download_ms(m_parameter_download_time.elapsed());
+    emit allParametersChanged();
+    state = MavlinkStateIdle;
+}
+
+
+void MavlinkBase::requestParameterHash() {
+    QSettings settings;
+    int mavlink_sysid = settings.value("mavlink_sysid", default_mavlink_sysid()).toInt();
+
+    mavlink_message_t msg;
+    mavlink_msg_param_request_read_pack(mavlink_sysid, MAV_COMP_ID_MISSIONPLANNER, &msg, targetSysID, targetCompID1, "_HASH_CHECK", -1);
+
+    uint8_t buffer[MAVLINK_MAX_PACKET_LEN];
+    int len = mavlink_msg_to_send_buffer(buffer, &msg);
+
+    sendData((char*)buffer, len);
+}
+
+
+/*
+ * Requests up to a batch of the parameter indexes that haven't arrived yet. The rest are
+ * picked up on the next retry if the stream stalls again.
+ */
+void MavlinkBase::requestMissingParameters() {
+    QSettings settings;
+    int mavlink_sysid = settings.value("mavlink_sysid", default_mavlink_sysid()).toInt();
+
+    int requested = 0;
+
+    for (int index = 0; index < parameterCount && requested < 32; index++) {
+        if (m_parameter_received.testBit(index)) {
+            continue;
+        }
+        mavlink_message_t msg;
+        mavlink_msg_param_request_read_pack(mavlink_sysid, MAV_COMP_ID_MISSIONPLANNER, &msg, targetSysID, targetCompID1, "", index);
+
+        uint8_t buffer[MAVLINK_MAX_PACKET_LEN];
+        int len = mavlink_msg_to_send_buffer(buffer, &msg);
+
+        sendData((char*)buffer, len);
+        requested++;
+    }
+}
+
+
+void MavlinkBase::processParameterValue(const mavlink_message_t &msg) {
+    // the vehicle's other components have parameters of their own, they'd corrupt the set
+    if (msg.sysid != targetSysID || msg.compid != targetCompID1) {
+        return;
+    }
+
+    mavlink_param_value_t param;
+    mavlink_msg_param_value_decode(&msg, &param);
+
+    QByteArray param_id(param.param_id, 16);
+    /*
+     * If there's no null in the param_id array, the mavlink docs say it has to be exactly 16 characters,
+     * so we add a null to the end and then continue. This guarantees that QString below will always find
+     * a null terminator.
+     *
+     */
+    if (!param_id.contains('\0')) {
+       param_id.append('\0');
+    }
+
+    QString s(param_id.data());
+
+    if (s == "_HASH_CHECK") {
+        // the hash is sent as the raw bits of the float value
+        memcpy(&m_parameter_hash, &param.param_value, sizeof(m_parameter_hash));
+        m_parameter_hash_received = true;
+        return;
+    }
+
+    parameterLastReceivedTime = QDateTime::currentMSecsSinceEpoch();
+
+    if (param.param_count != parameterCount || m_parameter_received.size() != param.param_count) {
+        parameterCount = param.param_count;
+        m_parameter_received.resize(parameterCount);
+        // shrinking drops bits, so count what's left rather than trust the running total
+        m_parameter_received_count = m_parameter_received.count(true);
+    }
+
+    if (param.param_index < parameterCount && !m_parameter_received.testBit(param.param_index)) {
+        m_parameter_received.setBit(param.param_index);
+        m_parameter_received_count++;
+    }
+
+    m_allParameters.insert(s, QVariant(param.param_value));
+}
+
+
+QString MavlinkBase::parameterCachePath(uint32_t hash) {
+    auto directory = QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation) + "/parameters";
+    QDir().mkpath(directory);
+    return QString("%1/%2-%3-%4.json").arg(directory).arg(targetSysID).arg(targetCompID1).arg(hash, 8, 16, QChar('0'));
+}
+
+
+bool MavlinkBase::loadParameterCache(uint32_t hash) {
+    QFile file(parameterCachePath(hash));
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    auto document = QJsonDocument::fromJson(file.readAll());
+    if (!document.isObject() || document.object().isEmpty()) {
+        return false;
+    }
+    m_allParameters = document.object().toVariantMap();
+    return true;
+}
+
+
+void MavlinkBase::saveParameterCache(uint32_t hash) {
+    QFile file(parameterCachePath(hash));
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        return;
+    }
+    file.write(QJsonDocument(QJsonObject::fromVariantMap(m_allParameters)).toJson(QJsonDocument::Compact));
+}
+
+
 void MavlinkBase::processMavlinkTCPData() {
     QByteArray data = mavlinkSocket->readAll();
     processData(data);
+
+    if (m_router) {
+        m_router->flush();
+    }
 }
 
 
@@ -271,14 +488,34 @@ void MavlinkBase::processMavlinkUDPDatagrams() {
         groundUDPPort = groundPort;
         processData(datagram);
     }
+
+    // everything read in this pass goes out to the forwarding endpoints together
+    if (m_router) {
+        m_router->flush();
+    }
 }
 
 
 void MavlinkBase::processData(QByteArray data) {
-    typedef QByteArray::Iterator Iterator;
+    // other ground control software keeps seeing the vehicle during a replay
+    if (m_router) {
+        m_router->forward(data);
+    }
+
+    if (m_replaying) {
+        return;
+    }
+
+    FlightRecorder::instance()->record(FlightRecordTypeMavlink, localPort, data.constData(), data.size());
+
+    parseData(data);
+}
+
+
+void MavlinkBase::parseData(const QByteArray &data) {
     mavlink_message_t msg;
 
-    for (Iterator i = data.begin(); i != data.end(); i++) {
+    for (auto i = data.begin(); i != data.end(); i++) {
         char c = *i;
 
         uint8_t res = mavlink_parse_char(MAVLINK_COMM_0, (uint8_t)c, &msg, &r_mavlink_status);
@@ -294,21 +531,18 @@ void MavlinkBase::processData(QByteArray data) {
             if (msg.compid != targetCompID1 && msg.compid != targetCompID2) {
                 return;
             }
+
+            if (msg.msgid == MAVLINK_MSG_ID_HEARTBEAT && msg.compid == targetCompID1) {
+                // decides whether the parameter download can use _HASH_CHECK
+                m_autopilot = mavlink_msg_heartbeat_get_autopilot(&msg);
+            }
+
             // process ack messages in the base class, subclasses will receive a signal
             // to indicate success or failure
-            if (msg.msgid == MAVLINK_MSG_ID_COMMAND_ACK) {
-                mavlink_command_ack_t ack;
-                mavlink_msg_command_ack_decode(&msg, &ack);
-                switch (ack.result) {
-                    case MAV_CMD_ACK_OK: {
-                        m_command_state = MavlinkCommandStateDone;
-                        break;
-                    }
-                    default: {
-                        m_command_state = MavlinkCommandStateFailed;
-                        break;
-                    }
-                }
+            if (msg.msgid == MAVLINK_MSG_ID_PARAM_VALUE) {
+                processParameterValue(msg);
+            } else if (msg.msgid == MAVLINK_MSG_ID_COMMAND_ACK) {
+                processCommandAck(msg);
             } else {
                 emit processMavlinkMessage(msg);
             }
@@ -327,84 +561,205 @@ void MavlinkBase::set_last_heartbeat(qint64 last_heartbeat) {
  * This is the entry point for sending mavlink commands to any component, including flight
  * controllers and microservices.
  *
- * We accept a MavlinkCommand subclass with the fields set according to the type of command
- * being sent, and then we switch the state machine running in commandStateLoop() to the
- * sending state.
+ * We accept a MavlinkCommand with the fields set according to the type of command being sent
+ * and send it right away. Any number of commands can be outstanding at once, each one is
+ * identified by its target system, target component and command id, which is all a
+ * COMMAND_ACK tells us about the command it belongs to. Sending a command with the same key
+ * as one that is still waiting for an ACK replaces it.
  *
- * The state machine then takes care of waiting for a command acknowledgement, and if one
- * is not received within the timeout, the command is resent up to 5 times.
+ * Each command has its own deadline timer, if no acknowledgement arrives in time the command
+ * is resent up to 5 times. A MAV_RESULT_IN_PROGRESS acknowledgement extends the deadline
+ * instead of counting as a result, and from then on the command is never resent: if no
+ * final result arrives in time it fails with MAV_RESULT_IN_PROGRESS.
  *
- * Subclasses are responsible for connecting a slot to the commandDone and commandFailed
- * signals to further handle the result.
+ * The optional callback is called exactly once with the outcome. The commandDone and
+ * commandFailed signals are emitted as well for subclasses that connect to those instead.
  *
  */
-void MavlinkBase::send_command(MavlinkCommand command) {
-    m_current_command.reset(new MavlinkCommand(command));
-    m_command_state = MavlinkCommandStateSend;
+void MavlinkBase::send_command(MavlinkCommand command, MavlinkCommandCallback callback) {
+    if (command.target_system < 0) {
+        command.target_system = targetSysID;
+    }
+    if (command.target_component < 0) {
+        command.target_component = targetCompID1;
+    }
+
+    auto key = commandKey(command.target_system, command.target_component, command.command_id);
+
+    auto existing = m_pending_commands.take(key);
+    if (existing) {
+        existing->deadline->stop();
+        existing->deadline->deleteLater();
+    }
+
+    auto pending = std::make_shared<MavlinkPendingCommand>(command);
+    pending->callback = callback;
+    pending->deadline = new QTimer(this);
+    pending->deadline->setSingleShot(true);
+    connect(pending->deadline, &QTimer::timeout, this, [this, key] {
+        onCommandDeadline(key);
+    });
+
+    m_pending_commands.insert(key, pending);
+    set_commands_pending(m_pending_commands.size());
+
+    pending->first_sent.start();
+    transmitCommand(pending.get());
+
+    // only now, in case the callback sends another command
+    if (existing && existing->callback) {
+        existing->callback(false, MAV_RESULT_CANCELLED);
+    }
 }
 
 
-void MavlinkBase::commandStateLoop() {
-    switch (m_command_state) {
-        case MavlinkCommandStateReady: {
-            // do nothing, no command being sent
-            break;
-        }
-        case MavlinkCommandStateSend: {
-            mavlink_message_t msg;
-            m_command_sent_timestamp = QDateTime::currentMSecsSinceEpoch();
+quint32 MavlinkBase::commandKey(uint8_t target_system, uint8_t target_component, uint16_t command_id) {
+    return ((quint32)target_system << 24) | ((quint32)target_component << 16) | command_id;
+}
 
-            QSettings settings;
 
-            int mavlink_sysid = settings.value("mavlink_sysid", default_mavlink_sysid()).toInt();
+void MavlinkBase::transmitCommand(MavlinkPendingCommand* pending) {
+    auto &command = pending->command;
 
-            if (m_current_command->m_command_type == MavlinkCommandTypeLong) {
-                mavlink_msg_command_long_pack(mavlink_sysid, MAV_COMP_ID_MISSIONPLANNER, &msg, targetSysID, targetCompID1, m_current_command->command_id, m_current_command->long_confirmation, m_current_command->long_param1, m_current_command->long_param2, m_current_command->long_param3, m_current_command->long_param4, m_current_command->long_param5, m_current_command->long_param6, m_current_command->long_param7);
-            } else {
-                mavlink_msg_command_int_pack(mavlink_sysid, MAV_COMP_ID_MISSIONPLANNER, &msg, targetSysID, targetCompID1, m_current_command->int_frame, m_current_command->command_id, m_current_command->int_current, m_current_command->int_autocontinue, m_current_command->int_param1, m_current_command->int_param2, m_current_command->int_param3, m_current_command->int_param4, m_current_command->int_param5, m_current_command->int_param6, m_current_command->int_param7);
-            }
-            uint8_t buffer[MAVLINK_MAX_PACKET_LEN];
-            int len = mavlink_msg_to_send_buffer(buffer, &msg);
+    QSettings settings;
+    int mavlink_sysid = settings.value("mavlink_sysid", default_mavlink_sysid()).toInt();
+
+    mavlink_message_t msg;
+    if (command.m_command_type == MavlinkCommandTypeLong) {
+        mavlink_msg_command_long_pack(mavlink_sysid, MAV_COMP_ID_MISSIONPLANNER, &msg, command.target_system, command.target_component, command.command_id, command.long_confirmation, command.long_param1, command.long_param2, command.long_param3, command.long_param4, command.long_param5, command.long_param6, command.long_param7);
+    } else {
+        mavlink_msg_command_int_pack(mavlink_sysid, MAV_COMP_ID_MISSIONPLANNER, &msg, command.target_system, command.target_component, command.int_frame, command.command_id, command.int_current, command.int_autocontinue, command.int_param1, command.int_param2, command.int_param3, command.int_param4, command.int_param5, command.int_param6, command.int_param7);
+    }
+    uint8_t buffer[MAVLINK_MAX_PACKET_LEN];
+    int len = mavlink_msg_to_send_buffer(buffer, &msg);
 
-            sendData((char*)buffer, len);
+    sendData((char*)buffer, len);
 
-            // now wait for ack
-            m_command_state = MavlinkCommandStateWaitACK;
+    pending->deadline->start(CommandAckTimeout);
+}
 
-            break;
-        }
-        case MavlinkCommandStateWaitACK: {
-            qint64 current_timestamp = QDateTime::currentMSecsSinceEpoch();
-            auto elapsed = current_timestamp - m_command_sent_timestamp;
-
-            if (elapsed > 200) {
-                // no ack in 200ms, cancel or resend
-                if (m_current_command->retry_count >= 5) {
-                    m_command_state = MavlinkCommandStateFailed;
-                    m_current_command.reset();
-                    return;
-                }
-                m_current_command->retry_count = m_current_command->retry_count + 1;
-                if (m_current_command->m_command_type == MavlinkCommandTypeLong) {
-                    /* incremement the confirmation parameter according to the Mavlink command
-                       documentation */
-                    m_current_command->long_confirmation = m_current_command->long_confirmation + 1;
-                }
-                m_command_state = MavlinkCommandStateSend;
+
+void MavlinkBase::onCommandDeadline(quint32 key) {
+    auto pending = m_pending_commands.value(key);
+    if (!pending) {
+        return;
+    }
+    auto &command = pending->command;
+
+    /*
+     * The target accepted the command and is carrying it out, resending would start it over.
+     * It went quiet before reporting a result, so all we can say is that it didn't finish.
+     */
+    if (pending->in_progress) {
+        completeCommand(key, false, MAV_RESULT_IN_PROGRESS);
+        return;
+    }
+
+    if (command.retry_count >= CommandMaxRetries) {
+        completeCommand(key, false, MAV_RESULT_FAILED);
+        return;
+    }
+    command.retry_count = command.retry_count + 1;
+    set_command_retries(m_command_retries + 1);
+
+    if (command.m_command_type == MavlinkCommandTypeLong) {
+        /* incremement the confirmation parameter according to the Mavlink command
+           documentation */
+        command.long_confirmation = command.long_confirmation + 1;
+    }
+    transmitCommand(pending.get());
+}
+
+
+void MavlinkBase::processCommandAck(const mavlink_message_t &msg) {
+    mavlink_command_ack_t ack;
+    mavlink_msg_command_ack_decode(&msg, &ack);
+
+    auto key = commandKey(msg.sysid, msg.compid, ack.command);
+
+    if (!m_pending_commands.contains(key)) {
+        /* the command may have been sent to a broadcast system or component, in which case
+           the first pending command with a matching id is the one being acknowledged */
+        bool found = false;
+        for (auto it = m_pending_commands.constBegin(); it != m_pending_commands.constEnd(); ++it) {
+            auto &command = it.value()->command;
+            if (command.command_id == ack.command &&
+                (command.target_system == 0 || command.target_system == msg.sysid) &&
+                (command.target_component == 0 || command.target_component == msg.compid)) {
+                key = it.key();
+                found = true;
+                break;
             }
+        }
+        if (!found) {
+            return;
+        }
+    }
+
+    switch (ack.result) {
+        case MAV_RESULT_ACCEPTED: {
+            completeCommand(key, true, ack.result);
             break;
         }
-        case MavlinkCommandStateDone: {
-            m_current_command.reset();
-            emit commandDone();
-            m_command_state = MavlinkCommandStateReady;
+        case MAV_RESULT_IN_PROGRESS: {
+            /* the target is working on it, stop resending and give it longer to finish, each
+               progress update extends that again */
+            auto pending = m_pending_commands.value(key);
+            pending->in_progress = true;
+            pending->deadline->start(CommandProgressTimeout);
             break;
         }
-        case MavlinkCommandStateFailed: {
-            m_current_command.reset();
-            emit commandFailed();
-            m_command_state = MavlinkCommandStateReady;
+        default: {
+            completeCommand(key, false, ack.result);
             break;
         }
     }
 }
+
+
+void MavlinkBase::completeCommand(quint32 key, bool success, uint8_t result) {
+    auto pending = m_pending_commands.take(key);
+    if (!pending) {
+        return;
+    }
+    set_commands_pending(m_pending_commands.size());
+
+    pending->deadline->stop();
+    pending->deadline->deleteLater();
+
+    auto latency = pending->first_sent.elapsed();
+    auto retries = pending->command.retry_count;
+
+    if (success) {
+        set_command_latency_ms(latency);
+    }
+    emit commandCompleted(pending->command.command_id, success, latency, retries);
+
+    if (pending->callback) {
+        pending->callback(success, result);
+    }
+
+    if (success) {
+        emit commandDone();
+    } else {
+        emit commandFailed();
+    }
+}
+
+
+void MavlinkBase::set_command_latency_ms(qint64 command_latency_ms) {
+    m_command_latency_ms = command_latency_ms;
+    emit command_latency_ms_changed(m_command_latency_ms);
+}
+
+
+void MavlinkBase::set_command_retries(int command_retries) {
+    m_command_retries = command_retries;
+    emit command_retries_changed(m_command_retries);
+}
+
+
+void MavlinkBase::set_commands_pending(int commands_pending) {
+    m_commands_pending = commands_pending;
+    emit commands_pending_changed(m_commands_pending);
+}
@@ -0,0 +1,291 @@
+#include "mavlinkrouter.h"
+
+#include <QtNetwork>
+
+#if defined(__rasp_pi__) || defined(__desktoplinux__)
+#define MAVLINK_ROUTER_SENDMMSG
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <string.h>
+#endif
+
+
+// a TCP endpoint with more than this waiting to be written is considered stalled
+static const qint64 MaxTCPBacklog = 64 * 1024;
+
+// queued datagrams are flushed early once there are this many
+static const int MaxQueuedDatagrams = 64;
+
+
+MavlinkRouter::MavlinkRouter(QObject *parent): QObject(parent) {
+    qDebug() << "MavlinkRouter::MavlinkRouter()";
+
+    m_reconnect_timer = new QTimer(this);
+    connect(m_reconnect_timer, &QTimer::timeout, this, &MavlinkRouter::reconnectTCP);
+    m_reconnect_timer->start(1000);
+
+    m_stats_timer = new QTimer(this);
+    connect(m_stats_timer, &QTimer::timeout, this, &MavlinkRouter::updateStats);
+    m_stats_timer->start(1000);
+}
+
+
+MavlinkRouter::~MavlinkRouter() {
+    clearEndpoints();
+}
+
+
+void MavlinkRouter::clearEndpoints() {
+    for (auto endpoint : m_endpoints) {
+        if (endpoint->lookup_id != -1) {
+            QHostInfo::abortHostLookup(endpoint->lookup_id);
+        }
+        QObject::disconnect(endpoint->socket, nullptr, this, nullptr);
+        endpoint->socket->deleteLater();
+        delete endpoint;
+    }
+    m_endpoints.clear();
+}
+
+
+void MavlinkRouter::setEndpoints(QString endpoints) {
+    clearEndpoints();
+    m_queue.clear();
+
+    for (auto &entry : endpoints.split(",", QString::SkipEmptyParts)) {
+        auto parts = entry.trimmed().split(":");
+        if (parts.size() != 3) {
+            qDebug() << "MavlinkRouter: ignoring invalid endpoint" << entry;
+            continue;
+        }
+
+        bool port_ok = false;
+        auto port = parts[2].toUShort(&port_ok);
+        if (!port_ok || port == 0) {
+            qDebug() << "MavlinkRouter: ignoring endpoint with invalid port" << entry;
+            continue;
+        }
+
+        auto endpoint = new MavlinkEndpoint();
+        endpoint->host = parts[1];
+        endpoint->address = QHostAddress(parts[1]);
+        endpoint->port = port;
+
+        if (parts[0] == "udp") {
+            endpoint->type = MavlinkEndpointTypeUDP;
+            auto socket = new QUdpSocket(this);
+            // bind to any port so the endpoint has somewhere to send replies
+            socket->bind(QHostAddress::Any, 0);
+            connect(socket, &QUdpSocket::readyRead, this, [this, endpoint] {
+                readEndpoint(endpoint);
+            });
+            endpoint->socket = socket;
+
+            if (endpoint->address.isNull()) {
+                // not an address, so a host name, QTcpSocket does this itself
+                endpoint->error = "resolving";
+                endpoint->lookup_id = QHostInfo::lookupHost(endpoint->host, this, SLOT(hostLookedUp(QHostInfo)));
+            }
+        } else if (parts[0] == "tcp") {
+            endpoint->type = MavlinkEndpointTypeTCP;
+            auto socket = new QTcpSocket(this);
+            connect(socket, &QTcpSocket::readyRead, this, [this, endpoint] {
+                readEndpoint(endpoint);
+            });
+            socket->connectToHost(endpoint->host, endpoint->port);
+            endpoint->socket = socket;
+        } else {
+            qDebug() << "MavlinkRouter: ignoring endpoint with unknown type" << entry;
+            delete endpoint;
+            continue;
+        }
+
+        qDebug() << "MavlinkRouter: forwarding to" << entry;
+        m_endpoints.append(endpoint);
+    }
+
+    updateStats();
+}
+
+
+void MavlinkRouter::hostLookedUp(QHostInfo info) {
+    for (auto endpoint : m_endpoints) {
+        if (endpoint->lookup_id != info.lookupId()) {
+            continue;
+        }
+        endpoint->lookup_id = -1;
+
+        // sendmmsg() is only used for IPv4, so that's preferred when the name has both
+        QHostAddress address;
+        for (auto &candidate : info.addresses()) {
+            if (candidate.protocol() == QAbstractSocket::IPv4Protocol) {
+                address = candidate;
+                break;
+            }
+        }
+        if (address.isNull() && !info.addresses().isEmpty()) {
+            address = info.addresses().first();
+        }
+
+        if (info.error() != QHostInfo::NoError || address.isNull()) {
+            endpoint->error = info.errorString();
+            qDebug() << "MavlinkRouter: couldn't resolve" << endpoint->host << info.errorString();
+        } else {
+            endpoint->address = address;
+            endpoint->error.clear();
+            qDebug() << "MavlinkRouter:" << endpoint->host << "is" << address.toString();
+        }
+        updateStats();
+        return;
+    }
+}
+
+
+void MavlinkRouter::reconnectTCP() {
+    for (auto endpoint : m_endpoints) {
+        if (endpoint->type != MavlinkEndpointTypeTCP) {
+            continue;
+        }
+        auto socket = (QTcpSocket*)endpoint->socket;
+        if (socket->state() == QAbstractSocket::UnconnectedState) {
+            socket->connectToHost(endpoint->host, endpoint->port);
+        }
+    }
+}
+
+
+void MavlinkRouter::readEndpoint(MavlinkEndpoint* endpoint) {
+    if (endpoint->type == MavlinkEndpointTypeUDP) {
+        auto socket = (QUdpSocket*)endpoint->socket;
+        while (socket->hasPendingDatagrams()) {
+            QByteArray datagram;
+            datagram.resize(int(socket->pendingDatagramSize()));
+            socket->readDatagram(datagram.data(), datagram.size());
+            endpoint->received++;
+            emit dataFromEndpoint(datagram);
+        }
+    } else {
+        auto data = endpoint->socket->readAll();
+        endpoint->received++;
+        emit dataFromEndpoint(data);
+    }
+}
+
+
+void MavlinkRouter::forward(const QByteArray &data) {
+    if (m_endpoints.isEmpty()) {
+        return;
+    }
+    m_queue.append(data);
+    if (m_queue.size() >= MaxQueuedDatagrams) {
+        flush();
+    }
+}
+
+
+void MavlinkRouter::flush() {
+    if (m_queue.isEmpty()) {
+        return;
+    }
+    for (auto endpoint : m_endpoints) {
+        if (endpoint->type == MavlinkEndpointTypeUDP) {
+            sendUDP(endpoint);
+        } else {
+            sendTCP(endpoint);
+        }
+    }
+    m_queue.clear();
+}
+
+
+void MavlinkRouter::sendUDP(MavlinkEndpoint* endpoint) {
+    auto socket = (QUdpSocket*)endpoint->socket;
+
+    if (endpoint->address.isNull()) {
+        // still resolving, or the name couldn't be, the stats carry the error
+        return;
+    }
+
+#if defined(MAVLINK_ROUTER_SENDMMSG)
+    bool is_ipv4 = false;
+    quint32 ipv4 = endpoint->address.toIPv4Address(&is_ipv4);
+
+    if (is_ipv4 && socket->socketDescriptor() != -1) {
+        sockaddr_in destination;
+        memset(&destination, 0, sizeof(destination));
+        destination.sin_family = AF_INET;
+        destination.sin_port = htons(endpoint->port);
+        destination.sin_addr.s_addr = htonl(ipv4);
+
+        int count = m_queue.size();
+        QVarLengthArray<mmsghdr, MaxQueuedDatagrams> messages(count);
+        QVarLengthArray<iovec, MaxQueuedDatagrams> vectors(count);
+
+        for (int i = 0; i < count; i++) {
+            vectors[i].iov_base = (void*)m_queue[i].constData();
+            vectors[i].iov_len = m_queue[i].size();
+
+            memset(&messages[i], 0, sizeof(mmsghdr));
+            messages[i].msg_hdr.msg_name = &destination;
+            messages[i].msg_hdr.msg_namelen = sizeof(destination);
+            messages[i].msg_hdr.msg_iov = &vectors[i];
+            messages[i].msg_hdr.msg_iovlen = 1;
+        }
+
+        int sent = sendmmsg(socket->socketDescriptor(), messages.data(), count, MSG_DONTWAIT);
+        if (sent < 0) {
+            sent = 0;
+        }
+        endpoint->forwarded += sent;
+        // whatever didn't fit in the socket buffer is dropped rather than queued
+        endpoint->dropped += count - sent;
+        return;
+    }
+#endif
+
+    for (auto &datagram : m_queue) {
+        if (socket->writeDatagram(datagram, endpoint->address, endpoint->port) < 0) {
+            endpoint->dropped++;
+        } else {
+            endpoint->forwarded++;
+        }
+    }
+}
+
+
+void MavlinkRouter::sendTCP(MavlinkEndpoint* endpoint) {
+    auto socket = (QTcpSocket*)endpoint->socket;
+
+    if (socket->state() != QAbstractSocket::ConnectedState) {
+        return;
+    }
+
+    for (auto &data : m_queue) {
+        if (socket->bytesToWrite() > MaxTCPBacklog) {
+            endpoint->dropped++;
+            continue;
+        }
+        socket->write(data);
+        endpoint->forwarded++;
+    }
+}
+
+
+void MavlinkRouter::updateStats() {
+    QVariantList stats;
+    for (auto endpoint : m_endpoints) {
+        QVariantMap entry;
+        entry.insert("type", endpoint->type == MavlinkEndpointTypeUDP ? "udp" : "tcp");
+        entry.insert("host", endpoint->host);
+        entry.insert("port", endpoint->port);
+        entry.insert("forwarded", endpoint->forwarded);
+        entry.insert("dropped", endpoint->dropped);
+        entry.insert("received", endpoint->received);
+        entry.insert("error", endpoint->error);
+        stats.append(entry);
+    }
+    m_endpoint_stats = stats;
+    emit endpoint_stats_changed(m_endpoint_stats);
+}
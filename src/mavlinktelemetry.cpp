@@ -14,6 +14,7 @@
 
 #include <openhd/mavlink.h>
 
+#include "logger.h"
 #include "util.h"
 #include "constants.h"
 
@@ -21,6 +22,8 @@
 #include "powermicroservice.h"
 
 #include "localmessage.h"
+#include "telemetrysubscriptions.h"
+#include "mavlinkrouter.h"
 
 static MavlinkTelemetry* _instance = nullptr;
 
@@ -47,11 +50,34 @@ MavlinkTelemetry::MavlinkTelemetry(QObject *parent): MavlinkBase(parent) {
 
 }
 
+TelemetryPublisher* MavlinkTelemetry::telemetryPublisher() {
+    return &m_telemetry;
+}
+
+
 void MavlinkTelemetry::onSetup() {
     qDebug() << "MavlinkTelemetry::onSetup()";
 
     connect(this, &MavlinkTelemetry::processMavlinkMessage, this, &MavlinkTelemetry::onProcessMavlinkMessage);
 
+    /* widgets tend to change visibility in groups, so wait for things to settle before
+       sending anything to the flight controller */
+    m_rates_timer = new QTimer(this);
+    m_rates_timer->setSingleShot(true);
+    connect(m_rates_timer, &QTimer::timeout, this, &MavlinkTelemetry::applyRates);
+    connect(TelemetrySubscriptions::instance(), &TelemetrySubscriptions::ratesChanged, this, &MavlinkTelemetry::onRatesChanged);
+
+    QSettings settings;
+    auto forward_endpoints = settings.value("mavlink_forward_endpoints", QVariant("")).toString();
+
+    m_router = new MavlinkRouter(this);
+    connect(m_router, &MavlinkRouter::endpoint_stats_changed, this, &MavlinkTelemetry::set_forward_stats);
+    // whatever the other ground control software sends goes to the vehicle
+    connect(m_router, &MavlinkRouter::dataFromEndpoint, this, [this](QByteArray data) {
+        writeData(data.data(), data.size());
+    });
+    m_router->setEndpoints(forward_endpoints);
+
     timer = new QTimer(this);
     connect(timer, &QTimer::timeout, this, &MavlinkTelemetry::stateLoop);
     resetParamVars();
@@ -59,6 +85,182 @@ void MavlinkTelemetry::onSetup() {
 }
 
 
+void MavlinkTelemetry::setForwardEndpoints(QString endpoints) {
+    QSettings settings;
+    settings.setValue("mavlink_forward_endpoints", endpoints);
+
+    QMetaObject::invokeMethod(this, [this, endpoints] {
+        if (m_router) {
+            m_router->setEndpoints(endpoints);
+        }
+        // whether anything else is listening changes which streams can be turned off
+        onRatesChanged();
+    }, Qt::QueuedConnection);
+}
+
+
+void MavlinkTelemetry::sendRCOverride(const uint16_t* channels, int count, uint32_t mapped) {
+    if (m_rc_sysid < 0) {
+        QSettings settings;
+        m_rc_sysid = settings.value("mavlink_sysid", default_mavlink_sysid()).toInt();
+    }
+
+    /*
+     * UINT16_MAX tells the flight controller to ignore a field and keep whatever it had, which
+     * is only right past count. An unmapped channel is released back to the flight controller's
+     * own receiver instead, that's 0 for channels 1-8 and UINT16_MAX - 1 for 9-18, so a channel
+     * that just lost its mapping doesn't keep its last override.
+     */
+    uint16_t raw[18];
+    for (int i = 0; i < 18; i++) {
+        if (i >= count) {
+            raw[i] = UINT16_MAX;
+        } else if (mapped & (1u << i)) {
+            raw[i] = channels[i];
+        } else {
+            raw[i] = i < 8 ? 0 : UINT16_MAX - 1;
+        }
+    }
+
+    mavlink_message_t msg;
+    mavlink_msg_rc_channels_override_pack(m_rc_sysid, MAV_COMP_ID_MISSIONPLANNER, &msg, targetSysID, targetCompID1,
+                                          raw[0], raw[1], raw[2], raw[3], raw[4], raw[5], raw[6], raw[7], raw[8],
+                                          raw[9], raw[10], raw[11], raw[12], raw[13], raw[14], raw[15], raw[16], raw[17]);
+
+    uint8_t buffer[MAVLINK_MAX_PACKET_LEN];
+    int len = mavlink_msg_to_send_buffer(buffer, &msg);
+
+    // the pilot's sticks, not a reaction to telemetry, so a replay doesn't hold them back
+    writeData((char*)buffer, len);
+}
+
+
+void MavlinkTelemetry::set_forward_stats(QVariantList forward_stats) {
+    m_forward_stats = forward_stats;
+    emit forward_stats_changed(m_forward_stats);
+}
+
+
+void MavlinkTelemetry::onRatesChanged() {
+    m_rates_timer->start(RatesSettleMs);
+}
+
+
+/*
+ * Managed messages nobody needs are turned off with an interval of -1. When other ground
+ * control software is connected through the forwarding endpoints it may rely on them, so
+ * they're put back to the flight controller's default rate (an interval of 0) instead.
+ */
+float MavlinkTelemetry::desiredInterval(double rate) const {
+    if (rate > 0) {
+        return 1000000.0 / rate;
+    }
+    return m_router && m_router->hasEndpoints() ? 0 : -1;
+}
+
+
+// true when a request for this interval is already queued or waiting for its ACK
+bool MavlinkTelemetry::rateRequested(uint32_t message_id, float interval) const {
+    if (m_rate_command_pending && (uint32_t)m_rate_command.long_param1 == message_id && m_rate_command.long_param2 == interval) {
+        return true;
+    }
+    for (auto &command : m_rate_commands) {
+        if ((uint32_t)command.long_param1 == message_id) {
+            return command.long_param2 == interval;
+        }
+    }
+    return false;
+}
+
+
+/*
+ * Compares what the widgets currently need with what the flight controller has acknowledged,
+ * and queues a MAV_CMD_SET_MESSAGE_INTERVAL for each message that differs. A rate only counts
+ * as applied once it's been accepted, so requests that were rejected or never answered are
+ * sent again on the next pass.
+ */
+void MavlinkTelemetry::applyRates() {
+    if (last_heartbeat_timestamp == 0) {
+        // nothing to talk to yet, we'll be called again on the first heartbeat
+        return;
+    }
+    m_rates_applied = true;
+
+    auto rates = TelemetrySubscriptions::instance()->rates();
+
+    for (auto it = rates.constBegin(); it != rates.constEnd(); ++it) {
+        auto message_id = it.key();
+        auto interval = desiredInterval(it.value());
+
+        if (m_applied_intervals.contains(message_id) && m_applied_intervals.value(message_id) == interval) {
+            continue;
+        }
+        if (rateRequested(message_id, interval)) {
+            continue;
+        }
+
+        MavlinkCommand command(MavlinkCommandTypeLong);
+        command.command_id = MAV_CMD_SET_MESSAGE_INTERVAL;
+        command.long_param1 = message_id;
+        command.long_param2 = interval;
+
+        // replace anything still queued for this message
+        for (int i = 0; i < m_rate_commands.size(); i++) {
+            if ((uint32_t)m_rate_commands[i].long_param1 == message_id) {
+                m_rate_commands.removeAt(i);
+                break;
+            }
+        }
+        m_rate_commands.append(command);
+    }
+
+    sendNextRateCommand();
+}
+
+
+/*
+ * Every interval request has the same target and command id, and a COMMAND_ACK can't tell
+ * them apart, so they go out one after another as each one is acknowledged or times out.
+ */
+void MavlinkTelemetry::sendNextRateCommand() {
+    if (m_rate_command_pending || m_rate_commands.isEmpty()) {
+        return;
+    }
+    m_rate_command_pending = true;
+    m_rate_command = m_rate_commands.takeFirst();
+
+    auto message_id = (uint32_t)m_rate_command.long_param1;
+    auto interval = m_rate_command.long_param2;
+    auto generation = m_rates_generation;
+
+    send_command(m_rate_command, [this, message_id, interval, generation](bool success, uint8_t result) {
+        m_rate_command_pending = false;
+
+        if (generation != m_rates_generation) {
+            // sent before the flight controller rebooted, whatever it said has been forgotten
+            m_rates_failed = true;
+        } else {
+            if (success) {
+                m_applied_intervals.insert(message_id, interval);
+            } else if (result == MAV_RESULT_UNSUPPORTED) {
+                // asking again won't change the answer, leave this message at whatever it streams
+                qDebug() << "MavlinkTelemetry: flight controller doesn't support message intervals for" << message_id;
+                m_applied_intervals.insert(message_id, interval);
+            } else {
+                qDebug() << "MavlinkTelemetry: flight controller did not accept a message interval request:" << result;
+                m_rates_failed = true;
+            }
+        }
+
+        if (m_rate_commands.isEmpty() && m_rates_failed) {
+            m_rates_failed = false;
+            m_rates_timer->start(RatesRetryMs);
+        }
+        sendNextRateCommand();
+    });
+}
+
+
 void MavlinkTelemetry::onProcessMavlinkMessage(mavlink_message_t msg) {    
     switch (msg.msgid) {
             case MAVLINK_MSG_ID_HEARTBEAT: {
@@ -69,9 +271,9 @@ void MavlinkTelemetry::onProcessMavlinkMessage(mavlink_message_t msg) {
 
                     if (mode & MAV_MODE_FLAG_SAFETY_ARMED) {
                         // armed
-                        OpenHD::instance()->set_armed(true);
+                        m_telemetry.set_armed(true);
                     } else {
-                        OpenHD::instance()->set_armed(false);
+                        m_telemetry.set_armed(false);
                     }
 
                     auto custom_mode = heartbeat.custom_mode;
@@ -84,24 +286,24 @@ void MavlinkTelemetry::onProcessMavlinkMessage(mavlink_message_t msg) {
                         }
                         case MAV_TYPE_FIXED_WING: {
                             auto plane_mode = plane_mode_from_enum((PLANE_MODE)custom_mode);
-                            OpenHD::instance()->set_flight_mode(plane_mode);
+                            m_telemetry.set_flight_mode(plane_mode.toUtf8().constData());
                             //qDebug() << "Mavlink Mav Type= PLANE";
                             break;
                         }
                         case MAV_TYPE_GROUND_ROVER: {
                             auto rover_mode = rover_mode_from_enum((ROVER_MODE)custom_mode);
-                            OpenHD::instance()->set_flight_mode(rover_mode);
+                            m_telemetry.set_flight_mode(rover_mode.toUtf8().constData());
                             break;
                         }
                         case MAV_TYPE_QUADROTOR: {
                             auto copter_mode = copter_mode_from_enum((COPTER_MODE)custom_mode);
-                            OpenHD::instance()->set_flight_mode(copter_mode);
+                            m_telemetry.set_flight_mode(copter_mode.toUtf8().constData());
                             //qDebug() << "Mavlink Mav Type= QUADROTOR";
                             break;
                         }
                         case MAV_TYPE_SUBMARINE: {
                             auto sub_mode = sub_mode_from_enum((SUB_MODE)custom_mode);
-                            OpenHD::instance()->set_flight_mode(sub_mode);
+                            m_telemetry.set_flight_mode(sub_mode.toUtf8().constData());
                             break;
                         }
                         case MAV_TYPE_ANTENNA_TRACKER: {
@@ -117,6 +319,14 @@ void MavlinkTelemetry::onProcessMavlinkMessage(mavlink_message_t msg) {
                     qint64 current_timestamp = QDateTime::currentMSecsSinceEpoch();
 
                     last_heartbeat_timestamp = current_timestamp;
+
+                    if (!m_replaying) {
+                        emit heartbeat_received();
+                    }
+
+                    if (!m_rates_applied) {
+                        applyRates();
+                    }
                     break;
                 }
 
@@ -125,19 +335,18 @@ void MavlinkTelemetry::onProcessMavlinkMessage(mavlink_message_t msg) {
             mavlink_msg_sys_status_decode(&msg, &sys_status);
 
             auto battery_voltage = (double)sys_status.voltage_battery / 1000.0;
-            OpenHD::instance()->set_battery_voltage(battery_voltage);
+            m_telemetry.set_battery_voltage(battery_voltage);
 
-            OpenHD::instance()->set_battery_current(sys_status.current_battery);
-
-            OpenHD::instance()->updateAppMah();
+            m_telemetry.set_battery_current(sys_status.current_battery);
 
             QSettings settings;
             auto battery_cells = settings.value("battery_cells", QVariant(3)).toInt();
 
             int battery_percent = lipo_battery_voltage_to_percent(battery_cells, battery_voltage);
-            OpenHD::instance()->set_battery_percent(battery_percent);
-            QString battery_gauge_glyph = battery_gauge_glyph_from_percentage(battery_percent);
-            OpenHD::instance()->set_battery_gauge(battery_gauge_glyph);
+            m_telemetry.set_battery_percent(battery_percent);
+
+            // the battery gauge glyph and app mAh are derived from these on the GUI thread
+            m_telemetry.battery_updated();
             break;
         }
 
@@ -146,42 +355,28 @@ void MavlinkTelemetry::onProcessMavlinkMessage(mavlink_message_t msg) {
             mavlink_msg_system_time_decode(&msg, &sys_time);
             uint32_t boot_time = sys_time.time_boot_ms;
 
-            if (boot_time != m_last_boot) {
-                m_last_boot = boot_time;
+            /* the flight controller forgets requested message intervals when it reboots,
+               which we can see as the boot time going backwards */
+            if (m_last_boot != 0 && boot_time < m_last_boot) {
+                qDebug() << "MavlinkTelemetry: flight controller rebooted, requesting message rates again";
+                m_applied_intervals.clear();
+                m_rate_commands.clear();
+                m_rates_generation++;
+                applyRates();
             }
+            m_last_boot = boot_time;
 
             break;
         }
         case MAVLINK_MSG_ID_PARAM_VALUE:{
-            mavlink_param_value_t param;
-            mavlink_msg_param_value_decode(&msg, &param);
-
-            parameterCount = param.param_count;
-            parameterIndex = param.param_index;
-
-            parameterLastReceivedTime = QDateTime::currentMSecsSinceEpoch();
-
-            QByteArray param_id(param.param_id, 16);
-            /*
-             * If there's no null in the param_id array, the mavlink docs say it has to be exactly 16 characters,
-             * so we add a null to the end and then continue. This guarantees that QString below will always find
-             * a null terminator.
-             *
-             */
-            if (!param_id.contains('\0')) {
-               param_id.append('\0');
-            }
-
-            QString s(param_id.data());
-
-            m_allParameters.insert(s, QVariant(param.param_value));
+            // handled by MavlinkBase
             break;
         }
         case MAVLINK_MSG_ID_GPS_RAW_INT:{
             mavlink_gps_raw_int_t gps_status;
             mavlink_msg_gps_raw_int_decode(&msg, &gps_status);
-            OpenHD::instance()->set_satellites_visible(gps_status.satellites_visible);
-            OpenHD::instance()->set_gps_hdop(gps_status.eph / 100.0);
+            m_telemetry.set_satellites_visible(gps_status.satellites_visible);
+            m_telemetry.set_gps_hdop(gps_status.eph / 100.0);
             break;
         }
         case MAVLINK_MSG_ID_GPS_STATUS: {
@@ -194,7 +389,7 @@ void MavlinkTelemetry::onProcessMavlinkMessage(mavlink_message_t msg) {
         mavlink_scaled_pressure_t raw_imu;
         mavlink_msg_scaled_pressure_decode(&msg, &raw_imu);
 
-        OpenHD::instance()->set_fc_temp((int)raw_imu.temperature/100);
+        m_telemetry.set_fc_temp((int)raw_imu.temperature/100);
         //qDebug() << "Temp:" <<  raw_imu.temperature;
             break;
         }
@@ -202,10 +397,10 @@ void MavlinkTelemetry::onProcessMavlinkMessage(mavlink_message_t msg) {
             mavlink_attitude_t attitude;
             mavlink_msg_attitude_decode (&msg, &attitude);
 
-            OpenHD::instance()->set_pitch((double)attitude.pitch *57.2958);
+            m_telemetry.set_pitch((double)attitude.pitch *57.2958);
             //qDebug() << "Pitch:" <<  attitude.pitch*57.2958;
 
-            OpenHD::instance()->set_roll((double)attitude.roll *57.2958);
+            m_telemetry.set_roll((double)attitude.roll *57.2958);
             //qDebug() << "Roll:" <<  attitude.roll*57.2958;
             break;
         }
@@ -216,37 +411,30 @@ void MavlinkTelemetry::onProcessMavlinkMessage(mavlink_message_t msg) {
             mavlink_global_position_int_t global_position;
             mavlink_msg_global_position_int_decode(&msg, &global_position);
 
-            OpenHD::instance()->set_lat((double)global_position.lat / 10000000.0);
-            OpenHD::instance()->set_lon((double)global_position.lon / 10000000.0);
+            m_telemetry.set_lat((double)global_position.lat / 10000000.0);
+            m_telemetry.set_lon((double)global_position.lon / 10000000.0);
 
-            OpenHD::instance()->set_boot_time(global_position.time_boot_ms);
+            m_telemetry.set_boot_time(global_position.time_boot_ms);
 
-            OpenHD::instance()->set_alt_rel(global_position.relative_alt/1000.0);
+            m_telemetry.set_alt_rel(global_position.relative_alt/1000.0);
             // qDebug() << "Altitude relative " << alt_rel;
-            OpenHD::instance()->set_alt_msl(global_position.alt/1000.0);
+            m_telemetry.set_alt_msl(global_position.alt/1000.0);
 
             // FOR INAV heading does not /100
             QSettings settings;
             auto _heading_inav = settings.value("heading_inav", false).toBool();
             if(_heading_inav==true){
-                OpenHD::instance()->set_hdg(global_position.hdg);
+                m_telemetry.set_hdg(global_position.hdg);
             }
             else{
-                OpenHD::instance()->set_hdg(global_position.hdg / 100);
+                m_telemetry.set_hdg(global_position.hdg / 100);
             }
-            OpenHD::instance()->set_vx(global_position.vx/100.0);
-            OpenHD::instance()->set_vy(global_position.vy/100.0);
-            OpenHD::instance()->set_vz(global_position.vz/100.0);
+            m_telemetry.set_vx(global_position.vx/100.0);
+            m_telemetry.set_vy(global_position.vy/100.0);
+            m_telemetry.set_vz(global_position.vz/100.0);
 
-            OpenHD::instance()->findGcsPosition();
-            OpenHD::instance()->calculate_home_distance();
-            OpenHD::instance()->calculate_home_course();
-
-            OpenHD::instance()->updateFlightDistance();
-
-            OpenHD::instance()->updateLateralSpeed();
-
-            OpenHD::instance()->updateWind();
+            // home distance/course, flight distance, lateral speed and wind are derived on the GUI thread
+            m_telemetry.position_updated();
 
             break;
         }
@@ -255,9 +443,9 @@ void MavlinkTelemetry::onProcessMavlinkMessage(mavlink_message_t msg) {
             mavlink_msg_rc_channels_raw_decode(&msg, &rc_channels_raw);
 
             auto rssi = static_cast<int>(static_cast<double>(rc_channels_raw.rssi) / 255.0 * 100.0);
-            OpenHD::instance()->set_rc_rssi(rssi);
+            m_telemetry.set_rc_rssi(rssi);
 
-            qDebug() << "RC RSSI: " << rc_channels_raw.rssi;
+            LOG_RATE_LIMITED(5000, QtDebugMsg, "RC RSSI: %d", rc_channels_raw.rssi);
             break;
         }
         case MAVLINK_MSG_ID_SERVO_OUTPUT_RAW:{
@@ -276,19 +464,16 @@ void MavlinkTelemetry::onProcessMavlinkMessage(mavlink_message_t msg) {
             mavlink_rc_channels_t rc_channels;
             mavlink_msg_rc_channels_decode(&msg, &rc_channels);
 
-            OpenHD::instance()->set_control_pitch(rc_channels.chan2_raw);
-            OpenHD::instance()->set_control_roll(rc_channels.chan1_raw);
-            OpenHD::instance()->set_control_throttle(rc_channels.chan3_raw);
-            OpenHD::instance()->set_control_yaw(rc_channels.chan4_raw);
+            m_telemetry.set_control(rc_channels.chan2_raw, rc_channels.chan1_raw, rc_channels.chan3_raw, rc_channels.chan4_raw);
 
-            OpenHD::instance()->setRCChannel1(rc_channels.chan1_raw);
-            OpenHD::instance()->setRCChannel2(rc_channels.chan2_raw);
-            OpenHD::instance()->setRCChannel3(rc_channels.chan3_raw);
-            OpenHD::instance()->setRCChannel4(rc_channels.chan4_raw);
-            OpenHD::instance()->setRCChannel5(rc_channels.chan5_raw);
-            OpenHD::instance()->setRCChannel6(rc_channels.chan6_raw);
-            OpenHD::instance()->setRCChannel7(rc_channels.chan7_raw);
-            OpenHD::instance()->setRCChannel8(rc_channels.chan8_raw);
+            m_telemetry.set_rc_channel(0, rc_channels.chan1_raw);
+            m_telemetry.set_rc_channel(1, rc_channels.chan2_raw);
+            m_telemetry.set_rc_channel(2, rc_channels.chan3_raw);
+            m_telemetry.set_rc_channel(3, rc_channels.chan4_raw);
+            m_telemetry.set_rc_channel(4, rc_channels.chan5_raw);
+            m_telemetry.set_rc_channel(5, rc_channels.chan6_raw);
+            m_telemetry.set_rc_channel(6, rc_channels.chan7_raw);
+            m_telemetry.set_rc_channel(7, rc_channels.chan8_raw);
 
 
             /*qDebug() << "RC: " << rc_channels.chan1_raw
@@ -307,17 +492,17 @@ void MavlinkTelemetry::onProcessMavlinkMessage(mavlink_message_t msg) {
             mavlink_vfr_hud_t vfr_hud;
             mavlink_msg_vfr_hud_decode (&msg, &vfr_hud);
 
-            OpenHD::instance()->set_throttle(vfr_hud.throttle);
+            m_telemetry.set_throttle(vfr_hud.throttle);
 
             auto airspeed = vfr_hud.airspeed*3.6;
-            OpenHD::instance()->set_airspeed(airspeed);
+            m_telemetry.set_airspeed(airspeed);
 
             auto speed = vfr_hud.groundspeed*3.6;
-            OpenHD::instance()->set_speed(speed);
+            m_telemetry.set_speed(speed);
             // qDebug() << "Speed- ground " << speed;
 
             auto vsi = vfr_hud.climb;
-            OpenHD::instance()->set_vsi(vsi);
+            m_telemetry.set_vsi(vsi);
             // qDebug() << "VSI- " << vsi;
 
             break;
@@ -336,8 +521,7 @@ void MavlinkTelemetry::onProcessMavlinkMessage(mavlink_message_t msg) {
         mavlink_wind_t mav_wind;
         mavlink_msg_wind_decode(&msg, &mav_wind);
 
-        OpenHD::instance()->set_mav_wind_direction(mav_wind.direction);
-        OpenHD::instance()->set_mav_wind_speed(mav_wind.speed);
+        m_telemetry.set_mav_wind(mav_wind.direction, mav_wind.speed);
 
 
         /*qDebug() << "Windmavdir: " << mav_wind.direction;
@@ -350,7 +534,7 @@ void MavlinkTelemetry::onProcessMavlinkMessage(mavlink_message_t msg) {
             mavlink_battery_status_t battery_status;
             mavlink_msg_battery_status_decode(&msg, &battery_status);
 
-            OpenHD::instance()->set_flight_mah(battery_status.current_consumed);
+            m_telemetry.set_flight_mah(battery_status.current_consumed);
 
             int total_voltage = 0;
             for (int cell = 0; cell < 10; cell++) {
@@ -393,13 +577,8 @@ void MavlinkTelemetry::onProcessMavlinkMessage(mavlink_message_t msg) {
         mavlink_vibration_t vibration;
         mavlink_msg_vibration_decode (&msg, &vibration);
 
-        OpenHD::instance()->set_vibration_x(vibration.vibration_x);
-        OpenHD::instance()->set_vibration_y(vibration.vibration_y);
-        OpenHD::instance()->set_vibration_z(vibration.vibration_z);
-
-        OpenHD::instance()->set_clipping_x(vibration.clipping_0);
-        OpenHD::instance()->set_clipping_y(vibration.clipping_1);
-        OpenHD::instance()->set_clipping_z(vibration.clipping_2);
+        m_telemetry.set_vibration(vibration.vibration_x, vibration.vibration_y, vibration.vibration_z,
+                                  vibration.clipping_0, vibration.clipping_1, vibration.clipping_2);
             break;
         }
         case MAVLINK_MSG_ID_SCALED_IMU2:{
@@ -414,9 +593,10 @@ void MavlinkTelemetry::onProcessMavlinkMessage(mavlink_message_t msg) {
         case MAVLINK_MSG_ID_HOME_POSITION:{
             mavlink_home_position_t home_position;
             mavlink_msg_home_position_decode(&msg, &home_position);
-            OpenHD::instance()->set_homelat((double)home_position.latitude / 10000000.0);
-            OpenHD::instance()->set_homelon((double)home_position.longitude / 10000000.0);
-            LocalMessage::instance()->showMessage("Home Position set by OpenHD", 2);
+            m_telemetry.set_home((double)home_position.latitude / 10000000.0, (double)home_position.longitude / 10000000.0);
+            QMetaObject::invokeMethod(LocalMessage::instance(), [] {
+                LocalMessage::instance()->showMessage("Home Position set by OpenHD", 2);
+            }, Qt::QueuedConnection);
             break;
         }
         case MAVLINK_MSG_ID_STATUSTEXT: {
@@ -465,16 +645,21 @@ void MavlinkTelemetry::onProcessMavlinkMessage(mavlink_message_t msg) {
 
             QString s(param_id.data());
 
-            OpenHD::instance()->messageReceived(s, level);
+            QMetaObject::invokeMethod(OpenHD::instance(), [s, level] {
+                emit OpenHD::instance()->messageReceived(s, level);
+            }, Qt::QueuedConnection);
             break;
         }
         case MAVLINK_MSG_ID_ESC_TELEMETRY_1_TO_4: {
             break;
         }
         default: {
-            printf("MavlinkTelemetry received unmatched message with ID %d, sequence: %d from component %d of system %d\n", msg.msgid, msg.seq, msg.compid, msg.sysid);
+            LOG_EVENT(LogEventUnmatchedMavlink, msg.msgid, msg.sysid << 8 | msg.compid);
+            LOG_RATE_LIMITED(1000, QtDebugMsg, "MavlinkTelemetry received unmatched message with ID %d, sequence: %d from component %d of system %d", msg.msgid, msg.seq, msg.compid, msg.sysid);
             break;
         }
     }
+
+    m_telemetry.publish();
 }
 
@@ -0,0 +1,222 @@
+#include "mspprotocol.h"
+
+
+static uint8_t crc8DVBS2(uint8_t crc, uint8_t byte) {
+    crc ^= byte;
+    for (int i = 0; i < 8; i++) {
+        if (crc & 0x80) {
+            crc = (uint8_t)((crc << 1) ^ 0xD5);
+        } else {
+            crc = (uint8_t)(crc << 1);
+        }
+    }
+    return crc;
+}
+
+
+bool MSPStatus::decode(FrameReader payload) {
+    cycle_time = payload.u16();
+    i2c_errors = payload.u16();
+    sensors = payload.u16();
+    flight_mode_flags = payload.u32();
+    profile = payload.u8();
+    return !payload.overrun();
+}
+
+
+bool MSPRawGPS::decode(FrameReader payload) {
+    fix = payload.u8();
+    satellites = payload.u8();
+    lat = payload.i32();
+    lon = payload.i32();
+    altitude = payload.i16();
+    ground_speed = payload.u16();
+    ground_course = payload.u16();
+
+    has_hdop = payload.remaining() >= 2;
+    if (has_hdop) {
+        hdop = payload.u16();
+    }
+    return !payload.overrun();
+}
+
+
+bool MSPAttitude::decode(FrameReader payload) {
+    roll = payload.i16();
+    pitch = payload.i16();
+    yaw = payload.i16();
+    return !payload.overrun();
+}
+
+
+bool MSPAltitude::decode(FrameReader payload) {
+    altitude = payload.i32();
+    vario = payload.i16();
+    return !payload.overrun();
+}
+
+
+bool MSPAnalog::decode(FrameReader payload) {
+    vbat = payload.u8();
+    mah_drawn = payload.u16();
+    rssi = payload.u16();
+    amperage = payload.i16();
+
+    has_voltage = payload.remaining() >= 2;
+    if (has_voltage) {
+        voltage = payload.u16();
+    }
+    return !payload.overrun();
+}
+
+
+void MSPParser::reset() {
+    m_state = MSPParserStateIdle;
+}
+
+
+void MSPParser::checksum(uint8_t byte) {
+    if (m_version == 1) {
+        m_checksum ^= byte;
+    } else {
+        m_checksum = crc8DVBS2(m_checksum, byte);
+    }
+}
+
+
+bool MSPParser::push(uint8_t byte) {
+    m_stats.bytes++;
+
+    switch (m_state) {
+        case MSPParserStateIdle: {
+            if (byte == '$') {
+                m_state = MSPParserStateHeader;
+            }
+            return false;
+        }
+        case MSPParserStateHeader: {
+            if (byte == 'M') {
+                m_version = 1;
+                m_state = MSPParserStateDirection;
+            } else if (byte == 'X') {
+                m_version = 2;
+                m_state = MSPParserStateDirection;
+            } else {
+                m_state = (byte == '$') ? MSPParserStateHeader : MSPParserStateIdle;
+            }
+            return false;
+        }
+        case MSPParserStateDirection: {
+            if (byte == '>' || byte == '!') {
+                m_error = (byte == '!');
+                m_checksum = 0;
+                m_state = (m_version == 1) ? MSPParserStateV1Size : MSPParserStateV2Flag;
+            } else {
+                // requests ('<') are our own, anything else isn't MSP
+                m_state = (byte == '$') ? MSPParserStateHeader : MSPParserStateIdle;
+            }
+            return false;
+        }
+        case MSPParserStateV1Size: {
+            checksum(byte);
+            m_size = byte;
+            m_state = MSPParserStateV1Command;
+            return false;
+        }
+        case MSPParserStateV1Command: {
+            checksum(byte);
+            m_command = byte;
+            break;
+        }
+        case MSPParserStateV2Flag: {
+            checksum(byte);
+            m_flag = byte;
+            m_state = MSPParserStateV2CommandLow;
+            return false;
+        }
+        case MSPParserStateV2CommandLow: {
+            checksum(byte);
+            m_command = byte;
+            m_state = MSPParserStateV2CommandHigh;
+            return false;
+        }
+        case MSPParserStateV2CommandHigh: {
+            checksum(byte);
+            m_command |= (uint16_t)byte << 8;
+            m_state = MSPParserStateV2SizeLow;
+            return false;
+        }
+        case MSPParserStateV2SizeLow: {
+            checksum(byte);
+            m_size = byte;
+            m_state = MSPParserStateV2SizeHigh;
+            return false;
+        }
+        case MSPParserStateV2SizeHigh: {
+            checksum(byte);
+            m_size |= byte << 8;
+            break;
+        }
+        case MSPParserStatePayload: {
+            checksum(byte);
+            m_payload[m_received++] = byte;
+            if (m_received == m_size) {
+                m_state = MSPParserStateChecksum;
+            }
+            return false;
+        }
+        case MSPParserStateChecksum: {
+            bool valid = (byte == m_checksum);
+            reset();
+            if (!valid) {
+                m_stats.checksum_errors++;
+                return false;
+            }
+            if (m_error) {
+                m_stats.dropped++;
+                return false;
+            }
+            m_stats.frames++;
+            return true;
+        }
+    }
+
+    // the header is complete, m_size is known
+    if (m_size > MaxPayload) {
+        m_stats.dropped++;
+        reset();
+        return false;
+    }
+    m_received = 0;
+    m_state = (m_size == 0) ? MSPParserStateChecksum : MSPParserStatePayload;
+    return false;
+}
+
+
+int mspEncodeRequest(uint8_t* buffer, uint16_t command) {
+    if (command < 255) {
+        buffer[0] = '$';
+        buffer[1] = 'M';
+        buffer[2] = '<';
+        buffer[3] = 0;
+        buffer[4] = (uint8_t)command;
+        buffer[5] = buffer[3] ^ buffer[4];
+        return 6;
+    }
+
+    buffer[0] = '$';
+    buffer[1] = 'X';
+    buffer[2] = '<';
+    buffer[3] = 0;
+    buffer[4] = command & 0xff;
+    buffer[5] = command >> 8;
+    buffer[6] = 0;
+    buffer[7] = 0;
+
+    uint8_t crc = 0;
+    for (int i = 3; i < 8; i++) {
+        crc = crc8DVBS2(crc, buffer[i]);
+    }
+    buffer[8] = crc;
+    return 9;
+}
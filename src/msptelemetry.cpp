@@ -12,40 +12,218 @@
 #include <QFutureWatcher>
 #include <QFuture>
 
+#include <openhd/mavlink.h>
+
 #include "util.h"
 #include "constants.h"
 
 #include "openhd.h"
+#include "ingestreactor.h"
+#include "telemetrysubscriptions.h"
+
+
+/*
+ * Widgets subscribe to MAVLink messages, this is the MSP message that carries the same
+ * information for each of them.
+ */
+static const struct {
+    uint32_t message;
+    uint16_t command;
+} MSPSubscriptionMap[] = {
+    { MAVLINK_MSG_ID_ATTITUDE, MSPCommandAttitude },
+    { MAVLINK_MSG_ID_GPS_RAW_INT, MSPCommandRawGPS },
+    { MAVLINK_MSG_ID_GLOBAL_POSITION_INT, MSPCommandRawGPS },
+    { MAVLINK_MSG_ID_GLOBAL_POSITION_INT, MSPCommandAltitude },
+    { MAVLINK_MSG_ID_VFR_HUD, MSPCommandRawGPS },
+    { MAVLINK_MSG_ID_VFR_HUD, MSPCommandAltitude },
+    { MAVLINK_MSG_ID_SYS_STATUS, MSPCommandAnalog },
+    { MAVLINK_MSG_ID_BATTERY_STATUS, MSPCommandAnalog }
+};
 
-MSPTelemetry::MSPTelemetry(QObject *parent): QObject(parent) {
+static const MSPCommand MSPCommands[] = {
+    MSPCommandStatus,
+    MSPCommandRawGPS,
+    MSPCommandAttitude,
+    MSPCommandAltitude,
+    MSPCommandAnalog
+};
+
+
+MSPTelemetry::MSPTelemetry(quint16 port, QObject *parent): QObject(parent), m_port(port) {
     qDebug() << "MSPTelemetry::MSPTelemetry()";
 
-    mspSocket = new QUdpSocket(this);
-    mspSocket->bind(QHostAddress::Any, 14550);
-    connect(mspSocket, &QUdpSocket::readyRead, this, &MSPTelemetry::processMSPDatagrams);
+    QSettings settings;
+    m_uplink_port = settings.value("msp_uplink_port", 5003).toUInt();
+
+    m_uplink_socket = new QUdpSocket(this);
+
+    for (auto command : MSPCommands) {
+        MSPRequest request;
+        request.command = command;
+        m_requests.append(request);
+    }
+    m_clock.start();
+
+    m_request_timer = new QTimer(this);
+    connect(m_request_timer, &QTimer::timeout, this, &MSPTelemetry::sendRequests);
+
+    connect(TelemetrySubscriptions::instance(), &TelemetrySubscriptions::ratesChanged, this, &MSPTelemetry::updateRates);
+    updateRates();
+
+    OpenHD::instance()->registerTelemetryPublisher(&m_telemetry);
+    IngestReactor::instance()->addPort(m_port, this);
+}
+
+
+MSPTelemetry::~MSPTelemetry() {
+    IngestReactor::instance()->removePort(m_port);
+    OpenHD::instance()->unregisterTelemetryPublisher(&m_telemetry);
+}
+
+
+void MSPTelemetry::setGroundIP(QString address) {
+    m_ground_address = address;
 }
 
 
-void MSPTelemetry::processMSPDatagrams() {
-    QByteArray datagram;
+void MSPTelemetry::updateRates() {
+    QSettings settings;
+    auto max_rate = settings.value("msp_max_rate", 10.0).toDouble();
+
+    auto rates = TelemetrySubscriptions::instance()->rates();
 
-    while (mspSocket->hasPendingDatagrams()) {
-        datagram.resize(int(mspSocket->pendingDatagramSize()));
-        mspSocket->readDatagram(datagram.data(), datagram.size());
-        typedef QByteArray::Iterator Iterator;
+    qint64 shortest = 0;
+    for (auto &request : m_requests) {
+        // the arming state is always wanted
+        double rate = (request.command == MSPCommandStatus) ? 1.0 : 0.0;
+        for (auto &entry : MSPSubscriptionMap) {
+            if (entry.command == request.command) {
+                rate = qMax(rate, rates.value(entry.message, 0.0));
+            }
+        }
+        rate = qMin(rate, max_rate);
 
-        for (Iterator i = datagram.begin(); i != datagram.end(); i++) {            
-            /*if (res) {
-                  processMSPMessage(msg);
-              }*/
+        request.interval_ms = (rate > 0.0) ? qint64(1000.0 / rate) : 0;
+        if (request.interval_ms > 0 && (shortest == 0 || request.interval_ms < shortest)) {
+            shortest = request.interval_ms;
         }
     }
+
+    // wake up only as often as the fastest request needs
+    if (shortest == 0) {
+        m_request_timer->stop();
+    } else {
+        m_request_timer->start(int(shortest));
+    }
 }
 
-void MSPTelemetry::processMSPMessage() {
 
+void MSPTelemetry::sendRequests() {
+    uint8_t datagram[sizeof(MSPCommands) / sizeof(MSPCommands[0]) * MSPMaxRequestSize];
+    int length = 0;
+
+    auto now = m_clock.elapsed();
+    for (auto &request : m_requests) {
+        if (request.interval_ms == 0 || request.next_ms > now) {
+            continue;
+        }
+        length += mspEncodeRequest(datagram + length, request.command);
+        request.next_ms = now + request.interval_ms;
+    }
+
+    if (length > 0) {
+        m_uplink_socket->writeDatagram((const char*)datagram, length, QHostAddress(m_ground_address), m_uplink_port);
+    }
+}
+
+
+// called on the ingest thread
+void MSPTelemetry::ingestDatagram(const uint8_t* data, int size) {
+    for (int i = 0; i < size; i++) {
+        if (m_parser.push(data[i])) {
+            processMSPMessage(m_parser.command(), m_parser.payload());
+        }
+    }
+}
+
+
+void MSPTelemetry::ingestFinished() {
+    m_telemetry.publish();
 }
 
+
+void MSPTelemetry::processMSPMessage(uint16_t command, FrameReader payload) {
+    switch (command) {
+        case MSPCommandStatus: {
+            MSPStatus status;
+            if (!status.decode(payload)) {
+                break;
+            }
+            m_telemetry.set_armed(status.armed());
+            break;
+        }
+        case MSPCommandRawGPS: {
+            MSPRawGPS gps;
+            if (!gps.decode(payload)) {
+                break;
+            }
+            m_telemetry.set_satellites_visible(gps.satellites);
+            m_telemetry.set_lat((double)gps.lat / 10000000);
+            m_telemetry.set_lon((double)gps.lon / 10000000);
+            m_telemetry.set_alt_msl(gps.altitude);
+            m_telemetry.set_speed(gps.ground_speed * 0.036); // cm/s to km/h
+            if (gps.has_hdop) {
+                m_telemetry.set_gps_hdop(gps.hdop / 100.0);
+            }
+            m_telemetry.position_updated();
+            break;
+        }
+        case MSPCommandAttitude: {
+            MSPAttitude attitude;
+            if (!attitude.decode(payload)) {
+                break;
+            }
+            m_telemetry.set_roll(attitude.roll / 10.0);
+            m_telemetry.set_pitch(attitude.pitch / 10.0);
+            m_telemetry.set_hdg(attitude.yaw);
+            break;
+        }
+        case MSPCommandAltitude: {
+            MSPAltitude altitude;
+            if (!altitude.decode(payload)) {
+                break;
+            }
+            m_telemetry.set_alt_rel(altitude.altitude / 100.0);
+            m_telemetry.set_vsi(altitude.vario / 100.0f);
+            break;
+        }
+        case MSPCommandAnalog: {
+            MSPAnalog analog;
+            if (!analog.decode(payload)) {
+                break;
+            }
+            auto battery_voltage = analog.has_voltage ? analog.voltage / 100.0 : analog.vbat / 10.0;
+            m_telemetry.set_battery_voltage(battery_voltage);
+            m_telemetry.set_battery_current(analog.amperage / 100.0);
+            m_telemetry.set_flight_mah(analog.mah_drawn);
+            m_telemetry.set_rc_rssi(analog.rssi * 100 / 1023);
+
+            QSettings settings;
+            auto battery_cells = settings.value("battery_cells", QVariant(3)).toInt();
+            int battery_percent = lipo_battery_voltage_to_percent(battery_cells, battery_voltage);
+            m_telemetry.set_battery_percent(battery_percent);
+
+            // the battery gauge glyph and app mAh are derived from these on the GUI thread
+            m_telemetry.battery_updated();
+            break;
+        }
+        default: {
+            break;
+        }
+    }
+}
+
+
 void MSPTelemetry::set_last_heartbeat(QString last_heartbeat) {
     m_last_heartbeat = last_heartbeat;
     emit last_heartbeat_changed(m_last_heartbeat);
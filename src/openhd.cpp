@@ -3,6 +3,7 @@
 #include "mavlinktelemetry.h"
 #include "openhdtelemetry.h"
 #include "localmessage.h"
+#include "util.h"
 
 #include <GeographicLib/Geodesic.hpp>
 
@@ -36,12 +37,231 @@ OpenHD::OpenHD(QObject *parent): QObject(parent) {
 
     auto mavlink = MavlinkTelemetry::instance();
     connect(mavlink, &MavlinkTelemetry::last_heartbeat_changed, this, &OpenHD::set_last_telemetry_heartbeat);
+    registerTelemetryPublisher(mavlink->telemetryPublisher());
 
     auto openhd = OpenHDTelemetry::instance();
     connect(openhd, &OpenHDTelemetry::last_heartbeat_changed, this, &OpenHD::set_last_openhd_heartbeat);
 }
 
 
+void OpenHD::registerTelemetryPublisher(TelemetryPublisher* publisher) {
+    m_telemetry_sources.append({ publisher, 0, 0 });
+    publisher->setListener(this);
+}
+
+
+void OpenHD::unregisterTelemetryPublisher(TelemetryPublisher* publisher) {
+    for (int i = 0; i < m_telemetry_sources.size(); i++) {
+        if (m_telemetry_sources[i].publisher == publisher) {
+            publisher->setListener(nullptr);
+            m_telemetry_sources.removeAt(i);
+            return;
+        }
+    }
+}
+
+
+quint64 OpenHD::telemetrySyncNsecs() const {
+    return m_telemetry_sync_nsecs.load(std::memory_order_relaxed);
+}
+
+
+void OpenHD::telemetryPublished() {
+    if (!m_telemetry_pending.exchange(true, std::memory_order_acq_rel)) {
+        emit telemetry_published();
+    }
+}
+
+
+void OpenHD::syncTelemetry() {
+    QElapsedTimer elapsed;
+    elapsed.start();
+
+    // cleared first, so a snapshot published while this runs asks for another frame
+    m_telemetry_pending.store(false, std::memory_order_release);
+
+    for (auto &source : m_telemetry_sources) {
+        if (!source.publisher->update()) {
+            continue;
+        }
+        auto &state = source.publisher->snapshot();
+
+        applyTelemetry(state);
+
+        if (state.position_seq != source.position_seq) {
+            source.position_seq = state.position_seq;
+
+            findGcsPosition();
+            calculate_home_distance();
+            calculate_home_course();
+            updateFlightDistance();
+            updateLateralSpeed();
+            updateWind();
+        }
+
+        if (state.battery_seq != source.battery_seq) {
+            source.battery_seq = state.battery_seq;
+
+            updateAppMah();
+        }
+    }
+
+    m_telemetry_sync_nsecs.fetch_add(elapsed.nsecsElapsed(), std::memory_order_relaxed);
+}
+
+
+/*
+ * Only fields the source has actually provided are applied, and only when they differ from
+ * what the property already holds, so QML bindings are re-evaluated at most once per frame
+ * and only for values that changed.
+ */
+void OpenHD::applyTelemetry(const TelemetryState &state) {
+    auto has = [&state](uint64_t field) {
+        return (state.fields & field) != 0;
+    };
+
+    if (has(TelemetryFieldArmed) && state.armed != m_armed) {
+        set_armed(state.armed);
+    }
+    if (has(TelemetryFieldFlightMode)) {
+        auto flight_mode = QString::fromUtf8(state.flight_mode);
+        if (flight_mode != m_flight_mode) {
+            set_flight_mode(flight_mode);
+        }
+    }
+
+    if (has(TelemetryFieldBatteryVoltage) && state.battery_voltage != m_battery_voltage) {
+        set_battery_voltage(state.battery_voltage);
+    }
+    if (has(TelemetryFieldBatteryCurrent) && state.battery_current != m_battery_current) {
+        set_battery_current(state.battery_current);
+    }
+    if (has(TelemetryFieldBatteryPercent) && state.battery_percent != m_battery_percent) {
+        set_battery_percent(state.battery_percent);
+        set_battery_gauge(battery_gauge_glyph_from_percentage(state.battery_percent));
+    }
+
+    if (has(TelemetryFieldSatellitesVisible) && state.satellites_visible != m_satellites_visible) {
+        set_satellites_visible(state.satellites_visible);
+    }
+    if (has(TelemetryFieldGpsHdop) && state.gps_hdop != m_gps_hdop) {
+        set_gps_hdop(state.gps_hdop);
+    }
+    if (has(TelemetryFieldFcTemp) && state.fc_temp != m_fc_temp) {
+        set_fc_temp(state.fc_temp);
+    }
+
+    if (has(TelemetryFieldPitch) && state.pitch != m_pitch) {
+        set_pitch(state.pitch);
+    }
+    if (has(TelemetryFieldRoll) && state.roll != m_roll) {
+        set_roll(state.roll);
+    }
+
+    if (has(TelemetryFieldLat) && state.lat != m_lat) {
+        set_lat(state.lat);
+    }
+    if (has(TelemetryFieldLon) && state.lon != m_lon) {
+        set_lon(state.lon);
+    }
+    if (has(TelemetryFieldBootTime) && state.boot_time != m_boot_time) {
+        set_boot_time(state.boot_time);
+    }
+    if (has(TelemetryFieldAltRel) && state.alt_rel != m_alt_rel) {
+        set_alt_rel(state.alt_rel);
+    }
+    if (has(TelemetryFieldAltMsl) && state.alt_msl != m_alt_msl) {
+        set_alt_msl(state.alt_msl);
+    }
+    if (has(TelemetryFieldHdg) && state.hdg != m_hdg) {
+        set_hdg(state.hdg);
+    }
+    if (has(TelemetryFieldVx) && state.vx != m_vx) {
+        set_vx(state.vx);
+    }
+    if (has(TelemetryFieldVy) && state.vy != m_vy) {
+        set_vy(state.vy);
+    }
+    if (has(TelemetryFieldVz) && state.vz != m_vz) {
+        set_vz(state.vz);
+    }
+
+    if (has(TelemetryFieldRcRssi) && state.rc_rssi != m_rc_rssi) {
+        set_rc_rssi(state.rc_rssi);
+    }
+
+    if (has(TelemetryFieldControl)) {
+        if (state.control_pitch != m_control_pitch) {
+            set_control_pitch(state.control_pitch);
+        }
+        if (state.control_roll != m_control_roll) {
+            set_control_roll(state.control_roll);
+        }
+        if (state.control_throttle != m_control_throttle) {
+            set_control_throttle(state.control_throttle);
+        }
+        if (state.control_yaw != m_control_yaw) {
+            set_control_yaw(state.control_yaw);
+        }
+    }
+
+    if (has(TelemetryFieldRCChannels)) {
+        if (state.rc_channels[0] != mRCChannel1) setRCChannel1(state.rc_channels[0]);
+        if (state.rc_channels[1] != mRCChannel2) setRCChannel2(state.rc_channels[1]);
+        if (state.rc_channels[2] != mRCChannel3) setRCChannel3(state.rc_channels[2]);
+        if (state.rc_channels[3] != mRCChannel4) setRCChannel4(state.rc_channels[3]);
+        if (state.rc_channels[4] != mRCChannel5) setRCChannel5(state.rc_channels[4]);
+        if (state.rc_channels[5] != mRCChannel6) setRCChannel6(state.rc_channels[5]);
+        if (state.rc_channels[6] != mRCChannel7) setRCChannel7(state.rc_channels[6]);
+        if (state.rc_channels[7] != mRCChannel8) setRCChannel8(state.rc_channels[7]);
+    }
+
+    if (has(TelemetryFieldThrottle) && state.throttle != m_throttle) {
+        set_throttle(state.throttle);
+    }
+    if (has(TelemetryFieldAirspeed) && state.airspeed != m_airspeed) {
+        set_airspeed(state.airspeed);
+    }
+    if (has(TelemetryFieldSpeed) && state.speed != m_speed) {
+        set_speed(state.speed);
+    }
+    if (has(TelemetryFieldVsi) && state.vsi != m_vsi) {
+        set_vsi(state.vsi);
+    }
+
+    if (has(TelemetryFieldMavWind)) {
+        if (state.mav_wind_direction != m_mav_wind_direction) {
+            set_mav_wind_direction(state.mav_wind_direction);
+        }
+        if (state.mav_wind_speed != m_mav_wind_speed) {
+            set_mav_wind_speed(state.mav_wind_speed);
+        }
+    }
+
+    if (has(TelemetryFieldFlightMah) && state.flight_mah != m_flight_mah) {
+        set_flight_mah(state.flight_mah);
+    }
+
+    if (has(TelemetryFieldVibration)) {
+        if (state.vibration_x != m_vibration_x) set_vibration_x(state.vibration_x);
+        if (state.vibration_y != m_vibration_y) set_vibration_y(state.vibration_y);
+        if (state.vibration_z != m_vibration_z) set_vibration_z(state.vibration_z);
+        if (state.clipping_x != m_clipping_x) set_clipping_x(state.clipping_x);
+        if (state.clipping_y != m_clipping_y) set_clipping_y(state.clipping_y);
+        if (state.clipping_z != m_clipping_z) set_clipping_z(state.clipping_z);
+    }
+
+    if (has(TelemetryFieldHome)) {
+        if (state.homelat != m_homelat) {
+            set_homelat(state.homelat);
+        }
+        if (state.homelon != m_homelon) {
+            set_homelon(state.homelon);
+        }
+    }
+}
+
+
 QString OpenHD::get_gstreamer_version() {
 #if defined(ENABLE_GSTREAMER)
     guint major, minor, micro, nano;
@@ -67,35 +287,6 @@ QString OpenHD::get_qt_version() {
 }
 
 
-void OpenHD::setWifiAdapter0(uint32_t received_packet_cnt, int8_t current_signal_dbm, int8_t signal_good) {
-    emit wifiAdapter0Changed(received_packet_cnt, current_signal_dbm, signal_good);
-}
-
-
-void OpenHD::setWifiAdapter1(uint32_t received_packet_cnt, int8_t current_signal_dbm, int8_t signal_good) {
-    emit wifiAdapter1Changed(received_packet_cnt, current_signal_dbm, signal_good);
-}
-
-
-void OpenHD::setWifiAdapter2(uint32_t received_packet_cnt, int8_t current_signal_dbm, int8_t signal_good) {
-    emit wifiAdapter2Changed(received_packet_cnt, current_signal_dbm, signal_good);
-}
-
-
-void OpenHD::setWifiAdapter3(uint32_t received_packet_cnt, int8_t current_signal_dbm, int8_t signal_good) {
-    emit wifiAdapter3Changed(received_packet_cnt, current_signal_dbm, signal_good);
-}
-
-
-void OpenHD::setWifiAdapter4(uint32_t received_packet_cnt, int8_t current_signal_dbm, int8_t signal_good) {
-    emit wifiAdapter4Changed(received_packet_cnt, current_signal_dbm, signal_good);
-}
-
-
-void OpenHD::setWifiAdapter5(uint32_t received_packet_cnt, int8_t current_signal_dbm, int8_t signal_good) {
-    emit wifiAdapter5Changed(received_packet_cnt, current_signal_dbm, signal_good);
-}
-
 void OpenHD::telemetryMessage(QString message, int level) {
     emit messageReceived(message, level);
 #if defined(ENABLE_SPEECH)
@@ -1,6 +1,5 @@
-#include <QtNetwork>
-
 #include "openhdrc.h"
+#include "rcsender.h"
 #include "util.h"
 
 #if defined(ENABLE_GAMEPADS)
@@ -11,20 +10,14 @@
 #include <QJoysticks.h>
 #endif
 
-#define BUFLEN 21
-#define PORT 5565 // UDP port for OpenHD RC
-
 
 OpenHDRC::OpenHDRC(QObject *parent): QObject(parent) {
 
-    #if defined(__rasp_pi__)
-    groundAddress = "127.0.0.1";
-    #endif
-
-    rcSocket = new QUdpSocket(this);
-    rcSocket->bind(QHostAddress::Any);
+    QSettings settings;
+    set_enable_rc(settings.value("enable_rc", false).toBool());
 
-    connect(rcSocket, &QUdpSocket::readyRead, this, &OpenHDRC::processRCDatagrams);
+    m_mapper.load();
+    m_channels.mapped = m_mapper.mappedChannels();
 
 #if defined(ENABLE_SPEECH)
     m_speech = new QTextToSpeech(this);
@@ -43,72 +36,72 @@ OpenHDRC::OpenHDRC(QObject *parent): QObject(parent) {
     QJoysticks* jinstance = QJoysticks::getInstance();
     connect(jinstance, &QJoysticks::countChanged, this, &OpenHDRC::connectedJoysticksChanged);
     connect(jinstance, &QJoysticks::axisChanged, this, &OpenHDRC::axisChanged);
+    connect(jinstance, &QJoysticks::buttonChanged, this, &OpenHDRC::buttonChanged);
 #endif
-
-    QTimer *timer = new QTimer(this);
-    connect(timer, &QTimer::timeout, this, &OpenHDRC::channelTrigger);
-    timer->start(15); // about 60Hz
-
 }
 
 
 void OpenHDRC::setGroundIP(QString address) {
-    groundAddress = address;
+    RCSender::instance()->setGroundIP(address);
 }
 
 
-void OpenHDRC::channelTrigger() {
-    emit channelUpdate(m_rc1, m_rc2, m_rc3, m_rc4, m_rc5, m_rc6, m_rc7, m_rc8, m_rc9, m_rc10);
-#if defined(ENABLE_RC)
-    QSettings settings;
-    auto enable_rc = settings.value("enable_rc", false).toBool();
-
-    if (enable_rc) {
-        QByteArray rcChannels(BUFLEN, 0);
-
-        rcChannels[0] = m_rc1 & 0xFF;
-        rcChannels[1] = (m_rc1 >> 8) & 0xFF;
-
-        rcChannels[2] = m_rc2 & 0xFF;
-        rcChannels[3] = (m_rc2 >> 8) & 0xFF;
+void OpenHDRC::reloadMapping() {
+    m_mapper.load();
+    m_channels.mapped = m_mapper.mappedChannels();
+    RCSender::instance()->setChannels(m_channels);
+}
 
-        rcChannels[4] = m_rc3 & 0xFF;
-        rcChannels[5] = (m_rc3 >> 8) & 0xFF;
 
-        rcChannels[6] = m_rc4 & 0xFF;
-        rcChannels[7] = (m_rc4 >> 8) & 0xFF;
+void OpenHDRC::setChannel(int channel, uint16_t value) {
+    static void (OpenHDRC::*const setters[])(uint) = {
+        &OpenHDRC::set_rc1, &OpenHDRC::set_rc2, &OpenHDRC::set_rc3, &OpenHDRC::set_rc4, &OpenHDRC::set_rc5,
+        &OpenHDRC::set_rc6, &OpenHDRC::set_rc7, &OpenHDRC::set_rc8, &OpenHDRC::set_rc9, &OpenHDRC::set_rc10
+    };
 
-        rcChannels[8] = m_rc5 & 0xFF;
-        rcChannels[9] = (m_rc5 >> 8) & 0xFF;
+    if (channel < 10) {
+        (this->*setters[channel])(value);
+        return;
+    }
+    m_channels.channels[channel] = value;
+    publishChannels();
+}
 
-        rcChannels[10] = m_rc6 & 0xFF;
-        rcChannels[11] = (m_rc6 >> 8) & 0xFF;
 
-        rcChannels[12] = m_rc7 & 0xFF;
-        rcChannels[13] = (m_rc7 >> 8) & 0xFF;
+void OpenHDRC::mapAxis(int axis, double value) {
+    int channel;
+    uint16_t output;
+    if (m_mapper.mapAxis(axis, value, channel, output)) {
+        setChannel(channel, output);
+    }
+}
 
-        rcChannels[14] = m_rc8 & 0xFF;
-        rcChannels[15] = (m_rc8 >> 8) & 0xFF;
 
-        rcChannels[16] = seqno;
-        rcChannels[17] = 0;
+void OpenHDRC::mapButton(int button, bool pressed) {
+    int channel;
+    uint16_t output;
+    if (m_mapper.mapButton(button, pressed, channel, output)) {
+        setChannel(channel, output);
+    }
+}
 
-        // is16
-        rcChannels[18] = 0;
 
-        // these would be the buttons, disabled for now.
-        rcChannels[19] = 1;
-        rcChannels[20] = 1;
+void OpenHDRC::set_enable_rc(bool enable_rc) {
+    m_enable_rc = enable_rc;
+    RCSender::instance()->setEnabled(m_enable_rc);
+    emit enable_rc_changed(m_enable_rc);
+}
 
-        rcSocket->writeDatagram(rcChannels, rcChannels.length(), QHostAddress(groundAddress), PORT);
 
-        seqno++;
-    }
-#endif
-}
+void OpenHDRC::publishChannels() {
+    /*
+     * Called before the change signal is emitted so QML bindings reacting to it aren't counted
+     * as input latency, this is as close to the input event as we can get a timestamp.
+     */
+    m_channels.input_ns = RCSender::clockNs();
+    RCSender::instance()->setChannels(m_channels);
 
-void OpenHDRC::processRCDatagrams() {
-    // no return data necessary from UDP socket
+    emit channelUpdate(m_rc1, m_rc2, m_rc3, m_rc4, m_rc5, m_rc6, m_rc7, m_rc8, m_rc9, m_rc10);
 }
 
 #if defined(ENABLE_GAMEPADS)
@@ -202,106 +195,85 @@ void OpenHDRC::set_selectedJoystick(int selectedJoystick) {
 
 void OpenHDRC::set_rc1(uint rc1) {
     m_rc1 = rc1;
+    m_channels.channels[0] = m_rc1;
+    publishChannels();
     emit rc1_changed(m_rc1);
 }
 
 void OpenHDRC::set_rc2(uint rc2) {
     m_rc2 = rc2;
+    m_channels.channels[1] = m_rc2;
+    publishChannels();
     emit rc2_changed(m_rc2);
 }
 
 void OpenHDRC::set_rc3(uint rc3) {
     m_rc3 = rc3;
+    m_channels.channels[2] = m_rc3;
+    publishChannels();
     emit rc3_changed(m_rc3);
 }
 
 void OpenHDRC::set_rc4(uint rc4) {
     m_rc4 = rc4;
+    m_channels.channels[3] = m_rc4;
+    publishChannels();
     emit rc4_changed(m_rc4);
 }
 
 
 void OpenHDRC::set_rc5(uint rc5) {
     m_rc5 = rc5;
+    m_channels.channels[4] = m_rc5;
+    publishChannels();
     emit rc5_changed(m_rc5);
 }
 
 void OpenHDRC::set_rc6(uint rc6) {
     m_rc6 = rc6;
+    m_channels.channels[5] = m_rc6;
+    publishChannels();
     emit rc6_changed(m_rc6);
 }
 
 void OpenHDRC::set_rc7(uint rc7) {
     m_rc7 = rc7;
+    m_channels.channels[6] = m_rc7;
+    publishChannels();
     emit rc7_changed(m_rc7);
 }
 
 void OpenHDRC::set_rc8(uint rc8) {
     m_rc8 = rc8;
+    m_channels.channels[7] = m_rc8;
+    publishChannels();
     emit rc8_changed(m_rc8);
 }
 
 void OpenHDRC::set_rc9(uint rc9) {
     m_rc9 = rc9;
+    m_channels.channels[8] = m_rc9;
+    publishChannels();
     emit rc9_changed(m_rc9);
 }
 
 void OpenHDRC::set_rc10(uint rc10) {
     m_rc10 = rc10;
+    m_channels.channels[9] = m_rc10;
+    publishChannels();
     emit rc10_changed(m_rc10);
 }
 
 void OpenHDRC::axisChanged(const int js, const int axis, const qreal value) {
     Q_UNUSED(js)
-    Q_UNUSED(axis)
-
-    qDebug() << "OpenHDRC::axisChanged()";
-    switch (axis) {
-        case 0:
-        set_rc1(map(value, -1, 1, 1000, 2000));
-        break;
-
-        case 1:
-        set_rc2(map(value, -1, 1, 1000, 2000));
-        break;
-
-        case 2:
-        set_rc3(map(value, -1, 1, 1000, 2000));
-        break;
-
-        case 3:
-        set_rc4(map(value, -1, 1, 1000, 2000));
-        break;
 
-        case 4:
-        set_rc5(map(value, -1, 1, 1000, 2000));
-        break;
-
-        case 5:
-        set_rc6(map(value, -1, 1, 1000, 2000));
-        break;
-
-        case 6:
-        set_rc7(map(value, -1, 1, 1000, 2000));
-        break;
-
-        case 7:
-        set_rc8(map(value, -1, 1, 1000, 2000));
-        break;
-
-        case 8:
-        set_rc9(map(value, -1, 1, 1000, 2000));
-        break;
-
-        case 9:
-        set_rc10(map(value, -1, 1, 1000, 2000));
-        break;
+    mapAxis(axis, value);
+}
 
-        default:
-        break;
-    }
+void OpenHDRC::buttonChanged(const int js, const int button, const bool pressed) {
+    Q_UNUSED(js)
 
-    qDebug() << "Axis " << axis << ": " << value;
+    mapButton(button, pressed);
 }
 
 void OpenHDRC::connectedChanged(bool value) {
@@ -319,93 +291,93 @@ void OpenHDRC::connectedChanged(bool value) {
 #endif
 }
 
-/* RC channel slots arranged in channel order */
+/* gamepad inputs, numbered as in rcmapper.h and sent to whichever channel they're mapped to */
 
 void OpenHDRC::axisLeftXChanged(double value) {
-    set_rc4(map(value, -1, 1, 1000, 2000));
+    mapAxis(RCGamepadAxisLeftX, value);
 }
 
 void OpenHDRC::axisLeftYChanged(double value) {
-    set_rc3(map(value, -1, 1, 1000, 2000));
+    mapAxis(RCGamepadAxisLeftY, value);
 }
 
 void OpenHDRC::axisRightYChanged(double value) {
-    set_rc2(map(value, -1, 1, 1000, 2000));
+    mapAxis(RCGamepadAxisRightY, value);
 }
 
 void OpenHDRC::axisRightXChanged(double value) {
-    set_rc1(map(value, -1, 1, 1000, 2000));
+    mapAxis(RCGamepadAxisRightX, value);
 }
 
 void OpenHDRC::buttonAChanged(bool value) {
-    Q_UNUSED(value)
+    mapButton(RCGamepadButtonA, value);
 }
 
 void OpenHDRC::buttonBChanged(bool value) {
-    Q_UNUSED(value)
+    mapButton(RCGamepadButtonB, value);
 }
 
 void OpenHDRC::buttonXChanged(bool value) {
-    Q_UNUSED(value)
+    mapButton(RCGamepadButtonX, value);
 }
 
 void OpenHDRC::buttonYChanged(bool value) {
-    Q_UNUSED(value)
+    mapButton(RCGamepadButtonY, value);
 }
 
 void OpenHDRC::buttonL1Changed(bool value) {
-    Q_UNUSED(value)
+    mapButton(RCGamepadButtonL1, value);
 }
 
 void OpenHDRC::buttonR1Changed(bool value) {
-    Q_UNUSED(value)
+    mapButton(RCGamepadButtonR1, value);
 }
 
+// the triggers are analog, 0 released to 1 fully pressed
 void OpenHDRC::buttonL2Changed(double value) {
-    Q_UNUSED(value)
+    mapAxis(RCGamepadAxisL2, value * 2.0 - 1.0);
 }
 
 void OpenHDRC::buttonR2Changed(double value) {
-    Q_UNUSED(value)
+    mapAxis(RCGamepadAxisR2, value * 2.0 - 1.0);
 }
 
 void OpenHDRC::buttonSelectChanged(bool value) {
-    Q_UNUSED(value)
+    mapButton(RCGamepadButtonSelect, value);
 }
 
 void OpenHDRC::buttonStartChanged(bool value) {
-    Q_UNUSED(value)
+    mapButton(RCGamepadButtonStart, value);
 }
 
 void OpenHDRC::buttonL3Changed(bool value) {
-    Q_UNUSED(value)
+    mapButton(RCGamepadButtonL3, value);
 }
 
 void OpenHDRC::buttonR3Changed(bool value) {
-    Q_UNUSED(value)
+    mapButton(RCGamepadButtonR3, value);
 }
 
 void OpenHDRC::buttonUpChanged(bool value) {
-    Q_UNUSED(value)
+    mapButton(RCGamepadButtonUp, value);
 }
 
 void OpenHDRC::buttonDownChanged(bool value) {
-    Q_UNUSED(value)
+    mapButton(RCGamepadButtonDown, value);
 }
 
 void OpenHDRC::buttonLeftChanged(bool value) {
-    Q_UNUSED(value)
+    mapButton(RCGamepadButtonLeft, value);
 }
 
 void OpenHDRC::buttonRightChanged(bool value) {
-    Q_UNUSED(value)
+    mapButton(RCGamepadButtonRight, value);
 }
 
 void OpenHDRC::buttonCenterChanged(bool value) {
-    Q_UNUSED(value)
+    mapButton(RCGamepadButtonCenter, value);
 }
 
 void OpenHDRC::buttonGuideChanged(bool value) {
-    Q_UNUSED(value)
-
+    mapButton(RCGamepadButtonGuide, value);
 }
@@ -4,9 +4,17 @@
 #include <QThread>
 #include <QtConcurrent>
 
+#include "constants.h"
 #include "localmessage.h"
+#include "settingssender.h"
 
-#define SETTINGS_PORT 1011
+
+/*
+ * How long a fetch waits after the last settings datagram before giving up on ConfigEnd, and
+ * how long a delta request waits for any answer before assuming the ground image predates it.
+ */
+static const qint64 LoadInactivityTimeout = 3000;
+static const qint64 DeltaRequestTimeout = 1000;
 
 OpenHDSettings::OpenHDSettings(QObject *parent) : QObject(parent) {
     qDebug() << "OpenHDSettings::OpenHDSettings()";
@@ -21,7 +29,34 @@ OpenHDSettings::OpenHDSettings(QObject *parent) : QObject(parent) {
     connect(settingSocket, SIGNAL(readyRead()), this, SLOT(processDatagrams()));
 
     connect(&loadTimer, &QTimer::timeout, this, &OpenHDSettings::checkSettingsLoadTimeout);
-    connect(&saveTimer, &QTimer::timeout, this, &OpenHDSettings::checkSettingsSaveTimeout);
+
+    if (loadSettingsCache()) {
+        qDebug() << "OpenHDSettings: loaded" << m_allSettings.size() << "settings from cache";
+    }
+
+    auto sender = SettingsSender::instance();
+    connect(sender, &SettingsSender::saveFinished, this, [this] {
+        // the ground has these now, so the snapshot (and its hash) moves along with it
+        for (auto it = m_savingSettings.constBegin(); it != m_savingSettings.constEnd(); ++it) {
+            auto value = it.value().toString().toUtf8();
+            m_allSettings.insert(it.key(), value);
+            if (m_fetching) {
+                m_incomingSettings.insert(it.key(), value);
+            }
+        }
+        m_savingSettings.clear();
+        m_settingsHash = settingsHash(m_allSettings);
+        saveSettingsCache();
+        emit allSettingsChanged();
+
+        set_saving(false);
+        emit savingSettingsFinished();
+    }, Qt::QueuedConnection);
+    connect(sender, &SettingsSender::saveFailed, this, [this](qint64 failCount) {
+        m_savingSettings.clear();
+        set_saving(false);
+        emit savingSettingsFailed(failCount);
+    }, Qt::QueuedConnection);
 }
 
 void OpenHDSettings::set_ground_available(bool ground_available) {
@@ -41,29 +76,94 @@ void OpenHDSettings::set_saving(bool saving) {
 
 
 void OpenHDSettings::checkSettingsLoadTimeout() {
-    qint64 current = QDateTime::currentSecsSinceEpoch();
-    //fallback in case the ground pi never sends back "ConfigEnd=ConfigEnd"
-    if (current - loadStart > 30) {
-        loadTimer.stop();
-        set_loading(false);
-        emit allSettingsChanged();
+    qint64 current = QDateTime::currentMSecsSinceEpoch();
+
+    // ground images without snapshot support never answer the delta request at all
+    if (m_deltaRequest && !m_deltaAnswered && current - loadStart > DeltaRequestTimeout) {
+        qDebug() << "OpenHDSettings: no answer to delta request, fetching all settings";
+        requestAllSettings();
+        return;
+    }
+
+    // fallback in case the ground pi stops sending before "ConfigEnd=ConfigEnd"
+    if (current - lastReceived > LoadInactivityTimeout) {
+        qDebug() << "OpenHDSettings: settings fetch timed out";
+        finishLoading(false);
     }
 }
 
 
-void OpenHDSettings::checkSettingsSaveTimeout() {
-    qint64 current = QDateTime::currentSecsSinceEpoch();
-    /*fallback in case the ground pi never sends back "SavedGround" for all
-       the settings we saved*/
-    if (current - saveStart > 30) {
-        saveTimer.stop();
-        set_saving(false);
-        if (settingsCount <= 0) {
-            emit savingSettingsFinished();
-        } else {
-            emit savingSettingsFailed(settingsCount);
-        }
+QByteArray OpenHDSettings::settingsHash(const QVariantMap &settings) {
+    /*
+     * The ground computes the same hash over its own settings file: SHA-1 over "key=value\n"
+     * for every setting, sorted by key (QVariantMap iterates in key order), as lowercase hex.
+     */
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    for (auto it = settings.constBegin(); it != settings.constEnd(); ++it) {
+        hash.addData(it.key().toUtf8());
+        hash.addData("=", 1);
+        hash.addData(it.value().toByteArray());
+        hash.addData("\n", 1);
+    }
+    return hash.result().toHex();
+}
+
+
+QString OpenHDSettings::settingsCachePath() {
+    auto directory = QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation) + "/settings";
+    QDir().mkpath(directory);
+    return directory + "/ground.json";
+}
+
+
+bool OpenHDSettings::loadSettingsCache() {
+    QFile file(settingsCachePath());
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    auto document = QJsonDocument::fromJson(file.readAll());
+    if (!document.isObject()) {
+        return false;
+    }
+    auto cached = document.object().value("settings").toObject();
+    if (cached.isEmpty()) {
+        return false;
+    }
+
+    QVariantMap settings;
+    for (auto it = cached.constBegin(); it != cached.constEnd(); ++it) {
+        // settings arrive as raw bytes, keep them that way so the cache looks the same to QML
+        settings.insert(it.key(), it.value().toString().toUtf8());
+    }
+
+    // a cache that doesn't match its own hash has been damaged somehow, the ground can't use it either
+    auto hash = settingsHash(settings);
+    if (hash != document.object().value("hash").toString().toLatin1()) {
+        qDebug() << "OpenHDSettings: settings cache hash mismatch, ignoring it";
+        return false;
+    }
+
+    m_allSettings = settings;
+    m_settingsHash = hash;
+    return true;
+}
+
+
+void OpenHDSettings::saveSettingsCache() {
+    QJsonObject settings;
+    for (auto it = m_allSettings.constBegin(); it != m_allSettings.constEnd(); ++it) {
+        settings.insert(it.key(), QString::fromUtf8(it.value().toByteArray()));
+    }
+    QJsonObject cache;
+    cache.insert("hash", QString::fromLatin1(m_settingsHash));
+    cache.insert("settings", settings);
+
+    QSaveFile file(settingsCachePath());
+    if (!file.open(QIODevice::WriteOnly)) {
+        return;
     }
+    file.write(QJsonDocument(cache).toJson(QJsonDocument::Compact));
+    file.commit();
 }
 
 
@@ -99,11 +199,6 @@ void OpenHDSettings::shutdown() {
 
 void OpenHDSettings::saveSettings(QVariantMap remoteSettings) {
     qDebug() << "OpenHDSettings::saveSettings()";
-
-    /* run the real network calls in the background. needs some minor changes to avoid threading related
-       errors
-      QFuture<void> future = QtConcurrent::run(this, &OpenHDSettings::_saveSettings, remoteSettings);
-      */
     _saveSettings(remoteSettings);
 }
 
@@ -117,25 +212,15 @@ void OpenHDSettings::_saveSettings(QVariantMap remoteSettings) {
         return;
     }
     set_saving(true);
+    m_savingSettings = remoteSettings;
 
     emit savingSettingsStart();
 
-    settingsCount = remoteSettings.count();
-    saveStart = QDateTime::currentSecsSinceEpoch();
-    saveTimer.start(1000);
-
-    QMapIterator<QString, QVariant> i(remoteSettings);
-    while (i.hasNext()) {
-        i.next();
-
-        QByteArray r = QByteArray("RequestChangeSettings");
-        r.append(i.key());
-        r.append('=');
-        r.append(i.value().toString());
-        settingSocket->writeDatagram(r, QHostAddress(groundAddress), SETTINGS_PORT);
-
-        QThread::msleep(30);
-    }
+    // the sender packs, acknowledges and retransmits on its own thread, see SettingsSender
+    auto sender = SettingsSender::instance();
+    QMetaObject::invokeMethod(sender, [sender, remoteSettings] {
+        sender->save(remoteSettings);
+    }, Qt::QueuedConnection);
 }
 
 QVariantMap OpenHDSettings::getAllSettings() {
@@ -143,22 +228,79 @@ QVariantMap OpenHDSettings::getAllSettings() {
 }
 
 void OpenHDSettings::fetchSettings() {
-    if (m_loading || m_saving) {
+    if (m_fetching || m_saving) {
         return;
     }
-    set_loading(true);
 
     qDebug() << "OpenHDSettings::fetchSettings()";
 
-    loadStart = QDateTime::currentSecsSinceEpoch();
-    loadTimer.start(1000);
+    if (m_allSettings.isEmpty()) {
+        set_loading(true);
+        requestAllSettings();
+        return;
+    }
+
+    /*
+     * The panel opens straight from the snapshot, the ground then either confirms it's current
+     * or sends just the settings that differ, and the panel is only refreshed if any did.
+     */
+    emit allSettingsChanged();
+
+    m_fetching = true;
+    m_deltaRequest = true;
+    m_deltaAnswered = false;
+    m_incomingSettings = m_allSettings;
+
+    loadStart = QDateTime::currentMSecsSinceEpoch();
+    lastReceived = loadStart;
+    loadTimer.start(250);
+
+    QByteArray r = QByteArray("RequestSettingsSince") + m_settingsHash;
+    settingSocket->writeDatagram(r, QHostAddress(groundAddress), SETTINGS_PORT);
+}
+
+
+void OpenHDSettings::requestAllSettings() {
+    m_fetching = true;
+    m_deltaRequest = false;
+    m_incomingSettings.clear();
+
+    loadStart = QDateTime::currentMSecsSinceEpoch();
+    lastReceived = loadStart;
+    loadTimer.start(250);
 
     QByteArray r = QByteArray("RequestAllSettings");
-    QNetworkDatagram d(r);
     settingSocket->writeDatagram(r, QHostAddress(groundAddress), SETTINGS_PORT);
 }
 
 
+void OpenHDSettings::finishLoading(bool complete) {
+    loadTimer.stop();
+    m_fetching = false;
+
+    bool changed = false;
+    if (complete) {
+        auto hash = settingsHash(m_incomingSettings);
+        changed = hash != m_settingsHash;
+        m_allSettings = m_incomingSettings;
+        m_settingsHash = hash;
+        if (changed) {
+            saveSettingsCache();
+        }
+    } else if (!m_deltaRequest) {
+        // an incomplete full fetch is still better than nothing, but it's never cached
+        changed = true;
+        m_allSettings = m_incomingSettings;
+    }
+    m_incomingSettings.clear();
+
+    if (changed || m_loading) {
+        emit allSettingsChanged();
+    }
+    set_loading(false);
+}
+
+
 void OpenHDSettings::processDatagrams() {
     QByteArray datagram;
 
@@ -179,17 +321,29 @@ void OpenHDSettings::processDatagrams() {
             set_ground_available(true);
         }
 
+        if (m_fetching) {
+            lastReceived = QDateTime::currentMSecsSinceEpoch();
+        }
+
         if (datagram == "ConfigRespConfigEnd=ConfigEnd") {
-            loadTimer.stop();
-            emit allSettingsChanged();
-            set_loading(false);
-        } else if (datagram.contains("SavedGround")) {
-            settingsCount -= 1;
-            if (settingsCount <= 0) {
-                set_saving(false);
-                saveTimer.stop();
-                emit savingSettingsFinished();
+            if (m_fetching) {
+                finishLoading(true);
             }
+        } else if (datagram.startsWith("ConfigUnchanged")) {
+            // the snapshot already matches the ground, nothing else follows
+            if (m_fetching && m_deltaRequest) {
+                m_deltaAnswered = true;
+                finishLoading(true);
+            }
+        } else if (datagram.startsWith("ConfigRemoved")) {
+            m_deltaAnswered = true;
+            m_incomingSettings.remove(QString(datagram.mid(13)));
+        } else if (datagram.contains("SavedGround")) {
+            // older ground images answer single settings here rather than to the sender
+            auto sender = SettingsSender::instance();
+            QMetaObject::invokeMethod(sender, [sender] {
+                sender->legacySaved();
+            }, Qt::QueuedConnection);
         } else {
             auto set = datagram.split('=');
             auto key = set.first();         
@@ -217,7 +371,8 @@ void OpenHDSettings::processDatagrams() {
             // ... leaving just the value remaining in the datagram
             auto val = datagram;
 
-            m_allSettings.insert(QString(key), QVariant(val));
+            m_deltaAnswered = true;
+            m_incomingSettings.insert(QString(key), QVariant(val));
         }
     }
 }
@@ -6,12 +6,15 @@
 #include <QFutureWatcher>
 #include <QFuture>
 
-#include "wifibroadcast.h"
+#include "wifibroadcaststatus.h"
+#include "wifiadaptermodel.h"
+#include "linkanalytics.h"
 
 #include "constants.h"
 
 #include "openhdpi.h"
 #include "openhd.h"
+#include "flightrecorder.h"
 
 
 static OpenHDTelemetry* _instance = nullptr;
@@ -29,14 +32,13 @@ OpenHDTelemetry::OpenHDTelemetry(QObject *parent): QObject(parent) {
 
 void OpenHDTelemetry::onStarted() {
     qDebug() << "OpenHDTelemetry::onStarted()";
-    telemetrySocket = new QUdpSocket(this);
 
 #if defined(__rasp_pi__)
-    telemetrySocket->bind(QHostAddress::Any, 5155);
+    m_port = 5155;
 #else
-    telemetrySocket->bind(QHostAddress::Any, 5154);
+    m_port = 5154;
 #endif
-    connect(telemetrySocket, &QUdpSocket::readyRead, this, &OpenHDTelemetry::processDatagrams);
+    IngestReactor::instance()->addPort(m_port, this);
 
     timer = new QTimer(this);
     connect(timer, &QTimer::timeout, this, &OpenHDTelemetry::stateLoop);
@@ -44,18 +46,46 @@ void OpenHDTelemetry::onStarted() {
 }
 
 
-void OpenHDTelemetry::processDatagrams() {
-    QByteArray datagram;
-    wifibroadcast_rx_status_forward_t telemetry;
+// called on the ingest thread, only the decoded status is handed over to the GUI thread
+void OpenHDTelemetry::ingestDatagram(const uint8_t* data, int size) {
+    if (m_replaying) {
+        return;
+    }
+
+    FlightRecorder::instance()->record(FlightRecordTypeWifibroadcastStatus, m_port, (const char*)data, size);
+
+    WifibroadcastStatus telemetry;
+    if (telemetry.decode((const char*)data, size)) {
+        m_ingested.append(telemetry);
+    }
+}
 
-    while (telemetrySocket->hasPendingDatagrams()) {
-        datagram.resize(int(telemetrySocket->pendingDatagramSize()));
-        telemetrySocket->readDatagram(datagram.data(), datagram.size());
 
-        if (datagram.size() == 113) {
-            memcpy(&telemetry, datagram.constData(), datagram.size());
+void OpenHDTelemetry::ingestFinished() {
+    if (m_ingested.isEmpty()) {
+        return;
+    }
+    auto batch = m_ingested;
+    m_ingested.clear();
+
+    QMetaObject::invokeMethod(this, [this, batch] {
+        for (auto &telemetry : batch) {
             processOpenHDTelemetry(telemetry);
         }
+    }, Qt::QueuedConnection);
+}
+
+
+void OpenHDTelemetry::setReplaying(bool replaying) {
+    m_replaying = replaying;
+}
+
+
+void OpenHDTelemetry::replayDatagram(QByteArray datagram) {
+    WifibroadcastStatus telemetry;
+
+    if (telemetry.decode(datagram.constData(), datagram.size())) {
+        processOpenHDTelemetry(telemetry);
     }
 }
 
@@ -68,41 +98,11 @@ void OpenHDTelemetry::stateLoop() {
 
 
 
-void OpenHDTelemetry::processOpenHDTelemetry(wifibroadcast_rx_status_forward_t telemetry) {
-    /* find adapter with best signal. right now just uses the signal level, but should
-       also store the index in a property so it can be highlighted in the adapter list popup */
-    int current_best = -127;
-
-    for (uint wifi_adapter = 0; wifi_adapter < telemetry.wifi_adapter_cnt; wifi_adapter++) {
-        wifi_adapter_rx_status_forward_t adapter = telemetry.adapter[wifi_adapter];
-
-        switch (wifi_adapter) {
-            case 0: {
-                OpenHD::instance()->setWifiAdapter0(adapter.received_packet_cnt, adapter.current_signal_dbm, adapter.signal_good);
-                break;
-            }
-            case 1: {
-                OpenHD::instance()->setWifiAdapter1(adapter.received_packet_cnt, adapter.current_signal_dbm, adapter.signal_good);
-                break;
-            }
-            case 2: {
-                OpenHD::instance()->setWifiAdapter2(adapter.received_packet_cnt, adapter.current_signal_dbm, adapter.signal_good);
-                break;
-            }
-            case 3: {
-                OpenHD::instance()->setWifiAdapter3(adapter.received_packet_cnt, adapter.current_signal_dbm, adapter.signal_good);
-                break;
-            }
-            case 4: {
-                OpenHD::instance()->setWifiAdapter4(adapter.received_packet_cnt, adapter.current_signal_dbm, adapter.signal_good);
-                break;
-            }
-            case 5: {
-                OpenHD::instance()->setWifiAdapter5(adapter.received_packet_cnt, adapter.current_signal_dbm, adapter.signal_good);
-                break;
-            }
-        }
+void OpenHDTelemetry::processOpenHDTelemetry(const WifibroadcastStatus &telemetry) {
+    WifiAdapterModel::instance()->updateAdapters(telemetry.adapters);
 
+    int current_best = -127;
+    for (auto &adapter : telemetry.adapters) {
         if (adapter.current_signal_dbm > current_best) {
             current_best = adapter.current_signal_dbm;
         }
@@ -113,15 +113,16 @@ void OpenHDTelemetry::processOpenHDTelemetry(wifibroadcast_rx_status_forward_t t
 
     OpenHD::instance()->set_downlink_rssi(current_best);
 
-    auto damaged_percent = (double)telemetry.damaged_block_cnt / (double)telemetry.received_packet_cnt * 100.0;
-    auto damaged_percent_visible = std::isnan(damaged_percent) ? 0.0 : damaged_percent;
+    auto analytics = LinkAnalytics::instance();
+    analytics->addSample(telemetry, current_best);
+
+    /* the counters are totals since the ground station started, so the percentages are taken
+       over the last 10 seconds rather than against everything it has ever received */
     OpenHD::instance()->set_damaged_block_cnt(telemetry.damaged_block_cnt);
-    OpenHD::instance()->set_damaged_block_percent((int)damaged_percent_visible);
+    OpenHD::instance()->set_damaged_block_percent((int)analytics->percent(LinkMetricDamagedBlocks, LinkMetricReceivedPackets, 10000));
 
-    auto lost_percent = (double)telemetry.lost_packet_cnt / (double)telemetry.received_packet_cnt * 100.0;
-    auto lost_percent_visible = std::isnan(lost_percent) ? 0.0 : lost_percent;
     OpenHD::instance()->set_lost_packet_cnt(telemetry.lost_packet_cnt);
-    OpenHD::instance()->set_lost_packet_percent((int)lost_percent_visible);
+    OpenHD::instance()->set_lost_packet_percent((int)analytics->percent(LinkMetricLostPackets, LinkMetricReceivedPackets, 10000));
 
     OpenHD::instance()->set_skipped_packet_cnt(telemetry.skipped_packet_cnt);
     OpenHD::instance()->set_injection_fail_cnt(telemetry.injection_fail_cnt);
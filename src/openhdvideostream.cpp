@@ -10,6 +10,7 @@
 #include <gst/gst.h>
 
 #include "localmessage.h"
+#include "logger.h"
 
 #include "openhd.h"
 
@@ -316,29 +317,36 @@ GST_PLUGIN_STATIC_DECLARE(rtspclientsink);
 G_END_DECLS
 
 
-static void printf_extension_log_func(GstDebugCategory * category,
-                                       GstDebugLevel level,
-                                       const gchar * file,
-                                       const gchar * function,
-                                       gint line,
-                                       GObject * object,
-                                       GstDebugMessage * message,
-                                       gpointer unused) {
-      const gchar *dbg_msg;
-
-      dbg_msg = gst_debug_message_get (message);
-
+/*
+ * Hands GStreamer's messages to the async logger, so the streaming threads never wait on a
+ * write to the SD card.
+ */
+static void logger_log_func(GstDebugCategory * category,
+                            GstDebugLevel level,
+                            const gchar * file,
+                            const gchar * function,
+                            gint line,
+                            GObject * object,
+                            GstDebugMessage * message,
+                            gpointer unused) {
+      Q_UNUSED(file)
+      Q_UNUSED(function)
+      Q_UNUSED(line)
+      Q_UNUSED(object)
+      Q_UNUSED(unused)
+
+      const gchar *dbg_msg = gst_debug_message_get (message);
       if (dbg_msg == nullptr) {
           return;
       }
 
-      qDebug() << dbg_msg;
-
-      /* quick hack to still get stuff to show if GST_DEBUG is set */
-      if (g_getenv ("GST_DEBUG")) {
-        gst_debug_log_default (category, level, file, function, line, object,
-            message, unused);
+      QtMsgType type = QtDebugMsg;
+      if (level == GST_LEVEL_ERROR) {
+          type = QtCriticalMsg;
+      } else if (level == GST_LEVEL_WARNING) {
+          type = QtWarningMsg;
       }
+      Logger::instance()->text(type, 0, "GStreamer %s: %s", gst_debug_category_get_name(category), dbg_msg);
  }
 
 
@@ -396,19 +404,25 @@ OpenHDVideoStream::OpenHDVideoStream(int &argc, char *argv[], QObject * parent):
 #endif
 
 
-    char debuglevel[] = "*:3";
     #if defined(__android__)
     char logpath[] = "/sdcard";
     #else
     char logpath[] = "/tmp";
     #endif
 
-    qputenv("GST_DEBUG", debuglevel);
-
-    QString file = QString("%1/%2").arg(logpath).arg("gstreamer-log.txt");
+    /*
+     * GStreamer stays quiet unless asked. A GST_DEBUG already in the environment is left to
+     * GStreamer's own log function, otherwise the gst_debug_level setting (0 off, or a level as
+     * in GST_DEBUG) sends its messages through the logger instead of a file in /tmp.
+     */
+    QSettings settings;
+    auto gst_debug_level = settings.value("gst_debug_level", 0).toInt();
+    bool log_to_logger = gst_debug_level > 0 && !qEnvironmentVariableIsSet("GST_DEBUG");
+    if (log_to_logger) {
+        qputenv("GST_DEBUG", QByteArray("*:") + QByteArray::number(gst_debug_level));
+    }
 
     qputenv("GST_DEBUG_NO_COLOR", "1");
-    qputenv("GST_DEBUG_FILE", file.toStdString().c_str());
     qputenv("GST_DEBUG_DUMP_DOT_DIR", logpath);
 
     #if defined(__ios__)
@@ -446,8 +460,10 @@ OpenHDVideoStream::OpenHDVideoStream(int &argc, char *argv[], QObject * parent):
     #endif
 
 
-    //gst_debug_remove_log_function(gst_debug_log_default);
-    //gst_debug_add_log_function(printf_extension_log_func, nullptr, nullptr);
+    if (log_to_logger) {
+        gst_debug_remove_log_function(gst_debug_log_default);
+        gst_debug_add_log_function(logger_log_func, nullptr, nullptr);
+    }
 #if defined(ENABLE_MAIN_VIDEO) || defined(ENABLE_PIP)
 #ifndef __desktoplinux__
 #ifndef __rasp_pi__
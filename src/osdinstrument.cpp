@@ -0,0 +1,219 @@
+#include "osdinstrument.h"
+
+#include <QFontMetricsF>
+#include <QImage>
+#include <QPainter>
+#include <QQuickWindow>
+#include <QSGFlatColorMaterial>
+#include <QSGSimpleTextureNode>
+#include <QSGTexture>
+#include <QtMath>
+
+#include <string.h>
+
+
+OSDInstrumentNode::OSDInstrumentNode() {
+    shapes = nullptr;
+    labels = new QSGNode();
+    appendChildNode(labels);
+}
+
+
+OSDInstrumentNode::~OSDInstrumentNode() {
+    for (auto &label : label_cache) {
+        delete label.texture;
+    }
+}
+
+
+OSDInstrument::OSDInstrument(QQuickItem *parent): QQuickItem(parent) {
+    setFlag(QQuickItem::ItemHasContents, true);
+}
+
+
+void OSDInstrument::set_color(QColor color) {
+    if (m_color == color) {
+        return;
+    }
+    m_color = color;
+    emit color_changed(m_color);
+    update();
+}
+
+
+void OSDInstrument::geometryChanged(const QRectF &new_geometry, const QRectF &old_geometry) {
+    QQuickItem::geometryChanged(new_geometry, old_geometry);
+    if (new_geometry.size() != old_geometry.size()) {
+        update();
+    }
+}
+
+
+QFont OSDInstrument::ladderFont() {
+    QFont font;
+    font.setStyleHint(QFont::SansSerif);
+    font.setBold(true);
+    font.setPixelSize(11);
+    return font;
+}
+
+
+OSDInstrumentNode* OSDInstrument::instrumentNode(QSGNode* old) {
+    auto node = static_cast<OSDInstrumentNode*>(old);
+    if (node == nullptr) {
+        node = new OSDInstrumentNode();
+        initInstrumentNode(node);
+    }
+    return node;
+}
+
+
+void OSDInstrument::initInstrumentNode(OSDInstrumentNode* node) {
+    node->shapes = createShapeNode(m_color);
+    // shapes first so labels draw on top of them
+    node->prependChildNode(node->shapes);
+}
+
+
+QSGGeometryNode* OSDInstrument::createShapeNode(const QColor &color) {
+    auto node = new QSGGeometryNode();
+
+    auto geometry = new QSGGeometry(QSGGeometry::defaultAttributes_Point2D(), 0);
+    geometry->setDrawingMode(QSGGeometry::DrawTriangles);
+    geometry->setVertexDataPattern(QSGGeometry::DynamicPattern);
+    node->setGeometry(geometry);
+    node->setFlag(QSGNode::OwnsGeometry);
+
+    auto material = new QSGFlatColorMaterial();
+    material->setColor(color);
+    node->setMaterial(material);
+    node->setFlag(QSGNode::OwnsMaterial);
+
+    return node;
+}
+
+
+void OSDInstrument::setShapeColor(QSGGeometryNode* node, const QColor &color) {
+    auto material = static_cast<QSGFlatColorMaterial*>(node->material());
+    if (material->color() != color) {
+        material->setColor(color);
+        node->markDirty(QSGNode::DirtyMaterial);
+    }
+}
+
+
+void OSDInstrument::commitShapes(QSGGeometryNode* node, const QVector<QSGGeometry::Point2D> &vertices) {
+    auto geometry = node->geometry();
+    if (geometry->vertexCount() != vertices.size()) {
+        geometry->allocate(vertices.size());
+    }
+    if (!vertices.isEmpty()) {
+        memcpy(geometry->vertexDataAsPoint2D(), vertices.constData(), vertices.size() * sizeof(QSGGeometry::Point2D));
+    }
+    node->markDirty(QSGNode::DirtyGeometry);
+}
+
+
+void OSDInstrument::appendRect(QVector<QSGGeometry::Point2D> &vertices, float x, float y, float width, float height) {
+    appendQuad(vertices, QPointF(x, y), QPointF(x + width, y), QPointF(x + width, y + height), QPointF(x, y + height));
+}
+
+
+void OSDInstrument::appendQuad(QVector<QSGGeometry::Point2D> &vertices, QPointF a, QPointF b, QPointF c, QPointF d) {
+    QSGGeometry::Point2D point;
+
+    point.set(a.x(), a.y()); vertices.append(point);
+    point.set(b.x(), b.y()); vertices.append(point);
+    point.set(c.x(), c.y()); vertices.append(point);
+
+    point.set(a.x(), a.y()); vertices.append(point);
+    point.set(c.x(), c.y()); vertices.append(point);
+    point.set(d.x(), d.y()); vertices.append(point);
+}
+
+
+void OSDInstrument::beginLabels(OSDInstrumentNode* node) {
+    node->labels_used = 0;
+
+    /*
+     * An altitude ladder on a long climb keeps meeting new numbers, start the cache over before
+     * it grows without bound. The label quads go with it so none is left pointing at a deleted
+     * texture, they're all placed again before the frame is drawn.
+     */
+    if (node->label_cache.size() > OSDInstrumentNode::MaxCachedLabels) {
+        endLabels(node);
+
+        for (auto &label : node->label_cache) {
+            delete label.texture;
+        }
+        node->label_cache.clear();
+    }
+}
+
+
+void OSDInstrument::addLabel(OSDInstrumentNode* node, const QString &text, const QFont &font, const QColor &color,
+                             qreal x, qreal baseline, Qt::Alignment alignment) {
+    if (text.isEmpty() || window() == nullptr) {
+        return;
+    }
+
+    auto key = text + QChar(0) + font.key() + QChar(0) + color.name(QColor::HexArgb);
+    auto cached = node->label_cache.find(key);
+
+    if (cached == node->label_cache.end()) {
+        QFontMetricsF metrics(font);
+        QSizeF size(qCeil(metrics.horizontalAdvance(text)) + 2, qCeil(metrics.height()) + 2);
+        auto dpr = window()->effectiveDevicePixelRatio();
+
+        QImage image((size * dpr).toSize(), QImage::Format_ARGB32_Premultiplied);
+        image.setDevicePixelRatio(dpr);
+        image.fill(Qt::transparent);
+
+        QPainter painter(&image);
+        painter.setRenderHint(QPainter::TextAntialiasing);
+        painter.setFont(font);
+        painter.setPen(color);
+        painter.drawText(QPointF(1, 1 + metrics.ascent()), text);
+        painter.end();
+
+        OSDInstrumentNode::Label label;
+        label.texture = window()->createTextureFromImage(image);
+        label.size = size;
+        label.ascent = 1 + metrics.ascent();
+        cached = node->label_cache.insert(key, label);
+    }
+
+    QSGSimpleTextureNode* quad;
+    if (node->labels_used < node->labels->childCount()) {
+        quad = static_cast<QSGSimpleTextureNode*>(node->labels->childAtIndex(node->labels_used));
+    } else {
+        quad = new QSGSimpleTextureNode();
+        quad->setFiltering(QSGTexture::Linear);
+        node->labels->appendChildNode(quad);
+    }
+    node->labels_used++;
+
+    auto &label = cached.value();
+    qreal left = x - 1;
+    if (alignment & Qt::AlignHCenter) {
+        left = x - label.size.width() / 2;
+    } else if (alignment & Qt::AlignRight) {
+        left = x - label.size.width() + 1;
+    }
+    qreal top = baseline - label.ascent;
+    if (alignment & Qt::AlignVCenter) {
+        top = baseline - label.size.height() / 2;
+    }
+
+    quad->setTexture(label.texture);
+    quad->setRect(QRectF(QPointF(left, top), label.size));
+}
+
+
+void OSDInstrument::endLabels(OSDInstrumentNode* node) {
+    while (node->labels->childCount() > node->labels_used) {
+        auto last = node->labels->lastChild();
+        node->labels->removeChildNode(last);
+        delete last;
+    }
+}
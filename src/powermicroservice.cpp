@@ -8,6 +8,7 @@
 
 #include <openhd/mavlink.h>
 
+#include "logger.h"
 #include "util.h"
 #include "constants.h"
 
@@ -110,7 +111,8 @@ void PowerMicroservice::onProcessMavlinkMessage(mavlink_message_t msg) {
             break;
         }
         default: {
-            printf("PowerMicroservice received unmatched message with ID %d, sequence: %d from component %d of system %d\n", msg.msgid, msg.seq, msg.compid, msg.sysid);
+            LOG_EVENT(LogEventUnmatchedMavlink, msg.msgid, msg.sysid << 8 | msg.compid);
+            LOG_RATE_LIMITED(1000, QtDebugMsg, "PowerMicroservice received unmatched message with ID %d, sequence: %d from component %d of system %d", msg.msgid, msg.seq, msg.compid, msg.sysid);
             break;
         }
     }
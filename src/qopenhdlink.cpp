@@ -14,6 +14,9 @@
 
 #define LINK_PORT 6000
 
+// how often a peer that hasn't answered is asked again whether it understands the binary encoding
+static const qint64 HelloInterval = 5000;
+
 
 QOpenHDLink::QOpenHDLink(QObject *parent):
     QObject(parent)
@@ -25,12 +28,55 @@ QOpenHDLink::QOpenHDLink(QObject *parent):
     linkSocket->bind(LINK_PORT);
 
     connect(linkSocket, &QUdpSocket::readyRead, this, &QOpenHDLink::readyRead);
+
+    m_flushTimer.setSingleShot(true);
+    m_flushTimer.setInterval(0);
+    connect(&m_flushTimer, &QTimer::timeout, this, &QOpenHDLink::flush);
 #endif
 }
 
 
 void QOpenHDLink::setGroundIP(QString address) {
+    if (address == groundAddress) {
+        return;
+    }
     groundAddress = address;
+
+    // a different ground may be running an older version, find out again
+    m_binary = false;
+    m_helloSent = 0;
+#if defined(ENABLE_LINK)
+#if !defined(__rasp_pi__)
+    sendHello();
+#endif
+#endif
+}
+
+
+void QOpenHDLink::sendHello() {
+#if defined(ENABLE_LINK)
+    nlohmann::json j = {
+      {"cmd", "hello"},
+      {"version", LinkProtocolVersion}
+    };
+
+    std::string serialized_string = j.dump();
+    auto buf = QByteArray(serialized_string.c_str());
+    linkSocket->writeDatagram(buf, QHostAddress(groundAddress), LINK_PORT);
+
+    m_helloSent = QDateTime::currentMSecsSinceEpoch();
+#endif
+}
+
+
+void QOpenHDLink::sendRecords(const QVector<LinkRecord> &records, const QHostAddress &address) {
+#if defined(ENABLE_LINK)
+    QVector<QByteArray> messages;
+    linkEncode(records, messages);
+    for (auto &message : messages) {
+        linkSocket->writeDatagram(message, address, LINK_PORT);
+    }
+#endif
 }
 
 
@@ -41,8 +87,9 @@ void QOpenHDLink::readyRead() {
     while (linkSocket->hasPendingDatagrams()) {
         datagram.resize(int(linkSocket->pendingDatagramSize()));
 
-        linkSocket->readDatagram(datagram.data(), datagram.size());
-        processCommand(datagram);
+        QHostAddress sender;
+        linkSocket->readDatagram(datagram.data(), datagram.size(), &sender);
+        processCommand(datagram, sender);
     }
 #endif
 }
@@ -51,19 +98,24 @@ void QOpenHDLink::readyRead() {
 void QOpenHDLink::setWidgetLocation(QString widgetName, int alignment, int xOffset, int yOffset, bool hCenter, bool vCenter) {
 #if defined(ENABLE_LINK)
 #if !defined(__rasp_pi__)
-    nlohmann::json j = {
-      {"cmd", "setWidgetLocation"},
-      {"widgetName", widgetName.toStdString()},
-      {"alignment", alignment},
-      {"xOffset", xOffset},
-      {"yOffset", yOffset},
-      {"hCenter", hCenter},
-      {"vCenter", vCenter}
-    };
+    LinkRecord record;
+    record.type = LinkRecordWidgetLocation;
+    record.widget_name = widgetName;
+    record.alignment = alignment;
+    record.x_offset = xOffset;
+    record.y_offset = yOffset;
+    record.h_center = hCenter;
+    record.v_center = vCenter;
 
-    std::string serialized_string = j.dump();
-    auto buf = QByteArray(serialized_string.c_str());
-    linkSocket->writeDatagram(buf, QHostAddress(groundAddress), LINK_PORT);
+    // only where the widget ended up matters, not every position it passed through
+    for (auto &pending : m_pending) {
+        if (pending.type == LinkRecordWidgetLocation && pending.widget_name == widgetName) {
+            pending = record;
+            return;
+        }
+    }
+    m_pending.append(record);
+    m_flushTimer.start();
 #endif
 #endif
 }
@@ -71,26 +123,92 @@ void QOpenHDLink::setWidgetLocation(QString widgetName, int alignment, int xOffs
 void QOpenHDLink::setWidgetEnabled(QString widgetName, bool enabled) {
 #if defined(ENABLE_LINK)
 #if !defined(__rasp_pi__)
-    nlohmann::json j = {
-      {"cmd", "setWidgetEnabled"},
-      {"widgetName", widgetName.toStdString()},
-      {"enabled", enabled}
-    };
+    LinkRecord record;
+    record.type = LinkRecordWidgetEnabled;
+    record.widget_name = widgetName;
+    record.enabled = enabled;
 
-    std::string serialized_string = j.dump();
-    auto buf = QByteArray(serialized_string.c_str());
-    linkSocket->writeDatagram(buf, QHostAddress(groundAddress), LINK_PORT);
+    for (auto &pending : m_pending) {
+        if (pending.type == LinkRecordWidgetEnabled && pending.widget_name == widgetName) {
+            pending = record;
+            return;
+        }
+    }
+    m_pending.append(record);
+    m_flushTimer.start();
 #endif
 #endif
 }
 
-void QOpenHDLink::processCommand(QByteArray buffer) {
+
+void QOpenHDLink::flush() {
+#if defined(ENABLE_LINK)
+    if (m_pending.isEmpty()) {
+        return;
+    }
+
+    if (m_binary) {
+        sendRecords(m_pending, QHostAddress(groundAddress));
+        m_pending.clear();
+        return;
+    }
+
+    if (QDateTime::currentMSecsSinceEpoch() - m_helloSent > HelloInterval) {
+        sendHello();
+    }
+
+    // JSON fallback for ground images that predate the binary encoding
+    for (auto &record : m_pending) {
+        nlohmann::json j;
+        if (record.type == LinkRecordWidgetLocation) {
+            j = {
+              {"cmd", "setWidgetLocation"},
+              {"widgetName", record.widget_name.toStdString()},
+              {"alignment", record.alignment},
+              {"xOffset", record.x_offset},
+              {"yOffset", record.y_offset},
+              {"hCenter", record.h_center},
+              {"vCenter", record.v_center}
+            };
+        } else {
+            j = {
+              {"cmd", "setWidgetEnabled"},
+              {"widgetName", record.widget_name.toStdString()},
+              {"enabled", record.enabled}
+            };
+        }
+
+        std::string serialized_string = j.dump();
+        auto buf = QByteArray(serialized_string.c_str());
+        linkSocket->writeDatagram(buf, QHostAddress(groundAddress), LINK_PORT);
+    }
+    m_pending.clear();
+#endif
+}
+
+void QOpenHDLink::processCommand(QByteArray buffer, const QHostAddress &sender) {
 #if defined(ENABLE_LINK)
+    if (linkIsBinary(buffer)) {
+        QVector<LinkRecord> records;
+        if (!linkDecode(buffer, records)) {
+            qDebug() << "QOpenHDLink: dropped malformed or newer binary message";
+        }
+        processRecords(records, sender);
+        return;
+    }
+
     try {
         auto commandData = nlohmann::json::parse(buffer);
         if (commandData.count("cmd") == 1) {
             std::string cmd = commandData["cmd"];
 
+            if (cmd == "hello") {
+                // answered in binary, which is what tells the other end we understand it
+                LinkRecord hello;
+                hello.type = LinkRecordHello;
+                sendRecords({ hello }, sender);
+            }
+
             if (cmd == "setWidgetLocation") {
                 processSetWidgetLocation(commandData);
             }
@@ -108,6 +226,31 @@ void QOpenHDLink::processCommand(QByteArray buffer) {
 }
 
 
+void QOpenHDLink::processRecords(const QVector<LinkRecord> &records, const QHostAddress &sender) {
+#if defined(ENABLE_LINK)
+    for (auto &record : records) {
+        switch (record.type) {
+            case LinkRecordHello: {
+                if (!m_binary && sender.isEqual(QHostAddress(groundAddress), QHostAddress::TolerantConversion)) {
+                    qDebug() << "QOpenHDLink: ground understands binary link version" << record.version;
+                    m_binary = true;
+                }
+                break;
+            }
+            case LinkRecordWidgetLocation: {
+                emit widgetLocation(record.widget_name, record.alignment, record.x_offset, record.y_offset, record.h_center, record.v_center);
+                break;
+            }
+            case LinkRecordWidgetEnabled: {
+                emit widgetEnabled(record.widget_name, record.enabled);
+                break;
+            }
+        }
+    }
+#endif
+}
+
+
 void QOpenHDLink::processSetWidgetLocation(nlohmann::json commandData) {
 #if defined(ENABLE_LINK)
     std::string widgetName = commandData["widgetName"];
@@ -0,0 +1,87 @@
+#include "rcmapper.h"
+
+#include <QSettings>
+#include <QtGlobal>
+
+#include <math.h>
+
+
+RCMapper::RCMapper() {
+    for (int i = 0; i < MaxAxes; i++) {
+        m_axis_channel[i] = -1;
+    }
+    for (int i = 0; i < MaxButtons; i++) {
+        m_button_channel[i] = -1;
+    }
+    for (int c = 0; c < RCChannelCount; c++) {
+        for (int i = 0; i < TableSize; i++) {
+            m_table[c][i] = 1500;
+        }
+    }
+}
+
+
+void RCMapper::load() {
+    QSettings settings;
+
+    m_mapped = 0;
+
+    for (int i = 0; i < MaxAxes; i++) {
+        int fallback = i < 10 ? i + 1 : 0;
+        int channel = settings.value(QString("rc_axis%1_channel").arg(i), fallback).toInt();
+        m_axis_channel[i] = (channel >= 1 && channel <= RCChannelCount) ? channel - 1 : -1;
+        if (m_axis_channel[i] >= 0) {
+            m_mapped |= 1u << m_axis_channel[i];
+        }
+    }
+
+    for (int i = 0; i < MaxButtons; i++) {
+        int channel = settings.value(QString("rc_button%1_channel").arg(i), 0).toInt();
+        m_button_channel[i] = (channel >= 1 && channel <= RCChannelCount) ? channel - 1 : -1;
+        if (m_button_channel[i] >= 0) {
+            m_mapped |= 1u << m_button_channel[i];
+        }
+    }
+
+    for (int c = 0; c < RCChannelCount; c++) {
+        auto prefix = QString("rc_channel%1_").arg(c + 1);
+        double expo = qBound(0.0, settings.value(prefix + "expo", 0).toDouble() / 100.0, 1.0);
+        double rate = settings.value(prefix + "rate", 100).toDouble() / 100.0;
+        double trim = settings.value(prefix + "trim", 0).toDouble();
+        bool reverse = settings.value(prefix + "reverse", false).toBool();
+
+        for (int i = 0; i < TableSize; i++) {
+            double x = (2.0 * i) / (TableSize - 1) - 1.0;
+            if (reverse) {
+                x = -x;
+            }
+            double y = ((1.0 - expo) * x + expo * x * x * x) * rate;
+            double output = 1500.0 + 500.0 * y + trim;
+            m_table[c][i] = (uint16_t)qBound(1000.0, round(output), 2000.0);
+        }
+    }
+}
+
+
+bool RCMapper::mapAxis(int axis, double value, int &channel, uint16_t &output) const {
+    if (axis < 0 || axis >= MaxAxes || m_axis_channel[axis] < 0) {
+        return false;
+    }
+    channel = m_axis_channel[axis];
+
+    int index = int((value + 1.0) * ((TableSize - 1) / 2) + 0.5);
+    output = m_table[channel][qBound(0, index, TableSize - 1)];
+    return true;
+}
+
+
+bool RCMapper::mapButton(int button, bool pressed, int &channel, uint16_t &output) const {
+    if (button < 0 || button >= MaxButtons || m_button_channel[button] < 0) {
+        return false;
+    }
+    channel = m_button_channel[button];
+
+    // the ends of the table, so a button gets the channel's trim and reverse as well
+    output = m_table[channel][pressed ? TableSize - 1 : 0];
+    return true;
+}
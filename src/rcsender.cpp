@@ -0,0 +1,428 @@
+#include "rcsender.h"
+
+#include <QtNetwork>
+
+#include <chrono>
+#include <string.h>
+
+#if defined(RC_SENDER_REALTIME)
+#include <sys/socket.h>
+#include <sys/eventfd.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+#include <unistd.h>
+#include <errno.h>
+#endif
+
+#include "mavlinktelemetry.h"
+
+#define BUFLEN 21
+#define BUFLEN16 37
+#define PORT 5565 // UDP port for OpenHD RC
+
+
+const qint64 JitterHistogram::BucketLimits[JitterHistogram::BucketCount] = {
+    50, 100, 250, 500, 1000, 2000, 5000, 10000, 20000, -1
+};
+
+
+void JitterHistogram::record(qint64 lateness_us) {
+    if (lateness_us < 0) {
+        lateness_us = 0;
+    }
+
+    int bucket = BucketCount - 1;
+    for (int i = 0; i < BucketCount - 1; i++) {
+        if (lateness_us <= BucketLimits[i]) {
+            bucket = i;
+            break;
+        }
+    }
+    m_counts[bucket].fetch_add(1, std::memory_order_relaxed);
+    m_total.fetch_add(1, std::memory_order_relaxed);
+
+    // only the sender thread records, so a plain compare is enough
+    if (lateness_us > m_max.load(std::memory_order_relaxed)) {
+        m_max.store(lateness_us, std::memory_order_relaxed);
+    }
+}
+
+
+qint64 JitterHistogram::percentile(double fraction) const {
+    auto total = this->total();
+    if (total == 0) {
+        return 0;
+    }
+
+    quint64 target = quint64(fraction * total);
+    quint64 cumulative = 0;
+    for (int i = 0; i < BucketCount - 1; i++) {
+        cumulative += count(i);
+        if (cumulative > target) {
+            return BucketLimits[i];
+        }
+    }
+    return max();
+}
+
+
+static RCSender* _instance = nullptr;
+
+RCSender* RCSender::instance() {
+    if (_instance == nullptr) {
+        _instance = new RCSender();
+    }
+    return _instance;
+}
+
+
+RCSender::RCSender(QObject *parent): QObject(parent) {
+    qDebug() << "RCSender::RCSender()";
+
+    #if defined(__rasp_pi__)
+    setGroundIP("127.0.0.1");
+    #endif
+
+#if defined(RC_SENDER_REALTIME)
+    // created up front so inputs arriving before the thread starts have somewhere to go
+    m_wakeup = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+#endif
+}
+
+
+RCSender::~RCSender() {
+#if defined(RC_SENDER_REALTIME)
+    if (m_socket >= 0) {
+        close(m_socket);
+    }
+    if (m_wakeup >= 0) {
+        close(m_wakeup);
+    }
+#endif
+}
+
+
+qint64 RCSender::clockNs() {
+#if defined(RC_SENDER_REALTIME)
+    timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return qint64(now.tv_sec) * 1000000000 + now.tv_nsec;
+#else
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+
+void RCSender::setChannels(const RCChannels &channels) {
+    m_channels.back() = channels;
+    m_channels.publish();
+
+    if (!m_send_on_change.load(std::memory_order_relaxed)) {
+        return;
+    }
+#if defined(RC_SENDER_REALTIME)
+    uint64_t value = 1;
+    if (write(m_wakeup, &value, sizeof(value)) < 0) {
+        // the counter is already non-zero, the sender will wake up anyway
+    }
+#else
+    QMetaObject::invokeMethod(this, [this] {
+        process(clockNs(), false);
+    }, Qt::QueuedConnection);
+#endif
+}
+
+
+void RCSender::setEnabled(bool enabled) {
+    m_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+
+void RCSender::setGroundIP(QString address) {
+    bool ok = false;
+    auto ip4 = QHostAddress(address).toIPv4Address(&ok);
+    if (ok) {
+        m_ground_address.store(ip4, std::memory_order_relaxed);
+    }
+}
+
+
+QVariantList RCSender::histogramBuckets(const JitterHistogram &histogram) {
+    QVariantList buckets;
+    for (int i = 0; i < JitterHistogram::BucketCount; i++) {
+        QVariantMap bucket;
+        bucket.insert("limit_us", JitterHistogram::BucketLimits[i]);
+        bucket.insert("count", histogram.count(i));
+        buckets.append(bucket);
+    }
+    return buckets;
+}
+
+
+QVariantList RCSender::jitterHistogram() const {
+    return histogramBuckets(m_jitter);
+}
+
+
+QVariantList RCSender::latencyHistogram() const {
+    return histogramBuckets(m_latency);
+}
+
+
+void RCSender::onStarted() {
+    qDebug() << "RCSender::onStarted()";
+
+#if defined(ENABLE_RC)
+    m_running = true;
+
+    QSettings settings;
+    m_deadband = settings.value("rc_deadband", 5).toInt();
+    m_keepalive_ns = settings.value("rc_keepalive_ms", 100).toLongLong() * 1000000;
+    m_send_on_change = settings.value("rc_send_on_change", false).toBool();
+    m_16_channels = settings.value("rc_channel_count", 8).toInt() == 16;
+    if (settings.value("rc_output", "wifibroadcast").toString() == "mavlink") {
+        m_output = RCOutputMavlink;
+    }
+
+    m_tokens_ns = clockNs();
+
+#if defined(RC_SENDER_REALTIME)
+    m_socket = socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+    if (m_socket < 0) {
+        qDebug() << "RCSender: failed to create socket" << strerror(errno);
+        return;
+    }
+
+    auto priority = settings.value("rc_realtime_priority", 0).toInt();
+    if (priority > 0) {
+        sched_param param;
+        memset(&param, 0, sizeof(param));
+        param.sched_priority = qBound(sched_get_priority_min(SCHED_FIFO), priority, sched_get_priority_max(SCHED_FIFO));
+        int result = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+        if (result != 0) {
+            qDebug() << "RCSender: couldn't switch to SCHED_FIFO" << strerror(result);
+        }
+    }
+
+    run();
+#else
+    m_socket = new QUdpSocket(this);
+
+    m_next_ns = clockNs() + IntervalNs;
+
+    m_timer = new QTimer(this);
+    m_timer->setTimerType(Qt::PreciseTimer);
+    connect(m_timer, &QTimer::timeout, this, &RCSender::tick);
+    m_timer->start(IntervalNs / 1000000);
+#endif
+#endif
+}
+
+
+void RCSender::onStopped() {
+    // the realtime loop notices within one interval and quits the thread itself
+    m_running = false;
+#if defined(RC_SENDER_REALTIME)
+    uint64_t value = 1;
+    if (write(m_wakeup, &value, sizeof(value)) < 0) {
+        qDebug() << "RCSender: failed to wake the sender thread";
+    }
+#else
+    QMetaObject::invokeMethod(this, [this] {
+        thread()->quit();
+    }, Qt::QueuedConnection);
+#endif
+}
+
+
+#if defined(RC_SENDER_REALTIME)
+static qint64 timespecNs(const timespec &t) {
+    return qint64(t.tv_sec) * 1000000000 + t.tv_nsec;
+}
+
+
+static timespec nsTimespec(qint64 ns) {
+    timespec t;
+    t.tv_sec = ns / 1000000000;
+    t.tv_nsec = ns % 1000000000;
+    return t;
+}
+
+
+void RCSender::run() {
+    pollfd wakeup;
+    memset(&wakeup, 0, sizeof(wakeup));
+    wakeup.fd = m_wakeup;
+    wakeup.events = POLLIN;
+
+    auto next_ns = clockNs() + IntervalNs;
+
+    while (m_running) {
+        if (m_send_on_change) {
+            // ppoll() only takes a relative timeout, it's worked out as late as possible
+            auto remaining = next_ns - clockNs();
+            if (remaining > 0) {
+                auto timeout = nsTimespec(remaining);
+                if (ppoll(&wakeup, 1, &timeout, nullptr) > 0) {
+                    uint64_t value;
+                    if (read(m_wakeup, &value, sizeof(value)) < 0) {
+                        // nothing to do, it only exists to interrupt ppoll()
+                    }
+                }
+            }
+        } else {
+            auto next = nsTimespec(next_ns);
+            while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &next, nullptr) == EINTR) {}
+        }
+
+        auto now = clockNs();
+        bool slot = now >= next_ns;
+        if (slot) {
+            auto lateness = now - next_ns;
+            m_jitter.record(lateness / 1000);
+
+            next_ns += IntervalNs;
+            // after a stall (suspend, debugger) start a new schedule rather than bursting to catch up
+            if (lateness > IntervalNs) {
+                next_ns = now + IntervalNs;
+            }
+        }
+
+        process(now, slot);
+    }
+
+    thread()->quit();
+}
+#else
+void RCSender::tick() {
+    auto now = clockNs();
+    auto lateness = now - m_next_ns;
+    m_jitter.record(lateness / 1000);
+
+    m_next_ns += IntervalNs;
+    if (lateness > IntervalNs) {
+        m_next_ns = now + IntervalNs;
+    }
+
+    process(now, true);
+}
+#endif
+
+
+void RCSender::process(qint64 now_ns, bool slot) {
+    // always picked up, so a packet after re-enabling never carries stale channels
+    bool updated = m_channels.update();
+
+    if (!m_send_on_change) {
+        if (slot) {
+            send();
+        }
+        return;
+    }
+
+    m_tokens = qMin<double>(BurstPackets, m_tokens + double(now_ns - m_tokens_ns) / IntervalNs);
+    m_tokens_ns = now_ns;
+
+    if (updated && exceedsDeadband(m_channels.front())) {
+        m_pending = true;
+    }
+    bool keepalive = now_ns - m_last_send_ns >= m_keepalive_ns;
+
+    if ((m_pending || keepalive) && m_tokens >= 1.0) {
+        m_tokens -= 1.0;
+        m_pending = false;
+        m_last_send_ns = now_ns;
+        send();
+    }
+}
+
+
+bool RCSender::exceedsDeadband(const RCChannels &channels) const {
+    for (int i = 0; i < RCChannelCount; i++) {
+        if (qAbs(int(channels.channels[i]) - int(m_last_sent.channels[i])) > m_deadband) {
+            return true;
+        }
+    }
+    return false;
+}
+
+
+int RCSender::encodeFrame(uint8_t* packet, const RCChannels &channels) {
+    int count = m_16_channels ? 16 : 8;
+    int length = m_16_channels ? BUFLEN16 : BUFLEN;
+    memset(packet, 0, length);
+
+    for (int i = 0; i < count; i++) {
+        packet[i * 2] = channels.channels[i] & 0xFF;
+        packet[i * 2 + 1] = (channels.channels[i] >> 8) & 0xFF;
+    }
+
+    int offset = count * 2;
+    packet[offset] = m_seqno;
+    packet[offset + 1] = 0;
+
+    // is16
+    packet[offset + 2] = m_16_channels ? 1 : 0;
+
+    // these would be the buttons, disabled for now.
+    packet[offset + 3] = 1;
+    packet[offset + 4] = 1;
+
+    return length;
+}
+
+
+void RCSender::send() {
+    if (!m_enabled.load(std::memory_order_relaxed)) {
+        return;
+    }
+
+    auto &channels = m_channels.front();
+
+    if (m_output == RCOutputMavlink) {
+        // the MAVLink socket belongs to the telemetry thread, the message is packed and sent there
+        auto mavlink = MavlinkTelemetry::instance();
+        auto copy = channels;
+        int count = m_16_channels ? 16 : 8;
+        QMetaObject::invokeMethod(mavlink, [mavlink, copy, count] {
+            mavlink->sendRCOverride(copy.channels, count, copy.mapped);
+        }, Qt::QueuedConnection);
+    } else {
+        auto address = m_ground_address.load(std::memory_order_relaxed);
+        if (address == 0) {
+            return;
+        }
+
+        uint8_t packet[BUFLEN16];
+        auto length = encodeFrame(packet, channels);
+
+#if defined(RC_SENDER_REALTIME)
+        sockaddr_in destination;
+        memset(&destination, 0, sizeof(destination));
+        destination.sin_family = AF_INET;
+        destination.sin_addr.s_addr = htonl(address);
+        destination.sin_port = htons(PORT);
+
+        if (sendto(m_socket, packet, length, 0, (sockaddr*)&destination, sizeof(destination)) < 0) {
+            return;
+        }
+#else
+        if (m_socket->writeDatagram((const char*)packet, length, QHostAddress(address), PORT) < 0) {
+            return;
+        }
+#endif
+    }
+
+    // an input is only measured by the first packet that carried it
+    if (channels.input_ns != 0 && channels.input_ns != m_measured_input_ns) {
+        m_latency.record((clockNs() - channels.input_ns) / 1000);
+        m_measured_input_ns = channels.input_ns;
+    }
+    m_last_sent = channels;
+
+    m_seqno++;
+    m_packets.fetch_add(1, std::memory_order_relaxed);
+}
@@ -0,0 +1,248 @@
+#include "settingssender.h"
+
+#include <QtNetwork>
+
+#include "constants.h"
+
+
+static SettingsSender* _instance = nullptr;
+
+SettingsSender* SettingsSender::instance() {
+    if (_instance == nullptr) {
+        _instance = new SettingsSender();
+    }
+    return _instance;
+}
+
+
+SettingsSender::SettingsSender(QObject *parent): QObject(parent) {
+    qDebug() << "SettingsSender::SettingsSender()";
+
+    #if defined(__rasp_pi__)
+    m_ground_address = "127.0.0.1";
+    #endif
+}
+
+
+void SettingsSender::onStarted() {
+    qDebug() << "SettingsSender::onStarted()";
+
+    m_clock.start();
+
+    // batch acknowledgements come back to whichever port the batch was sent from
+    m_socket = new QUdpSocket(this);
+    m_socket->bind(QHostAddress::Any, 0);
+    connect(m_socket, &QUdpSocket::readyRead, this, &SettingsSender::processDatagrams);
+
+    m_retry_timer = new QTimer(this);
+    connect(m_retry_timer, &QTimer::timeout, this, &SettingsSender::checkBatches);
+
+    m_legacy_timer = new QTimer(this);
+    connect(m_legacy_timer, &QTimer::timeout, this, &SettingsSender::sendNextLegacy);
+}
+
+
+void SettingsSender::setGroundIP(QString address) {
+    if (address != m_ground_address) {
+        // a different ground station may run a different image
+        m_protocol = SettingsProtocolUnknown;
+    }
+    m_ground_address = address;
+}
+
+
+void SettingsSender::save(QVariantMap settings) {
+    // OpenHDSettings never starts a save while another one is running
+    if (m_active) {
+        return;
+    }
+    m_active = true;
+    m_settings = settings;
+    m_failed = 0;
+
+    if (m_protocol == SettingsProtocolLegacy && (m_reprobe || m_clock.elapsed() - m_legacy_since >= ReprobeInterval)) {
+        qDebug() << "SettingsSender: trying batches again";
+        m_protocol = SettingsProtocolUnknown;
+        m_reprobe = false;
+    }
+
+    if (m_protocol == SettingsProtocolLegacy) {
+        startLegacy();
+        return;
+    }
+
+    // keys and values never contain newlines, so they can separate the pairs
+    m_pending.clear();
+    auto batch = newBatch();
+    for (auto i = settings.constBegin(); i != settings.constEnd(); i++) {
+        QByteArray pair = i.key().toUtf8();
+        pair.append('=');
+        pair.append(i.value().toString().toUtf8());
+
+        if (batch.keys > 0 && batch.datagram.size() + 1 + pair.size() > MaxBatchSize) {
+            m_pending.append(batch);
+            batch = newBatch();
+        }
+        batch.datagram.append('\n');
+        batch.datagram.append(pair);
+        batch.keys++;
+    }
+    if (batch.keys > 0) {
+        m_pending.append(batch);
+    }
+
+    for (auto &pending : m_pending) {
+        send(pending);
+    }
+    m_retry_timer->start(AckTimeout / 2);
+}
+
+
+SettingsBatch SettingsSender::newBatch() {
+    SettingsBatch batch;
+    batch.sequence = m_sequence++;
+    batch.datagram = QByteArray("RequestSettingsBatch") + QByteArray::number(batch.sequence);
+    batch.keys = 0;
+    batch.retries = 0;
+    batch.sent_ms = 0;
+    return batch;
+}
+
+
+void SettingsSender::send(SettingsBatch &batch) {
+    m_socket->writeDatagram(batch.datagram, QHostAddress(m_ground_address), SETTINGS_PORT);
+    batch.sent_ms = m_clock.elapsed();
+}
+
+
+void SettingsSender::checkBatches() {
+    auto now = m_clock.elapsed();
+
+    for (int i = 0; i < m_pending.size();) {
+        auto &batch = m_pending[i];
+        if (now - batch.sent_ms < AckTimeout) {
+            i++;
+            continue;
+        }
+
+        if (batch.retries < MaxRetries) {
+            batch.retries++;
+            send(batch);
+            i++;
+            continue;
+        }
+
+        if (m_protocol == SettingsProtocolUnknown) {
+            qDebug() << "SettingsSender: no batch acknowledgement, falling back to single settings";
+            m_legacy_since = now;
+            startLegacy();
+            return;
+        }
+        m_failed += batch.keys;
+        m_pending.removeAt(i);
+    }
+
+    if (m_pending.isEmpty()) {
+        finish(m_failed);
+    }
+}
+
+
+void SettingsSender::processDatagrams() {
+    QByteArray datagram;
+
+    while (m_socket->hasPendingDatagrams()) {
+        datagram.resize(int(m_socket->pendingDatagramSize()));
+        m_socket->readDatagram(datagram.data(), datagram.size());
+
+        if (datagram.startsWith("SavedBatch")) {
+            bool ok = false;
+            uint32_t sequence = datagram.mid(10).trimmed().toUInt(&ok);
+            if (!ok) {
+                continue;
+            }
+            if (m_active && m_protocol == SettingsProtocolLegacy) {
+                // a late answer to the first batch, this save already went out the old way
+                m_reprobe = true;
+                continue;
+            }
+            m_protocol = SettingsProtocolBatched;
+
+            for (int i = 0; i < m_pending.size(); i++) {
+                if (m_pending[i].sequence == sequence) {
+                    m_pending.removeAt(i);
+                    break;
+                }
+            }
+            if (m_active && m_pending.isEmpty()) {
+                finish(m_failed);
+            }
+        } else if (datagram.contains("SavedGround")) {
+            legacySaved();
+        }
+    }
+}
+
+
+void SettingsSender::startLegacy() {
+    m_protocol = SettingsProtocolLegacy;
+    m_pending.clear();
+    m_retry_timer->stop();
+
+    m_legacy_queue.clear();
+    for (auto i = m_settings.constBegin(); i != m_settings.constEnd(); i++) {
+        QByteArray r = QByteArray("RequestChangeSettings");
+        r.append(i.key().toUtf8());
+        r.append('=');
+        r.append(i.value().toString().toUtf8());
+        m_legacy_queue.append(r);
+    }
+    m_legacy_remaining = m_legacy_queue.size();
+    m_legacy_start = m_clock.elapsed();
+
+    m_legacy_timer->start(LegacyInterval);
+    sendNextLegacy();
+}
+
+
+void SettingsSender::sendNextLegacy() {
+    if (!m_legacy_queue.isEmpty()) {
+        m_socket->writeDatagram(m_legacy_queue.takeFirst(), QHostAddress(m_ground_address), SETTINGS_PORT);
+        if (m_legacy_queue.isEmpty()) {
+            // everything is out, only the timeout is left to check
+            m_legacy_timer->setInterval(1000);
+        }
+    }
+
+    // fallback in case the ground pi never sends back "SavedGround" for all the settings we saved
+    if (m_clock.elapsed() - m_legacy_start > LegacyTimeout) {
+        finish(m_legacy_remaining);
+    }
+}
+
+
+void SettingsSender::legacySaved() {
+    if (!m_active || m_protocol != SettingsProtocolLegacy) {
+        return;
+    }
+    m_legacy_remaining--;
+    if (m_legacy_remaining <= 0) {
+        finish(0);
+    }
+}
+
+
+void SettingsSender::finish(int failed) {
+    m_active = false;
+    m_retry_timer->stop();
+    m_legacy_timer->stop();
+    m_pending.clear();
+    m_legacy_queue.clear();
+    m_settings.clear();
+
+    if (failed > 0) {
+        emit saveFailed(failed);
+    } else {
+        emit saveFinished();
+    }
+}
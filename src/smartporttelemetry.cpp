@@ -16,11 +16,9 @@
 #include "constants.h"
 
 #include "openhd.h"
+#include "ingestreactor.h"
 
 
-#define START_STOP 0x7e
-#define DATA_FRAME 0x10
-
 //Frsky DATA ID's
 #define FR_ID_ALTITUDE 0x0100 //ALT_FIRST_ID
 #define FR_ID_VARIO 0x0110 //VARIO_FIRST_ID
@@ -55,154 +53,154 @@
 #define FR_ID_VFAS 0x0210 //VFAS_FIRST_ID
 
 
-SmartportTelemetry::SmartportTelemetry(QObject *parent): QObject(parent) {
+SmartportTelemetry::SmartportTelemetry(quint16 port, QObject *parent): QObject(parent), m_framer(SmartPortFrameProtocol), m_port(port) {
     qDebug() << "SmartportTelemetry::SmartportTelemetry()";
 
-    smartportSocket = new QUdpSocket(this);
-    smartportSocket->bind(QHostAddress::Any, 5010);
-    connect(smartportSocket, &QUdpSocket::readyRead, this, &SmartportTelemetry::processSmartportDatagrams);
+    OpenHD::instance()->registerTelemetryPublisher(&m_telemetry);
+    IngestReactor::instance()->addPort(m_port, this);
 }
 
 
-void SmartportTelemetry::processSmartportDatagrams() {
-    QByteArray datagram;
+SmartportTelemetry::~SmartportTelemetry() {
+    IngestReactor::instance()->removePort(m_port);
+    OpenHD::instance()->unregisterTelemetryPublisher(&m_telemetry);
+}
+
 
-    while (smartportSocket->hasPendingDatagrams()) {
-        datagram.resize(int(smartportSocket->pendingDatagramSize()));
-        smartportSocket->readDatagram(datagram.data(), datagram.size());
-        smartport_read((uint8_t*)datagram.data(), datagram.length());
+// called on the ingest thread
+void SmartportTelemetry::ingestDatagram(const uint8_t* data, int size) {
+    for (int i = 0; i < size; i++) {
+        if (m_framer.push(data[i])) {
+            processSmartportMessage(m_framer.payload());
+        }
     }
 }
 
 
-void SmartportTelemetry::processSmartportMessage(uint8_t *b) {
-    tSPortData tel;
-
-    tel.id = (uint16_t)b[1];
-    tel.id <<= 8u;
-    tel.id += (uint16_t)b[0];
+void SmartportTelemetry::ingestFinished() {
+    m_telemetry.publish();
+}
 
-    tel.data.b[0] = b[2];
-    tel.data.b[1] = b[3];
-    tel.data.b[2] = b[4];
-    tel.data.b[3] = b[5];
 
-    tel.crc = b[6];
+void SmartportTelemetry::processSmartportMessage(FrameReader payload) {
+    uint16_t id = payload.u16();
+    uint32_t value = payload.u32();
 
-    switch (tel.id) {
+    switch (id) {
         case FR_ID_VFAS: {
-            auto battery_voltage = (float)tel.data.u16 / 100.0;
-            OpenHD::instance()->set_battery_voltage(battery_voltage);
+            auto battery_voltage = (float)(uint16_t)value / 100.0;
+            m_telemetry.set_battery_voltage(battery_voltage);
             QSettings settings;
             auto battery_cells = settings.value("battery_cells", QVariant(3)).toInt();
             int battery_percent = lipo_battery_voltage_to_percent(battery_cells, battery_voltage);
-            OpenHD::instance()->set_battery_percent(battery_percent);
-            QString battery_gauge_glyph = battery_gauge_glyph_from_percentage(battery_percent);
-            OpenHD::instance()->set_battery_gauge(battery_gauge_glyph);
+            m_telemetry.set_battery_percent(battery_percent);
             break;
         }
         case FR_ID_LATLONG: {
-            if (tel.data.u32 & 0x80000000) {
-                float longitude = (float)(tel.data.u32 & 0x3fffffff);
+            if (value & 0x80000000) {
+                float longitude = (float)(value & 0x3fffffff);
                 longitude /= 600000;
-                if (tel.data.u32 & 0x40000000) {
+                if (value & 0x40000000) {
                     longitude = -longitude;
                 }
-                OpenHD::instance()->set_lon(longitude);
+                m_telemetry.set_lon(longitude);
             } else {
-                float latitude = (float)(tel.data.u32 & 0x3fffffff);
+                float latitude = (float)(value & 0x3fffffff);
                 latitude /= 600000;
-                if (tel.data.u32 & 0x40000000) {
+                if (value & 0x40000000) {
                     latitude = -latitude;
                 }
-                OpenHD::instance()->set_lat(latitude);
+                m_telemetry.set_lat(latitude);
             }
             break;
         }
         case FR_ID_GPS_ALT: {
-            auto msl_altitude = (float)(tel.data.i32) / 100.0;
-            OpenHD::instance()->set_alt_msl(msl_altitude);
+            auto msl_altitude = (float)((int32_t)value) / 100.0;
+            m_telemetry.set_alt_msl(msl_altitude);
             break;
         }
         case FR_ID_SPEED: {
-            auto speed = (float)(tel.data.u32) / 2000.0;
-            OpenHD::instance()->set_speed(speed);
+            auto speed = (float)(value) / 2000.0;
+            m_telemetry.set_speed(speed);
             break;
         }
         case FR_ID_GPS_COURSE: {
-            auto heading = (float)( tel.data.u32 ) / 100.0;
-            OpenHD::instance()->set_hdg(heading);
+            auto heading = (float)( value ) / 100.0;
+            m_telemetry.set_hdg(heading);
             break;
         }
         case FR_ID_T1: {
             // iNac, CF flight modes / arm
-            //u16Modes = tel->d.data.u16; // see inav smartport.c //printf( "T1: %x", tel->d.data.u32 );
+            //u16Modes = value; // see inav smartport.c //printf( "T1: %x", value );
             break;
         }
         case FR_ID_T2: {
             // iNav, CF sat fix / home
-            //auto fix = (uint8_t)( tel.data.u32 / 1000 );
-            auto sats = (uint8_t)( tel.data.u32 % 1000 );
-            OpenHD::instance()->set_satellites_visible(sats);
+            //auto fix = (uint8_t)( value / 1000 );
+            auto sats = (uint8_t)( value % 1000 );
+            m_telemetry.set_satellites_visible(sats);
             break;
         }
         case FR_ID_GPS_SAT: {
             // car ctrl sat fix
-            //auto fix = (uint8_t)( tel.data.u16 % 10 );
-            auto sats = (uint8_t)( tel.data.u16 / 10 ); //printf( "Sat: %x", tel->d.data.u32 );
-            OpenHD::instance()->set_satellites_visible(sats);
+            //auto fix = (uint8_t)( (uint16_t)value % 10 );
+            auto sats = (uint8_t)( (uint16_t)value / 10 ); //printf( "Sat: %x", value );
+            m_telemetry.set_satellites_visible(sats);
             break;
         }
         case FR_ID_RSSI: {
-            //auto rssi = (uint8_t)tel.data.u8; //printf( "RSSI: %x - %x", u8UavRssi, tel->d.data.u32 );
+            //auto rssi = (uint8_t)value; //printf( "RSSI: %x - %x", u8UavRssi, value );
             break;
         }
         case FR_ID_RXBATT: {
-            //auto rx_batt = (float)(tel.data.u8);
+            //auto rx_batt = (float)((uint8_t)value);
             //rx_batt *= 3.3 / 255.0 * 4.0;
             break;
         }
         case FR_ID_SWR: {
-            //auto swr = (uint8_t)(tel.data.u32);
+            //auto swr = (uint8_t)(value);
             break;
         }
         case FR_ID_ADC1: {
-            //double adc1 = (float)tel.data.u8;
+            //double adc1 = (float)(uint8_t)value;
             //adc1 *= 3.3 / 255.0;
             break;
         }
         case FR_ID_ADC2: {
-            //double adc2 = (float)tel.data.u8;
+            //double adc2 = (float)(uint8_t)value;
             //adc2 = 3.3 / 255.0;
             break;
         }
         case FR_ID_ALTITUDE: {
-            auto rel_altitude = (float)(tel.data.i32) / 100.0;
-            OpenHD::instance()->set_alt_rel(rel_altitude);
+            auto rel_altitude = (float)((int32_t)value) / 100.0;
+            m_telemetry.set_alt_rel(rel_altitude);
             break;
         }
         case FR_ID_VARIO: {
-            //auto vario = (float)( tel.data.i32 ) / 100;
+            //auto vario = (float)( (int32_t)value ) / 100;
             break;
         }
         case FR_ID_ACCX: {
-            auto x = tel.data.i16;
-            OpenHD::instance()->set_vx(x);
+            auto x = (int16_t)value;
+            m_telemetry.set_vx(x);
             break;
         }
         case FR_ID_ACCY: {
-            auto y = tel.data.i16;
-            OpenHD::instance()->set_vy(y);
+            auto y = (int16_t)value;
+            m_telemetry.set_vy(y);
             break;
         }
         case FR_ID_ACCZ: {
-            auto z = tel.data.i16;
-            OpenHD::instance()->set_vz(z);
+            auto z = (int16_t)value;
+            m_telemetry.set_vz(z);
             break;
         }
         case FR_ID_CURRENT: {
-            auto ampere = (float)tel.data.u16 / 10.0;  // this is guessed
-            OpenHD::instance()->set_battery_current(ampere);
+            auto ampere = (float)(uint16_t)value / 10.0;  // this is guessed
+            m_telemetry.set_battery_current(ampere);
+
+            // app mAh is integrated from the current on the GUI thread
+            m_telemetry.battery_updated();
             break;
         }
         case FR_ID_CELLS: {
@@ -233,7 +231,7 @@ void SmartportTelemetry::processSmartportMessage(uint8_t *b) {
             break;
         }
         default: {
-            //printf( "\r\nsmartport unknown id: %x , %x", (uint16_t)tel.id, tel.data.u32 );
+            //printf( "\r\nsmartport unknown id: %x , %x", id, value );
             break;
         }
     }
@@ -245,58 +243,3 @@ void SmartportTelemetry::set_last_heartbeat(QString last_heartbeat) {
     emit last_heartbeat_changed(m_last_heartbeat);
 }
 
-
-void SmartportTelemetry::smartport_read(uint8_t *buf, int buflen) {
-    static uint8_t s = 0;
-    static uint8_t e = 0;
-    static uint8_t tBuffer[7];
-    uint8_t b;
-    int i;
-
-    for (i = 0; i < buflen; i++) {
-        b = *buf++;
-        if ((e == 0) && (b == 0x7d)) {
-            e = 1;
-            continue;
-        }
-        if (e == 1) {
-            e = 0;
-            b = b + 0x20;
-        }
-
-        if (s == 0) {
-            if (b == DATA_FRAME) {
-                s++;
-            }
-        }
-        else if (s <= 6) {
-            tBuffer[s-1] = b;
-            s++;
-        } else {
-            tBuffer[6] = b;
-            if (0 != u8CheckCrcSPORT(tBuffer)) {
-                processSmartportMessage(tBuffer);
-            }
-            s = 0;
-        }
-    }
-}
-
-
-uint8_t SmartportTelemetry::u8CheckCrcSPORT(uint8_t *b) {
-    uint16_t u16Crc = DATA_FRAME;
-
-    int i;
-
-    for (i = 0; i < 6; i++) {
-        u16Crc += b[i];
-        u16Crc += u16Crc >> 8;
-        u16Crc &= 0x00ff;
-    }
-
-    if ((uint8_t)(0xFF - u16Crc) == b[6]) {
-        return 1u;
-    } else {
-        return 0u;
-    }
-}
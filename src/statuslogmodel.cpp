@@ -1,5 +1,7 @@
 #include "statuslogmodel.h"
 
+#include <algorithm>
+
 
 static StatusLogModel* _instance = nullptr;
 
@@ -11,21 +13,184 @@ StatusLogModel* StatusLogModel::instance() {
 }
 
 
-StatusLogModel::StatusLogModel(QObject *parent) {
+StatusLogModel::StatusLogModel(QObject *parent): QAbstractListModel(parent) {
     qDebug() << "StatusLogModel::StatusLogModel()";
 }
 
 
 void StatusLogModel::addMessage(StatusMessage message) {
-    beginInsertRows(QModelIndex(), rowCount(), rowCount());
-    m_messages.append(message);
-    endInsertRows();
+    QMutexLocker locker(&m_pending_mutex);
+    m_pending.append(message);
+    if (m_flush_scheduled) {
+        return;
+    }
+    m_flush_scheduled = true;
+    QMetaObject::invokeMethod(this, [this] {
+        flush();
+    }, Qt::QueuedConnection);
+}
+
+
+int StatusLogModel::severityIndex(int severity) {
+    return qBound(0, severity, SeverityCount - 1);
+}
+
+
+bool StatusLogModel::filtered() const {
+    return m_severity_filter < SeverityCount - 1 || m_sysid_filter != -1;
+}
+
+
+bool StatusLogModel::matches(const StatusMessage &message) const {
+    if (m_sysid_filter != -1 && message.sysid != m_sysid_filter) {
+        return false;
+    }
+    return severityIndex(message.severity) <= m_severity_filter;
+}
+
+
+void StatusLogModel::flush() {
+    QList<StatusMessage> batch;
+    {
+        QMutexLocker locker(&m_pending_mutex);
+        batch.swap(m_pending);
+        m_flush_scheduled = false;
+    }
+    if (batch.isEmpty()) {
+        return;
+    }
+
+    // anything before the last Capacity messages would be evicted by this same batch
+    if (batch.size() > Capacity) {
+        batch = batch.mid(batch.size() - Capacity);
+    }
+
+    int evict = qMax(0, int(m_messages.size()) + batch.size() - Capacity);
+    if (evict > 0) {
+        /*
+         * The evicted messages are the oldest ones, so they're at the front of every index
+         * and of the visible rows.
+         */
+        auto evict_end = m_first_seq + evict;
+        int visible_evicted = evict;
+        if (filtered()) {
+            visible_evicted = 0;
+            while (visible_evicted < m_visible.size() && m_visible.at(visible_evicted) < evict_end) {
+                visible_evicted++;
+            }
+        }
+
+        if (visible_evicted > 0) {
+            beginRemoveRows(QModelIndex(), 0, visible_evicted - 1);
+        }
+        for (int i = 0; i < evict; i++) {
+            auto &message = m_messages.at(i);
+            m_by_severity[severityIndex(message.severity)].removeFirst();
+            auto &by_sysid = m_by_sysid[message.sysid];
+            by_sysid.removeFirst();
+            if (by_sysid.isEmpty()) {
+                m_by_sysid.remove(message.sysid);
+            }
+        }
+        m_messages.drop_front(evict);
+        m_first_seq = evict_end;
+        if (filtered()) {
+            m_visible.erase(m_visible.begin(), m_visible.begin() + visible_evicted);
+        }
+        if (visible_evicted > 0) {
+            endRemoveRows();
+        }
+    }
+
+    int inserted = batch.size();
+    if (filtered()) {
+        inserted = 0;
+        for (auto &message : batch) {
+            if (matches(message)) {
+                inserted++;
+            }
+        }
+    }
+
+    int first_row = rowCount();
+    if (inserted > 0) {
+        beginInsertRows(QModelIndex(), first_row, first_row + inserted - 1);
+    }
+    for (auto &message : batch) {
+        quint64 seq = m_first_seq + m_messages.size();
+        m_messages.push(message);
+        m_by_severity[severityIndex(message.severity)].append(seq);
+        m_by_sysid[message.sysid].append(seq);
+        if (filtered() && matches(message)) {
+            m_visible.append(seq);
+        }
+    }
+    if (inserted > 0) {
+        endInsertRows();
+    }
+}
+
+
+void StatusLogModel::rebuildVisible() {
+    m_visible.clear();
+    if (!filtered()) {
+        return;
+    }
+
+    if (m_sysid_filter != -1) {
+        // one unit's messages are already in order, only the severity needs checking
+        for (auto seq : m_by_sysid.value(m_sysid_filter)) {
+            if (severityIndex(m_messages.at(seq - m_first_seq).severity) <= m_severity_filter) {
+                m_visible.append(seq);
+            }
+        }
+        return;
+    }
+
+    for (int severity = 0; severity <= m_severity_filter; severity++) {
+        m_visible.append(m_by_severity[severity]);
+    }
+    std::sort(m_visible.begin(), m_visible.end());
+}
+
+
+void StatusLogModel::set_severity_filter(int severity_filter) {
+    beginResetModel();
+    m_severity_filter = severityIndex(severity_filter);
+    rebuildVisible();
+    endResetModel();
+    emit severity_filter_changed(m_severity_filter);
+}
+
+
+void StatusLogModel::set_sysid_filter(int sysid_filter) {
+    beginResetModel();
+    m_sysid_filter = sysid_filter;
+    rebuildVisible();
+    endResetModel();
+    emit sysid_filter_changed(m_sysid_filter);
+}
+
+
+int StatusLogModel::severityCount(int severity) const {
+    if (severity < 0 || severity >= SeverityCount) {
+        return 0;
+    }
+    return m_by_severity[severity].size();
+}
+
+
+int StatusLogModel::sysidCount(int sysid) const {
+    return m_by_sysid.value(sysid).size();
 }
 
 
 int StatusLogModel::rowCount(const QModelIndex & parent) const {
     Q_UNUSED(parent)
-    return m_messages.count();
+    if (filtered()) {
+        return m_visible.size();
+    }
+    return int(m_messages.size());
 }
 
 
@@ -48,13 +213,21 @@ QHash<int, QByteArray> StatusLogModel::roleNames() const {
 }
 
 
+const StatusMessage& StatusLogModel::messageForRow(int row) const {
+    if (filtered()) {
+        return m_messages.at(m_visible.at(row) - m_first_seq);
+    }
+    return m_messages.at(row);
+}
+
+
 QVariant StatusLogModel::data(const QModelIndex &index, int role) const {
 
-    if (index.row() < 0 || index.row() >= m_messages.size()) {
+    if (index.row() < 0 || index.row() >= rowCount()) {
         return QVariant();
     }
 
-    const StatusMessage entry = m_messages[index.row()];
+    const StatusMessage &entry = messageForRow(index.row());
 
     if (role == 0) {
         return QVariant::fromValue(entry.message);
@@ -8,6 +8,8 @@
 
 #include <openhd/mavlink.h>
 
+#include "logger.h"
+
 
 StatusMicroservice::StatusMicroservice(QObject *parent, MicroserviceTarget target, MavlinkType mavlink_type): MavlinkBase(parent, mavlink_type), m_target(target) {
     qDebug() << "StatusMicroservice::StatusMicroservice()";
@@ -113,7 +115,8 @@ void StatusMicroservice::onProcessMavlinkMessage(mavlink_message_t msg) {
             break;
         }
         default: {
-            printf("StatusMicroservice received unmatched message with ID %d, sequence: %d from component %d of system %d\n", msg.msgid, msg.seq, msg.compid, msg.sysid);
+            LOG_EVENT(LogEventUnmatchedMavlink, msg.msgid, msg.sysid << 8 | msg.compid);
+            LOG_RATE_LIMITED_BY(m_unmatched_log, QtDebugMsg, "StatusMicroservice received unmatched message with ID %d, sequence: %d from component %d of system %d", msg.msgid, msg.seq, msg.compid, msg.sysid);
             break;
         }
     }
@@ -0,0 +1,231 @@
+#include "telemetrydetector.h"
+
+#include <QtNetwork>
+
+#include "frskytelemetry.h"
+#include "ltmtelemetry.h"
+#include "msptelemetry.h"
+#include "smartporttelemetry.h"
+#include "vectortelemetry.h"
+
+
+/*
+ * The ports the ground station forwards the serial telemetry protocols to. Whichever port a
+ * protocol is found on is the one its parser is started on.
+ */
+static const quint16 TelemetryPorts[] = { 5001, 5002, 5010, 5011 };
+
+
+TelemetrySniffer::TelemetrySniffer(TelemetryDetector* detector, quint16 port):
+    port(port),
+    m_detector(detector),
+    m_ltm(LTMFrameProtocol),
+    m_vector(VectorFrameProtocol),
+    m_frsky(FrSkyFrameProtocol),
+    m_smartport(SmartPortFrameProtocol) {}
+
+
+void TelemetrySniffer::ingestDatagram(const uint8_t* data, int size) {
+    if (m_detector->m_detected.load()) {
+        return;
+    }
+
+    auto protocol = sniff(data, size);
+    if (protocol != TelemetryProtocolUnknown) {
+        m_detector->detected(protocol, port);
+    }
+}
+
+
+TelemetryProtocol TelemetrySniffer::sniff(const uint8_t* data, int size) {
+    /*
+     * MAVLink is sent a whole packet per datagram, so checking the start of each one for the
+     * v1 or v2 magic and a payload length that fits is enough.
+     */
+    if (size >= 8 && data[0] == 0xFE && size >= data[1] + 8) {
+        m_mavlink_count++;
+    } else if (size >= 12 && data[0] == 0xFD && size >= data[1] + 12) {
+        m_mavlink_count++;
+    }
+    if (m_mavlink_count >= TelemetryDetector::DetectFrames) {
+        return TelemetryProtocolMavlink;
+    }
+
+    for (int i = 0; i < size; i++) {
+        uint8_t byte = data[i];
+
+        m_ltm.push(byte);
+        m_vector.push(byte);
+        m_frsky.push(byte);
+        m_smartport.push(byte);
+        m_msp.push(byte);
+    }
+
+    /*
+     * FrSky has no checksum, any 0x5E in another protocol's stream followed by a couple of bytes
+     * looks like a frame, so it goes last and has to be seen a lot more often.
+     */
+    if (m_vector.stats().frames >= TelemetryDetector::DetectFrames) {
+        return TelemetryProtocolVector;
+    }
+    if (m_ltm.stats().frames >= TelemetryDetector::DetectFrames) {
+        return TelemetryProtocolLTM;
+    }
+    if (m_smartport.stats().frames >= TelemetryDetector::DetectFrames) {
+        return TelemetryProtocolSmartPort;
+    }
+    if (m_msp.stats().frames >= TelemetryDetector::DetectFrames) {
+        return TelemetryProtocolMSP;
+    }
+    if (m_frsky.stats().frames >= TelemetryDetector::DetectFrames * 4) {
+        return TelemetryProtocolFrSky;
+    }
+    return TelemetryProtocolUnknown;
+}
+
+
+static TelemetryDetector* _instance = nullptr;
+
+TelemetryDetector* TelemetryDetector::instance() {
+    if (_instance == nullptr) {
+        _instance = new TelemetryDetector();
+    }
+    return _instance;
+}
+
+
+TelemetryDetector::TelemetryDetector(QObject *parent): QObject(parent), m_detected(false) {
+    qDebug() << "TelemetryDetector::TelemetryDetector()";
+}
+
+
+void TelemetryDetector::onStarted() {
+    qDebug() << "TelemetryDetector::onStarted()";
+
+    for (auto port : TelemetryPorts) {
+        auto sniffer = new TelemetrySniffer(this, port);
+        if (IngestReactor::instance()->addPort(port, sniffer)) {
+            m_sniffers.append(sniffer);
+        } else {
+            delete sniffer;
+        }
+    }
+
+    m_probe_socket = new QUdpSocket(this);
+    m_probe_timer = new QTimer(this);
+    connect(m_probe_timer, &QTimer::timeout, this, &TelemetryDetector::sendProbe);
+    m_probe_timer->start(1000);
+
+    m_detect_timer = new QTimer(this);
+    m_detect_timer->setSingleShot(true);
+    connect(m_detect_timer, &QTimer::timeout, this, &TelemetryDetector::onDetectTimeout);
+    m_detect_timer->start(DetectTimeoutMs);
+}
+
+
+void TelemetryDetector::setGroundIP(QString address) {
+    m_ground_address = address;
+    if (m_msp_telemetry != nullptr) {
+        m_msp_telemetry->setGroundIP(address);
+    }
+}
+
+
+void TelemetryDetector::sendProbe() {
+    QSettings settings;
+    auto uplink_port = settings.value("msp_uplink_port", 5003).toUInt();
+
+    uint8_t request[MSPMaxRequestSize];
+    auto length = mspEncodeRequest(request, MSPCommandStatus);
+    m_probe_socket->writeDatagram((const char*)request, length, QHostAddress(m_ground_address), uplink_port);
+}
+
+
+void TelemetryDetector::onMavlinkHeartbeat() {
+    stop("MAVLink flight controller found");
+}
+
+
+void TelemetryDetector::onDetectTimeout() {
+    stop("nothing found");
+}
+
+
+void TelemetryDetector::stop(QString reason) {
+    bool expected = false;
+    if (!m_detected.compare_exchange_strong(expected, true)) {
+        return;
+    }
+
+    qDebug() << "TelemetryDetector: stopping," << reason;
+    release();
+}
+
+
+void TelemetryDetector::release() {
+    for (auto sniffer : m_sniffers) {
+        IngestReactor::instance()->removePort(sniffer->port);
+        delete sniffer;
+    }
+    m_sniffers.clear();
+
+    m_probe_timer->stop();
+    m_detect_timer->stop();
+}
+
+
+void TelemetryDetector::detected(TelemetryProtocol protocol, quint16 port) {
+    bool expected = false;
+    if (!m_detected.compare_exchange_strong(expected, true)) {
+        return;
+    }
+
+    // the reactor is in the middle of calling a sniffer, ports can only be changed once it's done
+    QMetaObject::invokeMethod(this, [this, protocol, port] {
+        activate(protocol, port);
+    }, Qt::QueuedConnection);
+}
+
+
+void TelemetryDetector::activate(TelemetryProtocol protocol, quint16 port) {
+    release();
+
+    switch (protocol) {
+        case TelemetryProtocolMavlink: {
+            m_protocol = "MAVLink";
+            break;
+        }
+        case TelemetryProtocolLTM: {
+            new LTMTelemetry(port, this);
+            m_protocol = "LTM";
+            break;
+        }
+        case TelemetryProtocolVector: {
+            new VectorTelemetry(port, this);
+            m_protocol = "Vector";
+            break;
+        }
+        case TelemetryProtocolFrSky: {
+            new FrSkyTelemetry(port, this);
+            m_protocol = "FrSky";
+            break;
+        }
+        case TelemetryProtocolSmartPort: {
+            new SmartportTelemetry(port, this);
+            m_protocol = "SmartPort";
+            break;
+        }
+        case TelemetryProtocolMSP: {
+            m_msp_telemetry = new MSPTelemetry(port, this);
+            m_msp_telemetry->setGroundIP(m_ground_address);
+            m_protocol = "MSP";
+            break;
+        }
+        default: {
+            break;
+        }
+    }
+
+    qDebug() << "TelemetryDetector: found" << m_protocol << "on port" << port;
+    emit protocol_changed(m_protocol);
+}
@@ -0,0 +1,257 @@
+#include "telemetryframing.h"
+
+#include <string.h>
+
+
+/*
+ * LightTelemetry, "$T" followed by the frame type. The lengths are the payload only, the
+ * protocol documentation counts the 3 header bytes and the checksum as well.
+ */
+static const FrameType LTMFrameTypes[] = {
+    { 'G', 14 }, // GPS: lat, lon, ground speed, altitude, sats/fix
+    { 'A', 6 },  // attitude: pitch, roll, heading
+    { 'S', 7 },  // status: voltage, consumed mAh, rssi, airspeed, arm/failsafe/flight mode
+    { 'O', 14 }, // origin: home lat, lon, altitude, osd on, home fix
+    { 'N', 6 },  // navigation
+    { 'X', 6 }   // GPS extra: hdop, hardware status
+};
+
+const FrameProtocol LTMFrameProtocol = {
+    "LTM",
+    { 0x24, 0x54 }, 2,
+    true, LTMFrameTypes, sizeof(LTMFrameTypes) / sizeof(FrameType), 0,
+    false, 0, 0,
+    false, 0,
+    FrameChecksumXor
+};
+
+
+/*
+ * Vector Open Telemetry, a single 97 byte big endian frame starting with 0xB01EDEAD and ending
+ * with a little endian CRC.
+ */
+const FrameProtocol VectorFrameProtocol = {
+    "VOT",
+    { 0xB0, 0x1E, 0xDE, 0xAD }, 4,
+    false, nullptr, 0, 91,
+    false, 0, 0,
+    false, 0,
+    FrameChecksumVector
+};
+
+
+/*
+ * FrSky D receivers (the telemetry hub protocol), 0x5E followed by a data id and a little endian
+ * 16 bit value. 0x5E and 0x5D are byte stuffed in the rest of the frame.
+ */
+const FrameProtocol FrSkyFrameProtocol = {
+    "FrSky",
+    { 0x5E }, 1,
+    true, nullptr, 0, 2,
+    true, 0x5D, 0x60,
+    true, 0x5E,
+    FrameChecksumNone
+};
+
+
+/*
+ * FrSky SmartPort, the 0x10 data frame byte followed by a little endian 16 bit data id, a
+ * little endian 32 bit value and a checksum. 0x7E starts every poll on the bus, it and 0x7D
+ * are byte stuffed inside a frame.
+ */
+const FrameProtocol SmartPortFrameProtocol = {
+    "SmartPort",
+    { 0x10 }, 1,
+    false, nullptr, 0, 6,
+    true, 0x7D, 0x20,
+    true, 0x7E,
+    FrameChecksumSmartPort
+};
+
+
+int frameChecksumLength(FrameChecksum checksum) {
+    switch (checksum) {
+        case FrameChecksumXor:
+        case FrameChecksumSmartPort:
+            return 1;
+        case FrameChecksumVector:
+            return 2;
+        default:
+            return 0;
+    }
+}
+
+
+// the CRC16 from the Vector Open Telemetry sample code, written out byte-wise so it doesn't depend on endianness
+static uint16_t vectorCRC16(uint16_t crc, uint8_t r0) {
+    uint8_t crch = crc >> 8;
+    uint8_t crcl = crc & 0xff;
+
+    r0 ^= crch;
+    uint8_t a1 = crcl;
+    crch = (uint8_t)((r0 << 4) | (r0 >> 4));
+    crcl = crch ^ r0;
+    crch &= 0x0f;
+    crcl &= 0xf0;
+    r0 ^= crch;
+    a1 ^= crcl;
+
+    uint16_t shifted = (uint16_t)(((crch << 8) | crcl) << 1);
+    crch = (shifted >> 8) ^ a1;
+    crcl = (shifted & 0xff) ^ r0;
+
+    return (uint16_t)((crch << 8) | crcl);
+}
+
+
+uint16_t frameChecksum(const FrameProtocol &protocol, const uint8_t* frame, int length, int payload_offset) {
+    switch (protocol.checksum) {
+        case FrameChecksumXor: {
+            uint8_t checksum = 0;
+            for (int i = payload_offset; i < length; i++) {
+                checksum ^= frame[i];
+            }
+            return checksum;
+        }
+        case FrameChecksumSmartPort: {
+            uint16_t sum = 0;
+            for (int i = 0; i < length; i++) {
+                sum += frame[i];
+                sum += sum >> 8;
+                sum &= 0x00ff;
+            }
+            return (uint8_t)(0xff - sum);
+        }
+        case FrameChecksumVector: {
+            uint16_t crc = 0xffff;
+            for (int i = 0; i < length; i++) {
+                crc = vectorCRC16(crc, frame[i]);
+            }
+            return crc;
+        }
+        default:
+            return 0;
+    }
+}
+
+
+TelemetryFramer::TelemetryFramer(const FrameProtocol &protocol): m_protocol(protocol) {}
+
+
+void TelemetryFramer::reset() {
+    m_state = FramerStateSync;
+    m_sync_index = 0;
+    m_escape_pending = false;
+    m_frame_length = 0;
+}
+
+
+bool TelemetryFramer::push(uint8_t byte) {
+    m_stats.bytes++;
+
+    if (m_protocol.delimited && byte == m_protocol.delimiter && m_state != FramerStateSync) {
+        // FrSky sends delimiters back to back, that only counts if some of a frame was lost
+        if (m_frame_length > m_protocol.sync_length || m_escape_pending) {
+            m_stats.dropped++;
+        }
+        reset();
+    }
+
+    if (m_state == FramerStateSync) {
+        resync(byte);
+        return false;
+    }
+
+    if (m_protocol.escaped) {
+        if (m_escape_pending) {
+            byte ^= m_protocol.escape_xor;
+            m_escape_pending = false;
+        } else if (byte == m_protocol.escape) {
+            m_escape_pending = true;
+            return false;
+        }
+    }
+
+    m_frame[m_frame_length++] = byte;
+
+    if (m_state == FramerStateType) {
+        m_type = byte;
+
+        int length = -1;
+        if (m_protocol.types == nullptr) {
+            length = m_protocol.fixed_length;
+        } else {
+            for (int i = 0; i < m_protocol.type_count; i++) {
+                if (m_protocol.types[i].id == byte) {
+                    length = m_protocol.types[i].length;
+                    break;
+                }
+            }
+        }
+
+        if (length < 0) {
+            m_stats.dropped++;
+            reset();
+            // it may have been the start of the next frame rather than a corrupted type
+            resync(byte);
+            return false;
+        }
+        beginPayload(length);
+    }
+
+    if (m_frame_length < m_expected_length) {
+        return false;
+    }
+
+    int end = m_frame_length - frameChecksumLength(m_protocol.checksum);
+    uint16_t received = 0;
+    for (int i = m_frame_length - 1; i >= end; i--) {
+        received = (uint16_t)((received << 8) | m_frame[i]);
+    }
+    bool valid = frameChecksum(m_protocol, m_frame, end, m_payload_offset) == received;
+    reset();
+
+    if (!valid) {
+        m_stats.checksum_errors++;
+        return false;
+    }
+    m_stats.frames++;
+    return true;
+}
+
+
+void TelemetryFramer::resync(uint8_t byte) {
+    if (byte == m_protocol.sync[m_sync_index]) {
+        m_sync_index++;
+    } else {
+        m_sync_index = (byte == m_protocol.sync[0]) ? 1 : 0;
+    }
+
+    if (m_sync_index == m_protocol.sync_length) {
+        beginFrame();
+    }
+}
+
+
+void TelemetryFramer::beginFrame() {
+    memcpy(m_frame, m_protocol.sync, m_protocol.sync_length);
+    m_frame_length = m_protocol.sync_length;
+    m_sync_index = 0;
+    m_escape_pending = false;
+    m_type = 0;
+
+    if (m_protocol.typed) {
+        m_state = FramerStateType;
+    } else {
+        beginPayload(m_protocol.fixed_length);
+    }
+}
+
+
+void TelemetryFramer::beginPayload(int length) {
+    m_payload_offset = m_frame_length;
+    m_payload_length = length;
+    m_expected_length = m_frame_length + length + frameChecksumLength(m_protocol.checksum);
+    m_state = FramerStatePayload;
+}
+
@@ -0,0 +1,445 @@
+#include "telemetryreplay.h"
+
+#include <QThread>
+#include <QDir>
+
+#include <algorithm>
+#include <string.h>
+
+#include "mavlinkbase.h"
+#include "openhdtelemetry.h"
+#include "openhd.h"
+
+
+// records handed over per batch at SpeedMax, and how many batches may be in flight at once
+static const int MaxBatchSize = 256;
+static const int MaxPendingBatches = 2;
+
+
+static TelemetryReplay* _instance = nullptr;
+
+TelemetryReplay* TelemetryReplay::instance() {
+    if (_instance == nullptr) {
+        _instance = new TelemetryReplay();
+    }
+    return _instance;
+}
+
+TelemetryReplay::TelemetryReplay(QObject *parent): QObject(parent), m_pending(0), m_delivered(0), m_gui_nsecs(0) {
+    qDebug() << "TelemetryReplay::TelemetryReplay()";
+}
+
+
+void TelemetryReplay::onStarted() {
+    qDebug() << "TelemetryReplay::onStarted()";
+
+    timer = new QTimer(this);
+    timer->setTimerType(Qt::PreciseTimer);
+    connect(timer, &QTimer::timeout, this, &TelemetryReplay::tick);
+}
+
+
+void TelemetryReplay::addMavlinkTarget(MavlinkBase* target) {
+    m_mavlink_targets.append(target);
+}
+
+
+void TelemetryReplay::setOpenHDTarget(OpenHDTelemetry* target) {
+    m_openhd_target = target;
+}
+
+
+QStringList TelemetryReplay::recordings() {
+    QDir dir(FlightRecorder::recordingDirectory());
+    auto segments = dir.entryInfoList(QStringList() << "*.qrec", QDir::Files, QDir::Name | QDir::Reversed);
+
+    QStringList paths;
+    for (auto &segment : segments) {
+        paths.append(segment.absoluteFilePath());
+    }
+    return paths;
+}
+
+
+/*
+ * The Q_INVOKABLE methods are called from QML on the GUI thread, the actual work happens on
+ * the replay thread.
+ */
+void TelemetryReplay::open(QString path) {
+    QMetaObject::invokeMethod(this, [this, path] { openSegment(path); }, Qt::QueuedConnection);
+}
+
+
+void TelemetryReplay::close() {
+    QMetaObject::invokeMethod(this, [this] { closeSegment(); }, Qt::QueuedConnection);
+}
+
+
+void TelemetryReplay::play() {
+    QMetaObject::invokeMethod(this, [this] { playSegment(); }, Qt::QueuedConnection);
+}
+
+
+void TelemetryReplay::pause() {
+    QMetaObject::invokeMethod(this, [this] { pauseSegment(); }, Qt::QueuedConnection);
+}
+
+
+void TelemetryReplay::seek(double position) {
+    QMetaObject::invokeMethod(this, [this, position] { seekSegment(position); }, Qt::QueuedConnection);
+}
+
+
+void TelemetryReplay::setSpeed(int speed) {
+    QMetaObject::invokeMethod(this, [this, speed] { changeSpeed(speed); }, Qt::QueuedConnection);
+}
+
+
+void TelemetryReplay::openSegment(QString path) {
+    closeSegment();
+
+    m_file.setFileName(path);
+    if (!m_file.open(QIODevice::ReadOnly)) {
+        emit openFailed(path);
+        return;
+    }
+
+    auto size = m_file.size();
+    if (size < (qint64)sizeof(flight_record_segment_header_t)) {
+        m_file.close();
+        emit openFailed(path);
+        return;
+    }
+
+    m_data = m_file.map(0, size);
+    if (m_data == nullptr) {
+        m_file.close();
+        emit openFailed(path);
+        return;
+    }
+
+    flight_record_segment_header_t header;
+    memcpy(&header, m_data, sizeof(header));
+    if (memcmp(header.magic, FLIGHT_RECORD_MAGIC, sizeof(FLIGHT_RECORD_MAGIC)) != 0 || header.version != FLIGHT_RECORD_VERSION) {
+        closeSegment();
+        emit openFailed(path);
+        return;
+    }
+
+    /*
+     * Index the records up front so seeking is a binary search. A zeroed header is the end of
+     * a segment that was still being written when it was copied.
+     */
+    qint64 offset = header.header_size;
+    while (offset + (qint64)sizeof(flight_record_header_t) <= size) {
+        flight_record_header_t record;
+        memcpy(&record, m_data + offset, sizeof(record));
+        if (record.type == FlightRecordTypeNone) {
+            break;
+        }
+        qint64 total = flight_record_padded_size(record.length);
+        if (offset + total > size) {
+            break;
+        }
+        m_records.append({ offset, (qint64)record.timestamp_ns });
+        offset += total;
+    }
+
+    /*
+     * FlightRecorder::flush() writes out one thread's ring after another, so records are only
+     * in time order within each thread's share of a flush. Stable, so records with the same
+     * timestamp keep the order they were written in.
+     */
+    std::stable_sort(m_records.begin(), m_records.end(), [](const ReplayRecord &a, const ReplayRecord &b) {
+        return a.timestamp_ns < b.timestamp_ns;
+    });
+
+    m_recorder_was_enabled = FlightRecorder::instance()->get_enabled();
+    // don't record what we're replaying
+    FlightRecorder::instance()->set_enabled(false);
+
+    setTargetsReplaying(true);
+
+    m_next = 0;
+    m_position_ns = 0;
+
+    set_path(path);
+    set_duration(m_records.isEmpty() ? 0.0 : (m_records.last().timestamp_ns - m_records.first().timestamp_ns) / 1e9);
+    set_position(0.0);
+    set_active(true);
+}
+
+
+void TelemetryReplay::closeSegment() {
+    if (!m_active && !m_file.isOpen()) {
+        return;
+    }
+    pauseSegment();
+
+    if (m_data != nullptr) {
+        m_file.unmap((uchar*)m_data);
+        m_data = nullptr;
+    }
+    m_file.close();
+    m_records.clear();
+    m_next = 0;
+
+    if (m_active) {
+        setTargetsReplaying(false);
+        FlightRecorder::instance()->set_enabled(m_recorder_was_enabled);
+    }
+
+    set_active(false);
+    set_messages_per_second(0.0);
+    set_gui_ns_per_message(0.0);
+}
+
+
+void TelemetryReplay::setTargetsReplaying(bool replaying) {
+    for (auto target : m_mavlink_targets) {
+        target->setReplaying(replaying);
+    }
+    if (m_openhd_target != nullptr) {
+        m_openhd_target->setReplaying(replaying);
+    }
+}
+
+
+void TelemetryReplay::playSegment() {
+    if (!m_active || m_playing) {
+        return;
+    }
+    if (m_next >= m_records.size()) {
+        seekSegment(0.0);
+    }
+
+    m_tick_time.start();
+    m_stats_time.start();
+    m_stats_delivered = m_delivered.load();
+    m_stats_gui_nsecs = m_gui_nsecs.load();
+    m_stats_sync_nsecs = OpenHD::instance()->telemetrySyncNsecs();
+
+    timer->start(m_speed == SpeedMax ? 0 : 10);
+    set_playing(true);
+}
+
+
+void TelemetryReplay::pauseSegment() {
+    if (!m_playing) {
+        return;
+    }
+    timer->stop();
+    set_playing(false);
+}
+
+
+void TelemetryReplay::seekSegment(double position) {
+    if (m_records.isEmpty()) {
+        return;
+    }
+    auto start = m_records.first().timestamp_ns;
+    qint64 target = start + (qint64)(qMax(position, 0.0) * 1e9);
+
+    auto it = std::lower_bound(m_records.begin(), m_records.end(), target, [](const ReplayRecord &record, qint64 timestamp) {
+        return record.timestamp_ns < timestamp;
+    });
+    m_next = it - m_records.begin();
+    m_position_ns = target - start;
+    set_position(m_position_ns / 1e9);
+}
+
+
+void TelemetryReplay::changeSpeed(int speed) {
+    if (speed != SpeedMax && speed != SpeedNormal && speed != SpeedFast) {
+        return;
+    }
+    set_speed(speed);
+    if (m_playing) {
+        m_tick_time.restart();
+        timer->start(m_speed == SpeedMax ? 0 : 10);
+    }
+}
+
+
+void TelemetryReplay::tick() {
+    if (m_next >= m_records.size()) {
+        // let the last batches drain before reporting the final numbers
+        if (m_pending.load() == 0) {
+            updateStats();
+            pauseSegment();
+        }
+        return;
+    }
+
+    auto start = m_records.first().timestamp_ns;
+    int to = m_next;
+
+    if (m_speed == SpeedMax) {
+        if (m_pending.load() >= MaxPendingBatches) {
+            return;
+        }
+        to = qMin(m_next + MaxBatchSize, m_records.size());
+        m_position_ns = m_records[to - 1].timestamp_ns - start;
+    } else {
+        m_position_ns += m_tick_time.nsecsElapsed() * m_speed;
+        m_tick_time.restart();
+        while (to < m_records.size() && m_records[to].timestamp_ns - start <= m_position_ns) {
+            to++;
+        }
+    }
+
+    if (to > m_next) {
+        deliver(m_next, to);
+        m_next = to;
+    }
+
+    set_position(m_position_ns / 1e9);
+
+    if (m_stats_time.elapsed() >= 1000) {
+        updateStats();
+    }
+}
+
+
+/*
+ * Groups the records into one batch per target so each target thread gets a single queued
+ * call per tick instead of one per datagram.
+ */
+void TelemetryReplay::deliver(int from, int to) {
+    QMap<quint16, QVector<QByteArray>> mavlink;
+    QVector<QByteArray> status;
+
+    for (int i = from; i < to; i++) {
+        flight_record_header_t record;
+        memcpy(&record, m_data + m_records[i].offset, sizeof(record));
+        auto payload = QByteArray((const char*)m_data + m_records[i].offset + sizeof(record), record.length);
+
+        switch (record.type) {
+            case FlightRecordTypeMavlink: {
+                mavlink[record.port].append(payload);
+                break;
+            }
+            case FlightRecordTypeWifibroadcastStatus: {
+                status.append(payload);
+                break;
+            }
+            default: {
+                break;
+            }
+        }
+    }
+
+    auto guiThread = QCoreApplication::instance()->thread();
+
+    for (auto target : m_mavlink_targets) {
+        auto it = mavlink.constFind(target->get_local_port());
+        if (it == mavlink.constEnd()) {
+            continue;
+        }
+        auto batch = it.value();
+        m_pending++;
+        QMetaObject::invokeMethod(target, [this, target, batch, guiThread] {
+            QElapsedTimer elapsed;
+            elapsed.start();
+            for (auto &data : batch) {
+                target->replayData(data);
+            }
+            if (QThread::currentThread() == guiThread) {
+                m_gui_nsecs += elapsed.nsecsElapsed();
+            }
+            m_delivered += batch.size();
+            m_pending--;
+        }, Qt::QueuedConnection);
+    }
+
+    if (m_openhd_target != nullptr && !status.isEmpty()) {
+        auto target = m_openhd_target;
+        m_pending++;
+        QMetaObject::invokeMethod(target, [this, target, status, guiThread] {
+            QElapsedTimer elapsed;
+            elapsed.start();
+            for (auto &datagram : status) {
+                target->replayDatagram(datagram);
+            }
+            if (QThread::currentThread() == guiThread) {
+                m_gui_nsecs += elapsed.nsecsElapsed();
+            }
+            m_delivered += status.size();
+            m_pending--;
+        }, Qt::QueuedConnection);
+    }
+}
+
+
+/*
+ * GUI time is what the targets living on the GUI thread spent processing records, plus the time
+ * OpenHD spent applying telemetry snapshots published by targets on other threads.
+ */
+void TelemetryReplay::updateStats() {
+    auto elapsed = m_stats_time.nsecsElapsed();
+    if (elapsed <= 0) {
+        return;
+    }
+    auto delivered = m_delivered.load();
+    auto gui_nsecs = m_gui_nsecs.load();
+    auto sync_nsecs = OpenHD::instance()->telemetrySyncNsecs();
+
+    auto messages = delivered - m_stats_delivered;
+    auto nsecs = (gui_nsecs - m_stats_gui_nsecs) + (sync_nsecs - m_stats_sync_nsecs);
+
+    set_messages_per_second(messages * 1e9 / elapsed);
+    set_gui_ns_per_message(messages > 0 ? (double)nsecs / messages : 0.0);
+
+    m_stats_delivered = delivered;
+    m_stats_gui_nsecs = gui_nsecs;
+    m_stats_sync_nsecs = sync_nsecs;
+    m_stats_time.restart();
+}
+
+
+void TelemetryReplay::set_path(QString path) {
+    m_path = path;
+    emit path_changed(m_path);
+}
+
+
+void TelemetryReplay::set_active(bool active) {
+    m_active = active;
+    emit active_changed(m_active);
+}
+
+
+void TelemetryReplay::set_playing(bool playing) {
+    m_playing = playing;
+    emit playing_changed(m_playing);
+}
+
+
+void TelemetryReplay::set_speed(int speed) {
+    m_speed = speed;
+    emit speed_changed(m_speed);
+}
+
+
+void TelemetryReplay::set_duration(double duration) {
+    m_duration = duration;
+    emit duration_changed(m_duration);
+}
+
+
+void TelemetryReplay::set_position(double position) {
+    m_position = position;
+    emit position_changed(m_position);
+}
+
+
+void TelemetryReplay::set_messages_per_second(double messages_per_second) {
+    m_messages_per_second = messages_per_second;
+    emit messages_per_second_changed(m_messages_per_second);
+}
+
+
+void TelemetryReplay::set_gui_ns_per_message(double gui_ns_per_message) {
+    m_gui_ns_per_message = gui_ns_per_message;
+    emit gui_ns_per_message_changed(m_gui_ns_per_message);
+}
@@ -0,0 +1,97 @@
+#include "telemetrysubscriptions.h"
+
+#include <openhd/mavlink.h>
+
+
+static TelemetrySubscriptions* _instance = nullptr;
+
+TelemetrySubscriptions* TelemetrySubscriptions::instance() {
+    if (_instance == nullptr) {
+        _instance = new TelemetrySubscriptions();
+    }
+    return _instance;
+}
+
+TelemetrySubscriptions::TelemetrySubscriptions(QObject *parent): QObject(parent) {
+    qDebug() << "TelemetrySubscriptions::TelemetrySubscriptions()";
+
+    /*
+     * Things that are tracked whether or not a widget is showing them: battery state for
+     * warnings, position for home distance and flight distance, and system time so we can
+     * tell when the flight controller reboots and the requested rates need to be sent again.
+     */
+    QVariantMap core;
+    core.insert("SYSTEM_TIME", 1);
+    core.insert("SYS_STATUS", 1);
+    core.insert("GLOBAL_POSITION_INT", 1);
+    subscribe("core", core);
+}
+
+
+const QMap<QString, uint32_t>& TelemetrySubscriptions::managedMessages() {
+    static const QMap<QString, uint32_t> messages = {
+        { "SYS_STATUS", MAVLINK_MSG_ID_SYS_STATUS },
+        { "SYSTEM_TIME", MAVLINK_MSG_ID_SYSTEM_TIME },
+        { "GPS_RAW_INT", MAVLINK_MSG_ID_GPS_RAW_INT },
+        { "SCALED_PRESSURE", MAVLINK_MSG_ID_SCALED_PRESSURE },
+        { "ATTITUDE", MAVLINK_MSG_ID_ATTITUDE },
+        { "GLOBAL_POSITION_INT", MAVLINK_MSG_ID_GLOBAL_POSITION_INT },
+        { "RC_CHANNELS_RAW", MAVLINK_MSG_ID_RC_CHANNELS_RAW },
+        { "RC_CHANNELS", MAVLINK_MSG_ID_RC_CHANNELS },
+        { "VFR_HUD", MAVLINK_MSG_ID_VFR_HUD },
+        { "WIND", MAVLINK_MSG_ID_WIND },
+        { "BATTERY_STATUS", MAVLINK_MSG_ID_BATTERY_STATUS },
+        { "VIBRATION", MAVLINK_MSG_ID_VIBRATION }
+    };
+    return messages;
+}
+
+
+void TelemetrySubscriptions::subscribe(QString subscriber, QVariantMap messages) {
+    QMap<uint32_t, double> subscription;
+
+    for (auto it = messages.constBegin(); it != messages.constEnd(); ++it) {
+        auto message = managedMessages().constFind(it.key());
+        if (message == managedMessages().constEnd()) {
+            qDebug() << "TelemetrySubscriptions: not a managed message:" << it.key();
+            continue;
+        }
+        subscription.insert(message.value(), it.value().toDouble());
+    }
+
+    {
+        QMutexLocker locker(&m_mutex);
+        if (m_subscriptions.value(subscriber) == subscription) {
+            return;
+        }
+        m_subscriptions.insert(subscriber, subscription);
+    }
+    emit ratesChanged();
+}
+
+
+void TelemetrySubscriptions::unsubscribe(QString subscriber) {
+    {
+        QMutexLocker locker(&m_mutex);
+        if (m_subscriptions.remove(subscriber) == 0) {
+            return;
+        }
+    }
+    emit ratesChanged();
+}
+
+
+QMap<uint32_t, double> TelemetrySubscriptions::rates() {
+    QMap<uint32_t, double> rates;
+    for (auto message : managedMessages()) {
+        rates.insert(message, 0.0);
+    }
+
+    QMutexLocker locker(&m_mutex);
+    for (auto &subscription : m_subscriptions) {
+        for (auto it = subscription.constBegin(); it != subscription.constEnd(); ++it) {
+            rates[it.key()] = qMax(rates[it.key()], it.value());
+        }
+    }
+    return rates;
+}
@@ -0,0 +1,192 @@
+#include "timeseriesstore.h"
+
+
+// attached series are refreshed at most this often
+static const int UpdateInterval = 500;
+
+
+TimeSeriesStore::TimeSeriesStore(QStringList columns, int retention, QObject *parent): QObject(parent), m_names(columns), m_retention(retention) {
+    qDebug() << "TimeSeriesStore::TimeSeriesStore()";
+
+    m_x.resize(m_retention);
+    m_columns.resize(m_names.size());
+    for (auto &column : m_columns) {
+        column.resize(m_retention);
+    }
+
+    m_timer = new QTimer(this);
+    connect(m_timer, &QTimer::timeout, this, &TimeSeriesStore::updateSeries);
+    m_timer->start(UpdateInterval);
+}
+
+
+int TimeSeriesStore::column(QString name) const {
+    return m_names.indexOf(name);
+}
+
+
+void TimeSeriesStore::append(double x, const QVector<double> &values) {
+    m_x[m_head] = x;
+    for (int i = 0; i < m_columns.size(); i++) {
+        m_columns[i][m_head] = i < values.size() ? values[i] : 0.0;
+    }
+
+    m_head = (m_head + 1) % m_retention;
+    if (m_size < m_retention) {
+        m_size++;
+    }
+
+    m_dirty = true;
+}
+
+
+void TimeSeriesStore::set_span(double span) {
+    if (span == m_span || span < 0) {
+        return;
+    }
+    m_span = span;
+    m_dirty = true;
+    emit span_changed(m_span);
+}
+
+
+void TimeSeriesStore::set_pixels(int pixels) {
+    if (pixels == m_pixels || pixels <= 0) {
+        return;
+    }
+    m_pixels = pixels;
+    m_dirty = true;
+    emit pixels_changed(m_pixels);
+}
+
+
+// first row with an x value at or after x, rows are always in x order
+int TimeSeriesStore::lowerBound(double x) const {
+    int low = 0;
+    int high = m_size;
+    while (low < high) {
+        int middle = (low + high) / 2;
+        if (xAt(middle) < x) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    return low;
+}
+
+
+void TimeSeriesStore::decimate(int column, double min_x, double max_x, int pixels, QVector<QPointF> &points) const {
+    points.clear();
+
+    if (column < 0 || column >= m_columns.size() || pixels <= 0) {
+        return;
+    }
+
+    int first = lowerBound(min_x);
+    int end = lowerBound(max_x);
+    while (end < m_size && xAt(end) <= max_x) {
+        end++;
+    }
+
+    // few enough rows that every one of them gets a point anyway
+    if (end - first <= pixels * 2 || max_x <= min_x) {
+        for (int row = first; row < end; row++) {
+            points.append(QPointF(xAt(row), valueAt(column, row)));
+        }
+        return;
+    }
+
+    double width = (max_x - min_x) / pixels;
+    int bucket = -1;
+    QPointF low;
+    QPointF high;
+
+    auto flush = [&] {
+        if (bucket == -1) {
+            return;
+        }
+        // keep the two in the order they happened so the line doesn't double back
+        if (low.x() < high.x()) {
+            points.append(low);
+            points.append(high);
+        } else if (low.x() > high.x()) {
+            points.append(high);
+            points.append(low);
+        } else {
+            points.append(low);
+        }
+    };
+
+    for (int row = first; row < end; row++) {
+        QPointF point(xAt(row), valueAt(column, row));
+        int current = qMin(pixels - 1, int((point.x() - min_x) / width));
+
+        if (current != bucket) {
+            flush();
+            bucket = current;
+            low = point;
+            high = point;
+            continue;
+        }
+
+        if (point.y() < low.y()) {
+            low = point;
+        }
+        if (point.y() > high.y()) {
+            high = point;
+        }
+    }
+    flush();
+}
+
+
+#if defined(ENABLE_CHARTS)
+void TimeSeriesStore::attach(QAbstractSeries* series, QString column) {
+    auto xy = qobject_cast<QXYSeries*>(series);
+    auto index = this->column(column);
+
+    if (xy == nullptr || index == -1) {
+        qDebug() << "TimeSeriesStore: can't attach series to" << column;
+        return;
+    }
+
+    detach(series);
+    m_series.append(qMakePair(QPointer<QXYSeries>(xy), index));
+    m_dirty = true;
+}
+
+
+void TimeSeriesStore::detach(QAbstractSeries* series) {
+    for (int i = m_series.size() - 1; i >= 0; i--) {
+        if (m_series[i].first.isNull() || m_series[i].first == series) {
+            m_series.removeAt(i);
+        }
+    }
+}
+#endif
+
+
+void TimeSeriesStore::updateSeries() {
+    if (!m_dirty) {
+        return;
+    }
+    m_dirty = false;
+
+    // the range only moves along with the series so the axis and the data stay in step
+    if (m_size > 0) {
+        m_last_x = xAt(m_size - 1);
+        m_first_x = m_span > 0 ? qMax(xAt(0), m_last_x - m_span) : xAt(0);
+        emit range_changed();
+    }
+
+#if defined(ENABLE_CHARTS)
+    for (auto &entry : m_series) {
+        if (entry.first.isNull() || !entry.first->isVisible()) {
+            continue;
+        }
+        decimate(entry.second, m_first_x, m_last_x, m_pixels, m_points);
+        entry.first->replace(m_points);
+    }
+#endif
+}
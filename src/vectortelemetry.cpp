@@ -43,16 +43,10 @@
 #include "constants.h"
 
 #include "openhd.h"
-
-#define VOTFrameLength 97 // 97 bytes
-#define VOT_REVISION 0
-#define VOT_SC1  0xB0
-#define VOT_SC2  0x1E
-#define VOT_SC3  0xDE
-#define VOT_SC4  0xAD
-#define VOT_CRC_Init 0xFFFF
+#include "ingestreactor.h"
 
 
+// the frame layout, for reference. It's big endian so it's read field by field rather than copied over this.
 typedef struct {
     uint32_t StartCode;            //  0xB01EDEAD
     uint32_t TimestampMS;          // -not used- timestamp in milliseconds
@@ -90,116 +84,117 @@ typedef struct {
 } VOT_td_t; //97 bytes
 
 
-VectorTelemetry::VectorTelemetry(QObject *parent): QObject(parent) {
+VectorTelemetry::VectorTelemetry(quint16 port, QObject *parent): QObject(parent), m_framer(VectorFrameProtocol), m_port(port) {
     qDebug() << "VectorTelemetry::VectorTelemetry()";
 
-    vectorSocket = new QUdpSocket(this);
-    // port defined in global_functions.sh on ground
-    vectorSocket->bind(QHostAddress::Any, 5011);
-    connect(vectorSocket, &QUdpSocket::readyRead, this, &VectorTelemetry::processVectorDatagrams);
+    OpenHD::instance()->registerTelemetryPublisher(&m_telemetry);
+    IngestReactor::instance()->addPort(m_port, this);
 }
 
 
-void VectorTelemetry::processVectorDatagrams() {
-    QByteArray datagram;
+VectorTelemetry::~VectorTelemetry() {
+    IngestReactor::instance()->removePort(m_port);
+    OpenHD::instance()->unregisterTelemetryPublisher(&m_telemetry);
+}
+
 
-    while (vectorSocket->hasPendingDatagrams()) {
-        datagram.resize(int(vectorSocket->pendingDatagramSize()));
-        vectorSocket->readDatagram(datagram.data(), datagram.size());
-        vot_read((uint8_t*)datagram.data(), datagram.length());
+// called on the ingest thread
+void VectorTelemetry::ingestDatagram(const uint8_t* data, int size) {
+    for (int i = 0; i < size; i++) {
+        if (m_framer.push(data[i])) {
+            processVectorMessage(m_framer.payload());
+        }
     }
 }
 
 
-void VectorTelemetry::processVectorMessage() {
-    uint16_t dummy16;
-    uint32_t dummy32;
+void VectorTelemetry::ingestFinished() {
+    m_telemetry.publish();
+}
 
-    VOTReadIndex = 0;
 
-    dummy32 = (uint32_t)votread_u32(); // StartCode
-    dummy32 = (uint32_t)votread_u32(); // TimeStamp
-    auto rel_altitude = (float)(signed long) votbread_u32() / 100.0f; // BaroAltitudecm
+void VectorTelemetry::processVectorMessage(FrameReader payload) {
+    // the payload starts after the StartCode
+    payload.skip(4); // TimeStamp
+    auto rel_altitude = (float)payload.i32_be() / 100.0f; // BaroAltitudecm
 
-    OpenHD::instance()->set_alt_rel(rel_altitude);
+    m_telemetry.set_alt_rel(rel_altitude);
 
-    auto airspeed  = (float)(uint16_t)votbread_u16() / 10.0f; // airspeed
-    OpenHD::instance()->set_airspeed(airspeed);
+    auto airspeed  = (float)(uint16_t)payload.u16_be() / 10.0f; // airspeed
+    m_telemetry.set_airspeed(airspeed);
 
-    auto vario = (float)(uint16_t)votbread_u16() / 100.0f; // ClimbRateMSX100 -not used- meters/second * 100
-    auto rpm = (uint16_t)votbread_u16(); // RPM - requires optional RPM sensor
+    auto vario = (float)(uint16_t)payload.u16_be() / 100.0f; // ClimbRateMSX100 -not used- meters/second * 100
+    auto rpm = (uint16_t)payload.u16_be(); // RPM - requires optional RPM sensor
 
-    auto pitch = (int16_t)votbread_u16(); // PitchDegrees-pitch-
-    OpenHD::instance()->set_pitch(pitch);
+    auto pitch = (int16_t)payload.u16_be(); // PitchDegrees-pitch-
+    m_telemetry.set_pitch(pitch);
 
-    auto roll = (int16_t)votbread_u16(); // RollDegrees-roll-
-    OpenHD::instance()->set_roll(roll);
+    auto roll = (int16_t)payload.u16_be(); // RollDegrees-roll-
+    m_telemetry.set_roll(roll);
 
-    auto heading = (float)(int16_t)votbread_u16(); // YawDegrees-heading-
-    OpenHD::instance()->set_hdg(heading);
+    auto heading = (float)(int16_t)payload.u16_be(); // YawDegrees-heading-
+    m_telemetry.set_hdg(heading);
 
-    auto x  = (int16_t)votbread_u16(); // AccelXCentiGrav-not used-
-    auto y  = (int16_t)votbread_u16(); // AccelZCentiGrav -not used-
-    auto z  = (int16_t)votbread_u16(); // AccelXCentiGrav-not used-
-    OpenHD::instance()->set_vx(x);
-    OpenHD::instance()->set_vy(y);
-    OpenHD::instance()->set_vz(z);
+    auto x  = (int16_t)payload.u16_be(); // AccelXCentiGrav-not used-
+    auto y  = (int16_t)payload.u16_be(); // AccelZCentiGrav -not used-
+    auto z  = (int16_t)payload.u16_be(); // AccelXCentiGrav-not used-
+    m_telemetry.set_vx(x);
+    m_telemetry.set_vy(y);
+    m_telemetry.set_vz(z);
 
-    auto battery_voltage = (float)(uint16_t)votbread_u16() / 100.0f; // PackVoltageX100 -voltage-
-    auto vtxvoltage      = (float)(uint16_t)votbread_u16() / 100.0f; // VideoTxVoltageX100-vtxvoltage-
-    auto camvoltage      = (float)(uint16_t)votbread_u16() / 100.0f; // CameraVoltageX100-camvoltage-
-    auto rxvoltage       = (float)(uint16_t)votbread_u16() / 100.0f; // RxVoltageX100-rxvoltage-
-    auto ampere          = (float)(uint16_t)votbread_u16() / 10.0f;  // PackCurrentX10-ampere-
-    OpenHD::instance()->set_battery_voltage(battery_voltage);
-    OpenHD::instance()->set_battery_current(ampere);
+    auto battery_voltage = (float)(uint16_t)payload.u16_be() / 100.0f; // PackVoltageX100 -voltage-
+    auto vtxvoltage      = (float)(uint16_t)payload.u16_be() / 100.0f; // VideoTxVoltageX100-vtxvoltage-
+    auto camvoltage      = (float)(uint16_t)payload.u16_be() / 100.0f; // CameraVoltageX100-camvoltage-
+    auto rxvoltage       = (float)(uint16_t)payload.u16_be() / 100.0f; // RxVoltageX100-rxvoltage-
+    auto ampere          = (float)(uint16_t)payload.u16_be() / 10.0f;  // PackCurrentX10-ampere-
+    m_telemetry.set_battery_voltage(battery_voltage);
+    m_telemetry.set_battery_current(ampere);
 
 
     QSettings settings;
     auto battery_cells = settings.value("battery_cells", QVariant(3)).toInt();
     int battery_percent = lipo_battery_voltage_to_percent(battery_cells, battery_voltage);
-    OpenHD::instance()->set_battery_percent(battery_percent);
-    QString battery_gauge_glyph = battery_gauge_glyph_from_percentage(battery_percent);
-    OpenHD::instance()->set_battery_gauge(battery_gauge_glyph);
+    m_telemetry.set_battery_percent(battery_percent);
 
+    // the battery gauge glyph and app mAh are derived from these on the GUI thread
+    m_telemetry.battery_updated();
 
-    dummy16 = (uint16_t)votbread_u16(); // TempDegreesCX10-- degrees C * 10, from optional temperature sensor
-    dummy16 = (uint16_t)votbread_u16(); // mAHConsumed-not used-
-    dummy16 = (uint16_t)votbread_u16(); // CompassDegrees-not used- either magnetic compass reading (if compass enabled) or filtered GPS course over ground if not
-    auto rssi = (uint8_t)votread_u8();  // RSSIPercent-rssi-
-    auto lq   = (uint8_t)votread_u8();  // LQPercent-not used-
+    payload.skip(2); // TempDegreesCX10-- degrees C * 10, from optional temperature sensor
+    payload.skip(2); // mAHConsumed-not used-
+    payload.skip(2); // CompassDegrees-not used- either magnetic compass reading (if compass enabled) or filtered GPS course over ground if not
+    auto rssi = (uint8_t)payload.u8();  // RSSIPercent-rssi-
+    auto lq   = (uint8_t)payload.u8();  // LQPercent-not used-
 
-    auto latitude = (double)(int32_t)votbread_u32() / 10000000; // -latitude- (degrees * 10,000,000 )
-    OpenHD::instance()->set_lat(latitude);
+    auto latitude = (double)(int32_t)payload.u32_be() / 10000000; // -latitude- (degrees * 10,000,000 )
+    m_telemetry.set_lat(latitude);
 
-    auto longitude = (double)(int32_t)votbread_u32() / 10000000; // -longitude- (degrees * 10,000,000 )
-    OpenHD::instance()->set_lon(longitude);
+    auto longitude = (double)(int32_t)payload.u32_be() / 10000000; // -longitude- (degrees * 10,000,000 )
+    m_telemetry.set_lon(longitude);
 
 
     // qopenhd doesn't use these because we calculate home when the drone is armed based on current location
-    auto distance = (float)(uint32_t)votbread_u32() / 10.0f; // DistanceFromHomeMX10 horizontal GPS distance from home point, in meters X 10 (decimeters)
+    auto distance = (float)(uint32_t)payload.u32_be() / 10.0f; // DistanceFromHomeMX10 horizontal GPS distance from home point, in meters X 10 (decimeters)
 
-    auto speed = (float)(uint16_t)votbread_u16() / 10.0f; // -speed- ( km/h * 10 )
-    OpenHD::instance()->set_speed(speed);
+    auto speed = (float)(uint16_t)payload.u16_be() / 10.0f; // -speed- ( km/h * 10 )
+    m_telemetry.set_speed(speed);
 
-    auto coursedegrees = (uint16_t)votbread_u16(); // CourseDegrees -not used- GPS course over ground, in degrees
-    auto gps_altitude = (float)(int32_t)votbread_u32() / 100.0f; // -altitude- ( GPS altitude, using WGS-84 ellipsoid, cm)
-    OpenHD::instance()->set_alt_msl(gps_altitude);
+    auto coursedegrees = (uint16_t)payload.u16_be(); // CourseDegrees -not used- GPS course over ground, in degrees
+    auto gps_altitude = (float)(int32_t)payload.u32_be() / 100.0f; // -altitude- ( GPS altitude, using WGS-84 ellipsoid, cm)
+    m_telemetry.set_alt_msl(gps_altitude);
 
 
-    auto hdop = (float)(uint8_t)votread_u8(); // -HDOPx10- GPS HDOP * 10
-    auto sats = (uint8_t)votread_u8(); // -SatsInUse- satellites used for navigation
-    OpenHD::instance()->set_gps_hdop(hdop);
-    OpenHD::instance()->set_satellites_visible(sats);
+    auto hdop = (float)(uint8_t)payload.u8(); // -HDOPx10- GPS HDOP * 10
+    auto sats = (uint8_t)payload.u8(); // -SatsInUse- satellites used for navigation
+    m_telemetry.set_gps_hdop(hdop);
+    m_telemetry.set_satellites_visible(sats);
 
 
-    auto _flightmode = (uint8_t)votread_u8(); // PresentFlightMode -uav_flightmode- present flight mode, as defined in VECTOR_FLIGHT_MODES
+    auto _flightmode = (uint8_t)payload.u8(); // PresentFlightMode -uav_flightmode- present flight mode, as defined in VECTOR_FLIGHT_MODES
     QString flightmode = vot_mode_from_telemetry(_flightmode);
-    OpenHD::instance()->set_flight_mode(flightmode);
+    m_telemetry.set_flight_mode(flightmode.toUtf8().constData());
 
-    OpenHD::instance()->calculate_home_distance();
-    OpenHD::instance()->calculate_home_course();
-
-    VOTReadIndex = 0;
+    // home distance and course are recalculated on the GUI thread when this is published
+    m_telemetry.position_updated();
 }
 
 
@@ -208,123 +203,3 @@ void VectorTelemetry::set_last_heartbeat(QString last_heartbeat) {
     emit last_heartbeat_changed(m_last_heartbeat);
 }
 
-
-
-static union {
-   uint8_t SerialBuffer[sizeof(VOT_td_t)];
-   VOT_td_t td;  //unfortunately, this doesn't work because of the damn Endians..
-} v;
-
-
-uint8_t VectorTelemetry::votread_u8()  {
-    return v.SerialBuffer[VOTReadIndex++];
-}
-
-
-uint16_t VectorTelemetry::votread_u16() {
-    uint16_t t = votread_u8();
-    t |= (uint16_t)votread_u8()<<8;
-    return t;
-}
-
-
-uint16_t VectorTelemetry::votbread_u16() {
-    uint16_t t = votread_u8()<<8;
-    t |= votread_u8();
-    return t;
-}
-
-
-uint32_t VectorTelemetry::votread_u32() {
-    uint32_t t = votread_u16();
-    t |= (uint32_t)votread_u16()<<16;
-    return t;
-}
-
-uint32_t VectorTelemetry::votbread_u32() {
-    uint32_t t = votbread_u16()<<16;
-    t |= votbread_u16();
-    return t;
-}
-
-
-// sample code for calculating the CRC
-// OpenTelem.CRC == CalculateCRC((UINT8 *)&OpenTelem, offsetof(VECTOR_OPEN_TELEMETRY, CRC), VTELEM_CRC_INIT);
-
-uint16_t VectorTelemetry::CRC16Worker(uint16_t icrc, uint8_t r0) {
-    union {
-        uint16_t crc16; // 16-bit CRC
-        struct {
-            uint8_t crcl, crch;
-        } s;
-    } u;
-
-    uint8_t a1; // scratch byte
-    u.crc16 = icrc;
-    r0 = r0 ^ u.s.crch;
-    a1 = u.s.crcl;
-    u.s.crch = r0;
-    u.s.crch = (u.s.crch << 4) | (u.s.crch >> 4);
-    u.s.crcl = u.s.crch ^ r0;
-    u.crc16 &= 0x0ff0;
-    r0 ^= u.s.crch;
-    a1 ^= u.s.crcl;
-    u.crc16 <<= 1;
-    u.s.crcl ^= r0;
-    u.s.crch ^= a1;
-    return (u.crc16);
-}
-
-
-uint16_t VectorTelemetry::CalculateCRC(uint8_t * pPacket, uint8_t Size, uint16_t InitCRC) {
-    uint16_t i;
-    uint16_t CRC;
-    CRC = InitCRC;
-    for (i = 0; i < Size; i++) {
-        CRC = CRC16Worker(CRC, pPacket[i]);
-    }
-    return CRC;
-}
-
-
-void VectorTelemetry::vot_read(uint8_t *buf, uint8_t buflen) {
-    int i;
-    uint8_t c;
-    uint16_t cs;
-
-    for (i = 0; i < buflen; ++i) {
-        uint8_t c = buf[i];
-
-        if (c_state == IDLE) {
-            c_state = (c == VOT_SC1) ? HEADER_START1 : IDLE;
-            VOTReceiverIndex=0;
-        } else if (c_state == HEADER_START1) {
-            c_state = (c == VOT_SC2) ? HEADER_START2 : IDLE;
-        } else if (c_state == HEADER_START2) {
-            c_state = (c == VOT_SC3) ? HEADER_START3 : IDLE;
-        } else if (c_state == HEADER_START3) {
-            c_state = (c == VOT_SC4) ? HEADER_START4 : IDLE;
-        } else if (c_state == HEADER_START4) {
-            c_state = HEADER_MSGTYPE;
-        }
-
-        if (c_state != IDLE) {
-            v.SerialBuffer[VOTReceiverIndex++] = c;
-            if (VOTReceiverIndex == VOTFrameLength) {
-                // received checksum word little endian
-                VOTRcvChecksum = CalculateCRC((uint8_t *)&v.SerialBuffer[0], 95, 0xFFFF);
-                cs = (uint16_t)(v.SerialBuffer[VOTFrameLength-1] << 8) + v.SerialBuffer[VOTFrameLength-2];
-                if (VOTRcvChecksum == cs) {
-                    processVectorMessage();
-                    c_state = IDLE;
-                } else  {
-                    // wrong checksum, drop packet
-                    c_state = IDLE;
-                }
-            } else {
-
-            }
-        }
-    } //next i
-    return;
-}
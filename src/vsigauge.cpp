@@ -0,0 +1,149 @@
+#include "vsigauge.h"
+
+#include <QMatrix4x4>
+#include <QSGTransformNode>
+#include <QtMath>
+
+
+static const double SweepDegrees = 135;
+static const int ArcSegments = 64;
+static const double TickStep = 10;
+
+
+static QPointF polar(QPointF center, qreal radius, double degrees) {
+    auto radians = qDegreesToRadians(degrees);
+    return QPointF(center.x() + radius * qSin(radians), center.y() - radius * qCos(radians));
+}
+
+
+VsiGauge::VsiGauge(QQuickItem *parent): OSDInstrument(parent) {}
+
+
+void VsiGauge::set_value(double value) {
+    if (m_value == value) {
+        return;
+    }
+    m_value = value;
+    emit value_changed(m_value);
+    update();
+}
+
+
+void VsiGauge::set_maximum(double maximum) {
+    m_maximum = maximum;
+    emit maximum_changed(m_maximum);
+    update();
+}
+
+
+void VsiGauge::set_text_color(QColor text_color) {
+    m_text_color = text_color;
+    emit text_color_changed(m_text_color);
+    update();
+}
+
+
+double VsiGauge::valueAngle(double value) const {
+    if (m_maximum <= 0) {
+        return -90;
+    }
+    value = qBound(-m_maximum, value, m_maximum);
+    return SweepDegrees * value / m_maximum - 90;
+}
+
+
+QSGNode* VsiGauge::updatePaintNode(QSGNode* old, UpdatePaintNodeData* data) {
+    Q_UNUSED(data)
+
+    auto node = static_cast<VsiGaugeNode*>(old);
+    bool rebuild = node == nullptr;
+    if (node == nullptr) {
+        node = new VsiGaugeNode();
+        initInstrumentNode(node);
+
+        node->needle_transform = new QSGTransformNode();
+        node->needle = createShapeNode(m_text_color);
+        node->needle_transform->appendChildNode(node->needle);
+        node->appendChildNode(node->needle_transform);
+    }
+
+    QPointF center(width() / 2, height() / 2);
+    qreal radius = qMin(width(), height()) / 2;
+
+    if (rebuild || m_dial_size != size() || m_dial_maximum != m_maximum || m_dial_color != m_color || m_dial_text_color != m_text_color) {
+        buildDial(node, center, radius);
+
+        m_dial_size = size();
+        m_dial_maximum = m_maximum;
+        m_dial_color = m_color;
+        m_dial_text_color = m_text_color;
+    }
+
+    QMatrix4x4 matrix;
+    matrix.translate(center.x(), center.y());
+    matrix.rotate(valueAngle(m_value), 0, 0, 1);
+    node->needle_transform->setMatrix(matrix);
+
+    return node;
+}
+
+
+void VsiGauge::buildDial(VsiGaugeNode* node, QPointF center, qreal radius) {
+    setShapeColor(node->shapes, m_color);
+    setShapeColor(node->needle, m_text_color);
+
+    m_vertices.clear();
+    beginLabels(node);
+
+    if (radius > 0 && m_maximum > 0) {
+        auto line_width = radius * 0.02;
+        auto start = valueAngle(-m_maximum);
+        auto end = valueAngle(m_maximum);
+
+        for (int i = 0; i < ArcSegments; i++) {
+            auto a = start + (end - start) * i / ArcSegments;
+            auto b = start + (end - start) * (i + 1) / ArcSegments;
+            appendQuad(m_vertices,
+                       polar(center, radius - line_width, a), polar(center, radius, a),
+                       polar(center, radius, b), polar(center, radius - line_width, b));
+        }
+
+        // tick marks reach in from the outer edge, none at zero
+        auto tick_half_width = radius * 0.025;
+        auto tick_length = radius * 0.09;
+        for (double value = -m_maximum; value <= m_maximum + 1e-9; value += TickStep) {
+            if (qAbs(value) < 1e-9) {
+                continue;
+            }
+            auto angle = valueAngle(value);
+            auto inner = polar(center, radius - tick_length, angle);
+            auto outer = polar(center, radius, angle);
+            auto side = polar(QPointF(0, 0), tick_half_width, angle + 90);
+            appendQuad(m_vertices, inner - side, outer - side, outer + side, inner + side);
+        }
+
+        // labels sit outside the arc
+        QFont font;
+        font.setPixelSize(9);
+        auto label_step = m_maximum / 5;
+        for (int i = 0; i <= 10; i++) {
+            auto value = -m_maximum + label_step * i;
+            if (qAbs(value) < 1e-9) {
+                value = 0;
+            }
+            auto position = polar(center, radius * 1.3, valueAngle(value));
+            addLabel(node, QString::number(value), font, m_text_color, position.x(), position.y(), Qt::AlignHCenter | Qt::AlignVCenter);
+        }
+    }
+
+    commitShapes(node->shapes, m_vertices);
+    endLabels(node);
+
+    // the needle points up in its own coordinates, the transform turns it to the value
+    m_vertices.clear();
+    if (radius > 0) {
+        auto needle_half_width = radius * 0.025;
+        appendRect(m_vertices, -needle_half_width, -radius, needle_half_width * 2, radius * 0.99);
+    }
+    commitShapes(node->needle, m_vertices);
+}
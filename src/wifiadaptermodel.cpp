@@ -0,0 +1,206 @@
+#include "wifiadaptermodel.h"
+
+
+// how far back the per adapter packet rate looks
+static const qint64 RateWindow = 1000;
+
+
+static WifiAdapterModel* _instance = nullptr;
+
+WifiAdapterModel* WifiAdapterModel::instance() {
+    if (_instance == nullptr) {
+        _instance = new WifiAdapterModel();
+    }
+    return _instance;
+}
+
+
+WifiAdapterModel::WifiAdapterModel(QObject *parent): QAbstractListModel(parent) {
+    qDebug() << "WifiAdapterModel::WifiAdapterModel()";
+    m_clock.start();
+}
+
+
+void WifiAdapterModel::updateAdapters(const QVector<WifiAdapterStatus> &adapters) {
+    auto now = m_clock.elapsed();
+    int previous_count = m_adapters.size();
+
+    if (adapters.size() < previous_count) {
+        beginRemoveRows(QModelIndex(), adapters.size(), previous_count - 1);
+        m_adapters.resize(adapters.size());
+        endRemoveRows();
+    }
+
+    int existing = m_adapters.size();
+
+    for (int row = 0; row < existing; row++) {
+        auto &adapter = m_adapters[row];
+        auto &status = adapters[row];
+
+        QVector<int> roles;
+        if (adapter.status.received_packet_cnt != status.received_packet_cnt) {
+            roles.append(ReceivedPacketCountRole);
+        }
+        if (adapter.status.current_signal_dbm != status.current_signal_dbm) {
+            roles.append(SignalRole);
+        }
+        if (adapter.status.signal_good != status.signal_good) {
+            roles.append(SignalGoodRole);
+        }
+        if (adapter.status.type != status.type) {
+            roles.append(TypeRole);
+        }
+        adapter.status = status;
+
+        auto packet_rate = updatePacketRate(adapter, now);
+        if (adapter.packet_rate != packet_rate) {
+            adapter.packet_rate = packet_rate;
+            roles.append(PacketRateRole);
+        }
+
+        if (!roles.isEmpty()) {
+            emit dataChanged(index(row), index(row), roles);
+        }
+    }
+
+    if (adapters.size() > existing) {
+        beginInsertRows(QModelIndex(), existing, adapters.size() - 1);
+        for (int row = existing; row < adapters.size(); row++) {
+            WifiAdapter adapter;
+            adapter.status = adapters[row];
+            adapter.packet_rate = updatePacketRate(adapter, now);
+            m_adapters.append(adapter);
+        }
+        endInsertRows();
+    }
+
+    if (m_adapters.size() != previous_count) {
+        emit count_changed(m_adapters.size());
+    }
+
+    set_best_adapter(findBestAdapter());
+}
+
+
+/*
+ * Returns the packet rate from the samples collected over the last RateWindow, the caller
+ * compares it to the current value before storing it so it can tell whether it changed
+ */
+int WifiAdapterModel::updatePacketRate(WifiAdapter &adapter, qint64 now) {
+    auto &samples = adapter.samples;
+
+    // the counter went backwards, the ground station restarted
+    if (!samples.isEmpty() && adapter.status.received_packet_cnt < samples.last().second) {
+        samples.clear();
+    }
+
+    samples.append(qMakePair(now, adapter.status.received_packet_cnt));
+
+    while (samples.size() > 2 && now - samples.at(1).first >= RateWindow) {
+        samples.removeFirst();
+    }
+
+    int rate = 0;
+    auto elapsed = now - samples.first().first;
+    if (elapsed > 0) {
+        rate = int((samples.last().second - samples.first().second) * 1000 / elapsed);
+    }
+
+    return rate;
+}
+
+
+/*
+ * The best adapter is the one with the strongest signal among the ones that are actually
+ * receiving packets. A card can keep reporting its last signal level for a while after it
+ * stopped receiving anything, so the signal level alone isn't enough.
+ */
+int WifiAdapterModel::findBestAdapter() {
+    int best = -1;
+    bool best_receiving = false;
+
+    for (int row = 0; row < m_adapters.size(); row++) {
+        auto &adapter = m_adapters[row];
+        bool receiving = adapter.packet_rate > 0;
+
+        if (best == -1 ||
+            (receiving && !best_receiving) ||
+            (receiving == best_receiving && adapter.status.current_signal_dbm > m_adapters[best].status.current_signal_dbm)) {
+            best = row;
+            best_receiving = receiving;
+        }
+    }
+
+    return best;
+}
+
+
+void WifiAdapterModel::set_best_adapter(int best_adapter) {
+    if (m_best_adapter == best_adapter) {
+        return;
+    }
+
+    auto previous = m_best_adapter;
+    m_best_adapter = best_adapter;
+
+    if (previous >= 0 && previous < m_adapters.size()) {
+        emit dataChanged(index(previous), index(previous), { BestRole });
+    }
+    if (m_best_adapter >= 0) {
+        emit dataChanged(index(m_best_adapter), index(m_best_adapter), { BestRole });
+    }
+
+    emit best_adapter_changed(m_best_adapter);
+}
+
+
+int WifiAdapterModel::rowCount(const QModelIndex &parent) const {
+    Q_UNUSED(parent)
+    return m_adapters.count();
+}
+
+
+QHash<int, QByteArray> WifiAdapterModel::roleNames() const {
+    QHash<int, QByteArray> roles;
+
+    roles[ReceivedPacketCountRole] = "received_packet_cnt";
+    roles[SignalRole] = "current_signal_dbm";
+    roles[SignalGoodRole] = "signal_good";
+    roles[TypeRole] = "type";
+    roles[PacketRateRole] = "packet_rate";
+    roles[BestRole] = "best";
+
+    return roles;
+}
+
+
+QVariant WifiAdapterModel::data(const QModelIndex &index, int role) const {
+    if (index.row() < 0 || index.row() >= m_adapters.size()) {
+        return QVariant();
+    }
+
+    auto &adapter = m_adapters[index.row()];
+
+    switch (role) {
+        case ReceivedPacketCountRole: {
+            return QVariant::fromValue(adapter.status.received_packet_cnt);
+        }
+        case SignalRole: {
+            return QVariant::fromValue(int(adapter.status.current_signal_dbm));
+        }
+        case SignalGoodRole: {
+            return QVariant::fromValue(adapter.status.signal_good != 0);
+        }
+        case TypeRole: {
+            return QVariant::fromValue(int(adapter.status.type));
+        }
+        case PacketRateRole: {
+            return QVariant::fromValue(adapter.packet_rate);
+        }
+        case BestRole: {
+            return QVariant::fromValue(index.row() == m_best_adapter);
+        }
+    }
+
+    return QVariant();
+}
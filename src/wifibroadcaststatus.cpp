@@ -0,0 +1,77 @@
+#include "wifibroadcaststatus.h"
+
+#include <string.h>
+
+
+// the wire format is little endian, same as every platform we run on
+template <typename T> static T read_field(const char* data, int &offset) {
+    T value;
+    memcpy(&value, data + offset, sizeof(T));
+    offset += sizeof(T);
+    return value;
+}
+
+
+bool WifibroadcastStatus::decode(const char* data, int size) {
+    if (data == nullptr || size < HeaderSize) {
+        return false;
+    }
+
+    int offset = 0;
+    damaged_block_cnt = read_field<uint32_t>(data, offset);
+    lost_packet_cnt = read_field<uint32_t>(data, offset);
+    skipped_packet_cnt = read_field<uint32_t>(data, offset);
+    injection_fail_cnt = read_field<uint32_t>(data, offset);
+    received_packet_cnt = read_field<uint32_t>(data, offset);
+    kbitrate = read_field<uint32_t>(data, offset);
+    kbitrate_measured = read_field<uint32_t>(data, offset);
+    kbitrate_set = read_field<uint32_t>(data, offset);
+    lost_packet_cnt_telemetry_up = read_field<uint32_t>(data, offset);
+    lost_packet_cnt_telemetry_down = read_field<uint32_t>(data, offset);
+    lost_packet_cnt_msp_up = read_field<uint32_t>(data, offset);
+    lost_packet_cnt_msp_down = read_field<uint32_t>(data, offset);
+    lost_packet_cnt_rc = read_field<uint32_t>(data, offset);
+    current_signal_joystick_uplink = read_field<int8_t>(data, offset);
+    current_signal_telemetry_uplink = read_field<int8_t>(data, offset);
+    joystick_connected = read_field<int8_t>(data, offset);
+    HomeLat = read_field<float>(data, offset);
+    HomeLon = read_field<float>(data, offset);
+    cpuload_gnd = read_field<uint8_t>(data, offset);
+    temp_gnd = read_field<uint8_t>(data, offset);
+    cpuload_air = read_field<uint8_t>(data, offset);
+    temp_air = read_field<uint8_t>(data, offset);
+    auto wifi_adapter_cnt = read_field<uint32_t>(data, offset);
+
+    int remaining = size - HeaderSize;
+    int stride = AdapterSize;
+
+    /*
+     * There's no version field in the header, so the layout is worked out from the size. The
+     * legacy layout always has room for 6 adapters. Anything else is expected to carry exactly
+     * wifi_adapter_cnt entries, when those split the rest evenly into entries longer than 7
+     * bytes they've grown, even if the new size happens to be a multiple of 7. Only when that
+     * doesn't fit is it read as 7 byte entries.
+     */
+    if (size == LegacySize) {
+        layout = WifibroadcastStatusLayoutLegacy;
+    } else if (wifi_adapter_cnt > 0 && wifi_adapter_cnt <= uint32_t(remaining) && remaining % int(wifi_adapter_cnt) == 0 && remaining / int(wifi_adapter_cnt) > AdapterSize) {
+        layout = WifibroadcastStatusLayoutExtended;
+        stride = remaining / wifi_adapter_cnt;
+    } else {
+        layout = WifibroadcastStatusLayoutVariable;
+    }
+
+    int count = qMin(int(qMin<uint32_t>(wifi_adapter_cnt, 255)), remaining / stride);
+
+    adapters.resize(count);
+    for (int i = 0; i < count; i++) {
+        int adapter_offset = HeaderSize + i * stride;
+        auto &adapter = adapters[i];
+        adapter.received_packet_cnt = read_field<uint32_t>(data, adapter_offset);
+        adapter.current_signal_dbm = read_field<int8_t>(data, adapter_offset);
+        adapter.type = read_field<int8_t>(data, adapter_offset);
+        adapter.signal_good = read_field<int8_t>(data, adapter_offset);
+    }
+
+    return true;
+}